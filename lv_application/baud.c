@@ -0,0 +1,54 @@
+/*
+ * baud.c
+ *
+ * Baud rates of a serial port through termios2 and BOTHER.
+ * It's separate from uart.c because <asm/termbits.h> can't be included together with <termios.h>.
+ * Apply the rate after tcsetattr, which would set the speed of its own termios.
+ */
+
+#include "baud.h"
+
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+
+// ---------------        External Functions        ---------------
+
+int32_t baud_set(int32_t fd, int32_t baud)
+{
+   struct termios2 tio;
+
+   if(baud <= 0 || ioctl(fd, TCGETS2, &tio) < 0)
+   {
+      return -1;
+   }
+
+   // Any rate: BOTHER and the rate in c_ispeed/c_ospeed
+   tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+   tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+   tio.c_ispeed = baud;
+   tio.c_ospeed = baud;
+   if(ioctl(fd, TCSETS2, &tio) < 0)
+   {
+      return -1;
+   }
+
+   // The driver rounds to what its clock divider can do
+   return baud_get(fd);
+}
+
+int32_t baud_get(int32_t fd)
+{
+   struct termios2 tio;
+
+   if(ioctl(fd, TCGETS2, &tio) < 0)
+   {
+      return -1;
+   }
+   return tio.c_ospeed;
+}
+
+bool baud_match(int32_t baud, int32_t actual)
+{
+   int32_t diff = actual > baud ? actual - baud : baud - actual;
+   return actual > 0 && (int64_t)diff * 100 <= (int64_t)baud * BAUD_TOLERANCE_PERCENT;
+}
@@ -0,0 +1,47 @@
+/*
+ * baud.h
+ *
+ * Baud rates of a serial port through termios2 and BOTHER,
+ * so any rate the driver supports can be set, not only the Bxxx constants.
+ */
+
+#ifndef LV_APPLICATION_BAUD_H_
+#define LV_APPLICATION_BAUD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BAUD_TOLERANCE_PERCENT 2    // max. difference of the rate set by the driver
+
+   /**
+    * Set the input and output baud rate of a serial port.
+    * @param fd - file descriptor of the port.
+    * @param baud - rate in bit/s.
+    * @return the rate set by the driver, which can be rounded, or -1 on error.
+    */
+   int32_t baud_set(int32_t fd, int32_t baud);
+
+   /**
+    * Get the output baud rate of a serial port.
+    * @param fd - file descriptor of the port.
+    * @return rate in bit/s, or -1 on error.
+    */
+   int32_t baud_get(int32_t fd);
+
+   /**
+    * Check if the rate set by the driver is close enough to the requested one for a UART link.
+    * @param baud - requested rate.
+    * @param actual - rate returned by baud_set.
+    * @return true if they differ by max. BAUD_TOLERANCE_PERCENT.
+    */
+   bool baud_match(int32_t baud, int32_t actual);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LV_APPLICATION_BAUD_H_ */
@@ -0,0 +1,193 @@
+/*
+ * cmd.c
+ *
+ * Command engine for the lines received on the serial port.
+ * The commands are in an open addressing hash table (FNV-1a hash of the name, linear probing).
+ * The name is hashed while the line is cut into words, so a line is scanned only once
+ * and the command is found with one string compare.
+ */
+
+#include "cmd.h"
+
+#include <string.h>
+
+#define FNV_OFFSET  2166136261UL
+#define FNV_PRIME   16777619UL
+
+typedef struct
+{
+   const char* pName;       // NULL: free slot
+   uint16_t length;
+   uint32_t hash;
+   cmd_handler_t handler;
+} cmd_entry_t;
+
+// ---------------        Internal Functions        ---------------
+
+static uint32_t cmd_hash(const char* pStr, uint32_t length);
+static bool cmd_is_delim(char c);
+
+// ---------------        Internal Variables        ---------------
+
+static cmd_entry_t cmdTable[CMD_TABLE_SIZE];
+
+// ---------------        External Functions        ---------------
+
+bool cmd_register(const char* pName, cmd_handler_t handler)
+{
+   uint32_t length = strlen(pName);
+   uint32_t hash = cmd_hash(pName, length);
+   uint32_t i;
+   for(i = 0; i < CMD_TABLE_SIZE; i++)
+   {
+      cmd_entry_t* pEntry = &cmdTable[(hash + i) & (CMD_TABLE_SIZE - 1)];
+      // Free slot, or the same command registered again
+      if(pEntry->pName == NULL || (pEntry->hash == hash && pEntry->length == length &&
+                                   memcmp(pEntry->pName, pName, length) == 0))
+      {
+         pEntry->pName = pName;
+         pEntry->length = length;
+         pEntry->hash = hash;
+         pEntry->handler = handler;
+         return true;
+      }
+   }
+   return false;
+}
+
+cmd_res_t cmd_dispatch(const char* pLine, int32_t length)
+{
+   const char* p = pLine;
+   const char* pEnd = pLine + length;
+   cmd_token_t name;
+   cmd_args_t args;
+
+   // Cut the words and hash the first one on the way
+   while(p < pEnd && cmd_is_delim(*p))
+   {
+      p++;
+   }
+   if(p == pEnd)
+   {
+      return CMD_EMPTY;
+   }
+   name.pStr = p;
+   uint32_t hash = FNV_OFFSET;
+   while(p < pEnd && !cmd_is_delim(*p))
+   {
+      hash = (hash ^ (uint8_t)*p) * FNV_PRIME;
+      p++;
+   }
+   name.length = p - name.pStr;
+
+   args.count = 0;
+   while(args.count < CMD_MAX_ARGS)
+   {
+      while(p < pEnd && cmd_is_delim(*p))
+      {
+         p++;
+      }
+      if(p == pEnd)
+      {
+         break;
+      }
+      cmd_token_t* pArg = &args.arg[args.count++];
+      pArg->pStr = p;
+      while(p < pEnd && !cmd_is_delim(*p))
+      {
+         p++;
+      }
+      pArg->length = p - pArg->pStr;
+   }
+
+   // Find the command, the probing stops at the first free slot
+   uint32_t i;
+   for(i = 0; i < CMD_TABLE_SIZE; i++)
+   {
+      const cmd_entry_t* pEntry = &cmdTable[(hash + i) & (CMD_TABLE_SIZE - 1)];
+      if(pEntry->pName == NULL)
+      {
+         break;
+      }
+      if(pEntry->hash == hash && pEntry->length == name.length &&
+         memcmp(pEntry->pName, name.pStr, name.length) == 0)
+      {
+         pEntry->handler(&args);
+         return CMD_OK;
+      }
+   }
+   return CMD_UNKNOWN;
+}
+
+bool cmd_arg_int(const cmd_args_t* pArgs, uint8_t index, int32_t* pVal)
+{
+   if(index >= pArgs->count)
+   {
+      return false;
+   }
+   const char* p = pArgs->arg[index].pStr;
+   const char* pEnd = p + pArgs->arg[index].length;
+
+   bool bNeg = false;
+   if(*p == '-' || *p == '+')
+   {
+      bNeg = *p == '-';
+      p++;
+   }
+   if(p == pEnd)
+   {
+      return false;
+   }
+
+   // Accumulate as negative to also reach INT32_MIN
+   int32_t val = 0;
+   for(; p < pEnd; p++)
+   {
+      uint8_t digit = *p - '0';
+      if(digit > 9 || val < (INT32_MIN + digit) / 10)
+      {
+         return false;
+      }
+      val = val * 10 - digit;
+   }
+   if(!bNeg)
+   {
+      if(val == INT32_MIN)
+      {
+         return false;
+      }
+      val = -val;
+   }
+   *pVal = val;
+   return true;
+}
+
+bool cmd_arg_is(const cmd_args_t* pArgs, uint8_t index, const char* pStr)
+{
+   if(index >= pArgs->count)
+   {
+      return false;
+   }
+   uint32_t length = strlen(pStr);
+   return pArgs->arg[index].length == length && memcmp(pArgs->arg[index].pStr, pStr, length) == 0;
+}
+
+// ---------------        Internal Functions        --------------
+
+// FNV-1a hash, the same as calculated in cmd_dispatch.
+static uint32_t cmd_hash(const char* pStr, uint32_t length)
+{
+   uint32_t hash = FNV_OFFSET;
+   uint32_t i;
+   for(i = 0; i < length; i++)
+   {
+      hash = (hash ^ (uint8_t)pStr[i]) * FNV_PRIME;
+   }
+   return hash;
+}
+
+// Characters separating the words
+static bool cmd_is_delim(char c)
+{
+   return c == ' ' || c == ',' || c == '\t' || c == ':';
+}
@@ -0,0 +1,82 @@
+/*
+ * cmd.h
+ *
+ * Command engine for the lines received on the serial port.
+ * A line is a command name and arguments separated by ' ', ',', '\t' or ':'.
+ * The line is parsed in place and the command is found in a hash table.
+ */
+
+#ifndef LV_APPLICATION_CMD_H_
+#define LV_APPLICATION_CMD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMD_MAX_ARGS    8     // Further arguments are ignored
+#define CMD_TABLE_SIZE  32    // Max. number of commands, power of 2
+
+   /**
+    * A word of the line. Points into the line, it's not '\0' terminated.
+    */
+   typedef struct
+   {
+      const char* pStr;
+      uint16_t length;
+   } cmd_token_t;
+
+   /**
+    * The arguments of a command (the words after the command name).
+    */
+   typedef struct
+   {
+      cmd_token_t arg[CMD_MAX_ARGS];
+      uint8_t count;
+   } cmd_args_t;
+
+   typedef void (*cmd_handler_t)(const cmd_args_t* pArgs);
+
+   typedef enum {CMD_OK, CMD_EMPTY, CMD_UNKNOWN} cmd_res_t;
+
+   /**
+    * Register a command. Call it at start up.
+    * @param pName - name of the command (not copied, should be a string literal).
+    * @param handler - called with the arguments when the command is received.
+    * @return true on success, false if the table is full.
+    */
+   bool cmd_register(const char* pName, cmd_handler_t handler);
+
+   /**
+    * Parse a line and call the handler of its command.
+    * @param pLine - the line, not modified and doesn't need to be '\0' terminated.
+    * @param length - length of the line.
+    * @return CMD_OK if a handler was called, CMD_EMPTY if there is no word, CMD_UNKNOWN if the command isn't registered.
+    */
+   cmd_res_t cmd_dispatch(const char* pLine, int32_t length);
+
+   /**
+    * Get an argument as a decimal integer.
+    * @param pArgs - the arguments.
+    * @param index - index of the argument.
+    * @param pVal - the value is stored here.
+    * @return true on success, false if the argument is missing or not a number.
+    */
+   bool cmd_arg_int(const cmd_args_t* pArgs, uint8_t index, int32_t* pVal);
+
+   /**
+    * Compare an argument with a string.
+    * @param pArgs - the arguments.
+    * @param index - index of the argument.
+    * @param pStr - '\0' terminated string.
+    * @return true if they are equal.
+    */
+   bool cmd_arg_is(const cmd_args_t* pArgs, uint8_t index, const char* pStr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LV_APPLICATION_CMD_H_ */
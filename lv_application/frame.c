@@ -0,0 +1,184 @@
+/*
+ * frame.c
+ *
+ * Binary frames of the serial link.
+ * The decoder collects a frame from its SYNC byte and checks it when it's complete.
+ * A frame with a bad length, type or CRC is dropped up to the next SYNC byte in it,
+ * so a SYNC value inside a payload or a lost byte costs only the broken frame.
+ */
+
+#include "frame.h"
+
+#include <string.h>
+
+// ---------------        Internal Functions        ---------------
+
+/**
+ * Check the collected bytes and handle a complete frame.
+ * @param d - decoder.
+ * @return type of the frame handled, or -1 if there is no complete frame yet.
+ */
+static int32_t frame_check(frame_decoder_t* d);
+
+/**
+ * Drop the collected bytes up to the next SYNC.
+ * @param d - decoder.
+ */
+static void frame_resync(frame_decoder_t* d);
+
+
+// ---------------        External Functions        ---------------
+
+uint16_t frame_crc16(uint16_t crc, const uint8_t data[], uint32_t length)
+{
+   uint32_t i;
+   for(i = 0; i < length; i++)
+   {
+      crc ^= (uint16_t)data[i] << 8;
+      uint8_t bit;
+      for(bit = 0; bit < 8; bit++)
+      {
+         crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+   }
+   return crc;
+}
+
+uint32_t frame_encode(uint8_t pOut[], uint8_t type, const uint8_t pPayload[], uint16_t length)
+{
+   if(length > FRAME_MAX_PAYLOAD)
+   {
+      return 0;
+   }
+
+   pOut[0] = FRAME_SYNC;
+   pOut[1] = length & 0xFF;
+   pOut[2] = length >> 8;
+   pOut[3] = type;
+   if(length > 0)
+   {
+      memcpy(&pOut[FRAME_HDR_SIZE], pPayload, length);
+   }
+
+   uint16_t crc = frame_crc16(0xFFFF, &pOut[1], FRAME_HDR_SIZE - 1 + length);
+   pOut[FRAME_HDR_SIZE + length] = crc & 0xFF;
+   pOut[FRAME_HDR_SIZE + length + 1] = crc >> 8;
+   return FRAME_HDR_SIZE + length + FRAME_CRC_SIZE;
+}
+
+void frame_decoder_init(frame_decoder_t* d, frame_handler_t handler, void* pUser)
+{
+   memset(d, 0, sizeof(frame_decoder_t));
+   d->handler = handler;
+   d->pUser = pUser;
+}
+
+void frame_decoder_reset(frame_decoder_t* d)
+{
+   d->rawLen = 0;
+}
+
+uint32_t frame_decode(frame_decoder_t* d, const uint8_t data[], uint32_t length)
+{
+   uint32_t i;
+   for(i = 0; i < length; i++)
+   {
+      if(d->rawLen == 0 && data[i] != FRAME_SYNC)
+      {
+         d->skipped++;
+         continue;
+      }
+      d->raw[d->rawLen++] = data[i];
+
+      // Copy the rest of the payload at once
+      if(d->rawLen >= FRAME_HDR_SIZE)
+      {
+         uint32_t total = FRAME_HDR_SIZE + (d->raw[1] | ((uint32_t)d->raw[2] << 8)) + FRAME_CRC_SIZE;
+         if(total <= FRAME_MAX_SIZE && d->raw[3] < FRAME_TYPE_CNT && d->rawLen < total)
+         {
+            uint32_t n = total - d->rawLen;
+            if(n > length - i - 1)
+            {
+               n = length - i - 1;
+            }
+            memcpy(&d->raw[d->rawLen], &data[i + 1], n);
+            d->rawLen += n;
+            i += n;
+         }
+      }
+
+      int32_t type;
+      while((type = frame_check(d)) >= 0)
+      {
+         if(type == FRAME_TYPE_TEXT_MODE)
+         {
+            d->rawLen = 0;
+            return i + 1;
+         }
+      }
+   }
+   return length;
+}
+
+// ---------------        Internal Functions        --------------
+
+static int32_t frame_check(frame_decoder_t* d)
+{
+   while(d->rawLen >= FRAME_HDR_SIZE)
+   {
+      uint32_t payloadLen = d->raw[1] | ((uint32_t)d->raw[2] << 8);
+      if(payloadLen > FRAME_MAX_PAYLOAD || d->raw[3] >= FRAME_TYPE_CNT)
+      {
+         d->errors++;
+         frame_resync(d);
+         continue;
+      }
+
+      uint32_t total = FRAME_HDR_SIZE + payloadLen + FRAME_CRC_SIZE;
+      if(d->rawLen < total)
+      {
+         return -1;
+      }
+
+      uint16_t crc = frame_crc16(0xFFFF, &d->raw[1], FRAME_HDR_SIZE - 1 + payloadLen);
+      uint16_t rxCrc = d->raw[total - 2] | ((uint16_t)d->raw[total - 1] << 8);
+      if(crc != rxCrc)
+      {
+         d->errors++;
+         frame_resync(d);
+         continue;
+      }
+
+      uint8_t type = d->raw[3];
+      d->frames++;
+      if(d->handler != NULL)
+      {
+         d->handler(type, &d->raw[FRAME_HDR_SIZE], payloadLen, d->pUser);
+      }
+
+      // Bytes after the frame are left only after a resync, keep them from the next SYNC
+      d->rawLen -= total;
+      memmove(d->raw, &d->raw[total], d->rawLen);
+      if(d->rawLen > 0 && d->raw[0] != FRAME_SYNC)
+      {
+         frame_resync(d);
+      }
+      return type;
+   }
+   return -1;
+}
+
+static void frame_resync(frame_decoder_t* d)
+{
+   uint32_t i;
+   for(i = 1; i < d->rawLen; i++)
+   {
+      if(d->raw[i] == FRAME_SYNC)
+      {
+         break;
+      }
+   }
+   d->skipped += i;
+   memmove(d->raw, &d->raw[i], d->rawLen - i);
+   d->rawLen -= i;
+}
@@ -0,0 +1,104 @@
+/*
+ * frame.h
+ *
+ * Binary frames of the serial link:
+ *
+ *    | SYNC | LEN (2) | TYPE | PAYLOAD (LEN bytes) | CRC (2) |
+ *
+ * LEN and CRC are little endian. CRC is the CRC-16/CCITT-FALSE of LEN, TYPE and PAYLOAD.
+ */
+
+#ifndef LV_APPLICATION_FRAME_H_
+#define LV_APPLICATION_FRAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_SYNC           0xA5
+#define FRAME_HDR_SIZE       4        // SYNC, LEN, TYPE
+#define FRAME_CRC_SIZE       2
+#define FRAME_MAX_PAYLOAD    1024
+#define FRAME_MAX_SIZE       (FRAME_HDR_SIZE + FRAME_MAX_PAYLOAD + FRAME_CRC_SIZE)
+
+   /**
+    * Frame types.
+    */
+   enum
+   {
+      FRAME_TYPE_TEXT_MODE = 0x00,    // Switch the link back to text lines, no payload
+      FRAME_TYPE_SAMPLES_I16 = 0x01,  // Channel (1 byte) and int16 samples, little endian
+      FRAME_TYPE_COMMAND = 0x02,      // A text command without line ending
+      FRAME_TYPE_CNT                  // Frames with other types are dropped as bad
+   };
+
+   typedef void (*frame_handler_t)(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser);
+
+   /**
+    * Incremental frame decoder.
+    */
+   typedef struct
+   {
+      uint8_t raw[FRAME_MAX_SIZE];    //>! The frame being received, starting with SYNC.
+      uint32_t rawLen;
+      frame_handler_t handler;
+      void* pUser;
+      uint32_t frames;                //>! Valid frames.
+      uint32_t errors;                //>! Frames with bad length, type or CRC.
+      uint32_t skipped;               //>! Bytes skipped while looking for SYNC.
+   } frame_decoder_t;
+
+   /**
+    * Calculate CRC-16/CCITT-FALSE.
+    * @param crc - 0xFFFF to start, or the CRC of the previous part.
+    * @param data - the bytes.
+    * @param length - number of bytes.
+    * @return the CRC.
+    */
+   uint16_t frame_crc16(uint16_t crc, const uint8_t data[], uint32_t length);
+
+   /**
+    * Build a frame.
+    * @param pOut - buffer of at least FRAME_HDR_SIZE + length + FRAME_CRC_SIZE bytes.
+    * @param type - frame type.
+    * @param pPayload - the payload.
+    * @param length - length of the payload, max. FRAME_MAX_PAYLOAD.
+    * @return size of the frame, or 0 if the payload is too long.
+    */
+   uint32_t frame_encode(uint8_t pOut[], uint8_t type, const uint8_t pPayload[], uint16_t length);
+
+   /**
+    * Initialize a decoder.
+    * @param d - decoder.
+    * @param handler - called with every valid frame.
+    * @param pUser - passed to the handler.
+    */
+   void frame_decoder_init(frame_decoder_t* d, frame_handler_t handler, void* pUser);
+
+   /**
+    * Drop the partially received frame.
+    * @param d - decoder.
+    */
+   void frame_decoder_reset(frame_decoder_t* d);
+
+   /**
+    * Decode received bytes. They can be split anywhere.
+    * On a bad frame the bytes after its SYNC are searched for the next SYNC.
+    * The length and the type are checked as soon as the header is received, so a SYNC value
+    * inside a payload rarely starts a long false frame.
+    * Decoding stops after a FRAME_TYPE_TEXT_MODE frame, the next bytes belong to text lines.
+    * @param d - decoder.
+    * @param data - received bytes.
+    * @param length - number of bytes.
+    * @return number of bytes used.
+    */
+   uint32_t frame_decode(frame_decoder_t* d, const uint8_t data[], uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LV_APPLICATION_FRAME_H_ */
@@ -69,6 +69,7 @@
 #include "uart.h"
 #include "fs_abs.h"
 #include "uart.h"
+#include "cmd.h"
 #include "fontAwesomeExtra.h"
 #if LV_USE_APPLICATION
 
@@ -101,6 +102,12 @@ LV_FONT_DECLARE(fontAwesomeExtra)
 #define DEF_DATABITS       8
 
 #define DEMO_TIMEBASE      1000     // 1000ms per
+#define APP_TASK_PERIOD    10       // ms, the graph gets a new point in every period
+#define APP_SERIAL_BATCH   16       // max. serial messages handled at once, the rest in the next call
+#define APP_FRAME_BATCH    64       // max. binary frames handled at once, the rest in the next call
+#define APP_SAMPLE_CHANNEL 0        // channel of the received samples shown on the graph
+#define APP_STATUS_PERIOD  1000     // ms, the serial throughput in the status bar is updated this often
+#define NUM_BAUD_RATES     (sizeof(baudRates) / sizeof(baudRates[0]))
 #define MAX_Y              150L
 
 /**********************
@@ -115,6 +122,8 @@ static void createControlScreen(int32_t left, int32_t bottom);
 static void createScopeScreen(int32_t left, int32_t bottom);
 static void createSettingScreen(int32_t left, int32_t bottom);
 static void load_tty_list_options(lv_obj_t * ddList);
+static void load_baud_list_options(lv_obj_t * ddList);
+static void updateSerialStatus(void);
 static void btnSidebar_cb(lv_obj_t * btn, lv_event_t event);
 static void btn1_event_cb(lv_obj_t * btn, lv_event_t event);
 static void btn2_event_cb(lv_obj_t * btn, lv_event_t event);
@@ -130,8 +139,13 @@ static void slider_event_cb(lv_obj_t * slider, lv_event_t event);
 static void sldSleep_event_cb(lv_obj_t * slider, lv_event_t event);
 static void LCD_Off(void);
 static void powerLCD(uint32_t power);
-static void parseSerial(char* msg);
+static void serialMsgHandler(const char* pMsg, int32_t length, void* pUser);
+static void serialFrameHandler(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser);
+static void cmdSlider(const cmd_args_t* pArgs);
+static void cmdWake(const cmd_args_t* pArgs);
+static void cmdBinary(const cmd_args_t* pArgs);
 static void updateGraph(void);
+static void app_task(lv_task_t * task);
 
 /**********************
  *  STATIC VARIABLES
@@ -146,6 +160,7 @@ static lv_obj_t * btnSidebar[NUM_SIDEBAR_BUTTONS];
 static lv_obj_t * lblMsg;
 static lv_obj_t * lblStatus;
 static lv_obj_t * ddListPort;
+static lv_obj_t * ddListBaud;
 
 static lv_style_t titleStyle;
 static lv_style_t lblOnBgStyle;
@@ -156,12 +171,15 @@ static lv_obj_t * chart;
 static lv_chart_series_t* dl1;
 
 static uint16_t numChartx;
+static bool bSamplesReceived = false;     // the graph shows the received samples instead of the demo
 
-static char msg[30];
+static char msg[128];              // fits "Cannot open " and the sysfs paths
 static bool bLCDcontrol = true;
 static int16_t LCDlevel;
 static int16_t LCDpower = POWER_ON;
 
+static lv_task_t * appTask;
+
 static serial_t* pSerCtx;
 static bool bSerialActive = false;
 static ser_param_t ttyParams = {DEF_SERIAL_BAUD, DEF_STOPBITS, DEF_PARITY, DEF_DATABITS};
@@ -174,7 +192,12 @@ static int32_t sbWidth;
 
 static const char* sbLabels[NUM_SIDEBAR_BUTTONS] = {APP_HOME_SYMBOL, APP_CHART_SYMBOL, APP_SETTINGS_SYMBOL, NULL, NULL};
 static const char* pBtnMB_OK[] = {"OK", ""};
-static const char ddOptionsBaud[] = "9600\n19200\n38400\n57600\n115200";
+// Baud rates offered in the settings, the list shows the ones the driver accepts
+static const int32_t baudRates[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600,
+                                    1000000, 1500000, 2000000, 3000000};
+// The rates accepted by the driver of the open port, probed when it's opened
+static int32_t portRates[NUM_BAUD_RATES];
+static int32_t portRateCount = -1;
 static const char ddOptionsDatabits[] = "5\n6\n7\n8";
 static const char ddOptionsParity[] = "none\nodd\neven\nspace";
 static const char ddOptionsStopbits[] = "1\n2";
@@ -183,29 +206,41 @@ static const char ddOptionsStopbits[] = "1\n2";
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
-void app_tick(void)
+/**
+ * Do the I/O of the serial port and handle the received messages.
+ * Call it when the file descriptor from `app_get_serial_fd` is readable.
+ */
+void app_serial_event(void)
 {
-   char rxBuff[256];
+   char lastMsg[SERIAL_MSG_MAX];
 
-   if((lv_disp_get_inactive_time(NULL) >=  sleepTimeout) && (LCDpower == POWER_ON))
+   // Read and write the port; it's closed if the device disappeared
+   if((serial_poll(pSerCtx) < 0) && bSerialActive)
    {
-      LCD_Off();
+      bSerialActive = false;
+      lv_label_set_text(lblStatus, "Not connected");
+      lv_obj_realign(lblStatus);
    }
-   // Check for received messages from serial port
-   if(serial_gets(pSerCtx, rxBuff) > 0)
+
+   // Handle the received messages, only the last one is shown
+   if(serial_drain(pSerCtx, serialMsgHandler, lastMsg, APP_SERIAL_BATCH) > 0)
    {
-      lv_label_set_text(lblMsg, rxBuff);
+      lv_label_set_text(lblMsg, lastMsg);
       lv_obj_realign(lblMsg);
-      parseSerial(rxBuff);
 //		lv_obj_invalidate(lblMsg);
    }
 
-   if(dl1 != NULL)
-   {
-      updateGraph();
-   }
-
+   // Handle the received binary frames
+   serial_drain_frames(pSerCtx, serialFrameHandler, NULL, APP_FRAME_BATCH);
+}
 
+/**
+ * Get the file descriptor which is readable when the serial port needs `app_serial_event`
+ * @return the file descriptor to wait for with poll/epoll
+ */
+int32_t app_get_serial_fd(void)
+{
+   return serial_get_event_fd(pSerCtx);
 }
 
 /**
@@ -219,23 +254,30 @@ void lv_application(void)
 
    if((Fbright = fopen(BRIGHTNESS_FILE, "r" )) == NULL)
    {
-      sprintf(msg, "Cannot open %s", BRIGHTNESS_FILE);
+      snprintf(msg, sizeof(msg), "Cannot open %s", BRIGHTNESS_FILE);
       bLCDcontrol = false;
    }
    else if((Fpower = fopen(POWER_FILE, "r")) == NULL)
    {
-      sprintf(msg, "Cannot open %s", POWER_FILE);
+      snprintf(msg, sizeof(msg), "Cannot open %s", POWER_FILE);
       fclose(Fbright);
    }
    else
    {
-      sprintf(msg, "Machine controller");
+      snprintf(msg, sizeof(msg), "Machine controller");
       fscanf(Fbright, "%d", &LCDlevel);
       fclose(Fbright);
       fscanf(Fpower, "%d", &LCDpower);
    }
 
 
+#if LV_FONT_FMT_TXT_LUT
+   // Register the fonts used here to look up their glyphs without searching
+   lv_font_fmt_txt_build_lut(LV_FONT_DEFAULT);
+   lv_font_fmt_txt_build_lut(&lv_font_roboto_28);
+   lv_font_fmt_txt_build_lut(&fontAwesomeExtra);
+#endif
+
    lv_style_copy(&titleStyle, &lv_style_pretty_color);
    titleStyle.text.font = &lv_font_roboto_28;
    titleStyle.body.opa = LV_OPA_50;
@@ -326,13 +368,22 @@ void lv_application(void)
    createSettingScreen(sbWidth, lv_disp_get_ver_res(NULL) - LV_DPI/3);
    lv_obj_set_hidden(contSettings, true);
 
+   // Commands accepted on the serial port
+   cmd_register("slider", cmdSlider);
+   cmd_register("wake", cmdWake);
+   cmd_register(SERIAL_BINARY_CMD, cmdBinary);
+
    // Now attempt to open default serial port
    pSerCtx = serial_create(NULL);
 
    bSerialActive = openSerial(pSerCtx);
 
    const char msgWelcome[] = "Raspberry pi HMI\r\n";
-   serial_send(pSerCtx, msgWelcome, strlen(msg));
+   serial_send(pSerCtx, msgWelcome, strlen(msgWelcome));
+
+   // Screen sleep and graph, paused while the LCD is off
+   appTask = lv_task_create(app_task, APP_TASK_PERIOD, LV_TASK_PRIO_LOW, NULL);
+   lv_task_set_name(appTask, "app");
 
    powerLCD(POWER_ON);
    lv_disp_trig_activity(NULL);
@@ -347,17 +398,24 @@ void lv_application(void)
 static bool openSerial(serial_t* pCtx)
 {
    bool bSuccess = true;
-   char msg[40];
+   char msg[sizeof(ttyName) + 32];   // fits the prefix, the tty name and the rate
    if(serial_connect(pCtx, ttyName, ttyParams.baud) < 0)
    {
-      sprintf(msg, "Cannot open port:\n%s", ttyName);
+      snprintf(msg, sizeof(msg), "Cannot open port:\n%s", ttyName);
       lvh_mbox_create_modal(lv_disp_get_scr_act(NULL), NULL, msg, pBtnMB_OK);
       bSuccess = false;
    }
    if(bSuccess)
    {
-      sprintf(msg, "%s-%d", ttyName, ttyParams.baud);
+      // Probe before anything is received, the probing drops the received bytes
+      portRateCount = serial_probe_bauds(pCtx, baudRates, NUM_BAUD_RATES, portRates);
+      snprintf(msg, sizeof(msg), "%s-%d", ttyName, ttyParams.baud);
       lv_label_set_text(lblStatus, msg);
+      // Offer the rates of this port's driver
+      if(ddListBaud != NULL)
+      {
+         load_baud_list_options(ddListBaud);
+      }
    }
    else
    {
@@ -551,15 +609,13 @@ static void createSettingScreen(int32_t left, int32_t bottom)
    lv_obj_set_style(label1, &lblOnBgStyle);
    lv_label_set_text(label1, "Baud");  // label1 = Baud
 
-   lv_obj_t * ddListBaud = lv_ddlist_create(contSettings, NULL);
+   ddListBaud = lv_ddlist_create(contSettings, NULL);
    lv_obj_align(ddListBaud, ddListPort, LV_ALIGN_IN_LEFT_MID, 0, SETTINGS_ROW_SPACING);
 
-   lv_ddlist_set_options(ddListBaud, ddOptionsBaud);
+   load_baud_list_options(ddListBaud);
    lv_ddlist_set_fix_width(ddListBaud, 150);
    lv_ddlist_set_draw_arrow(ddListBaud, true);
    char buff[20];
-   sprintf(buff, "%d", ttyParams.baud);
-   lvh_ddlist_set_selected_str(ddListBaud, buff);
    lv_obj_set_event_cb(ddListBaud, ddl_baud_event_cb);
 
    // create drop down list for parity
@@ -655,6 +711,32 @@ static void load_tty_list_options(lv_obj_t * ddList)
    }
 }
 
+static void load_baud_list_options(lv_obj_t * ddList)
+{
+   const int32_t* rates = portRates;
+   int32_t count = portRateCount;
+   char options[NUM_BAUD_RATES * 8 + 1];   // max. 7 digits and '\n' per rate
+   char* pOpt = options;
+   int32_t i;
+
+   // The rates the driver accepted when the port was opened, else offer all
+   if(pSerCtx == NULL || !serial_is_open(pSerCtx) || count <= 0)
+   {
+      rates = baudRates;
+      count = NUM_BAUD_RATES;
+   }
+
+   for(i = 0; i < count; i++)
+   {
+      pOpt += sprintf(pOpt, (i == 0) ? "%d" : "\n%d", rates[i]);
+   }
+   lv_ddlist_set_options(ddList, options);
+
+   char buff[20];
+   sprintf(buff, "%d", ttyParams.baud);
+   lvh_ddlist_set_selected_str(ddList, buff);
+}
+
 
 
 static void btnSidebar_cb(lv_obj_t * btn, lv_event_t event)
@@ -714,7 +796,6 @@ static void btn_port_event_cb(lv_obj_t * btn, lv_event_t event)
       // TODO close, then open port with new parameters
       serial_close(pSerCtx);
       bSerialActive = false;
-      usleep(50000);
       bSerialActive = openSerial(pSerCtx);
       if(bSerialActive)
       {
@@ -853,8 +934,11 @@ static void slider_event_cb(lv_obj_t * slider, lv_event_t event)
    {
       FILE *Fbright = fopen(BRIGHTNESS_FILE, "w" );
       LCDlevel = lv_slider_get_value(slider);
-      fprintf(Fbright, "%d", LCDlevel);
-      fclose(Fbright);
+      if(Fbright != NULL)
+      {
+         fprintf(Fbright, "%d", LCDlevel);
+         fclose(Fbright);
+      }
    }
 }
 
@@ -886,39 +970,137 @@ static void LCD_Off(void)
 static void powerLCD(uint32_t power)
 {
    FILE* Fpower = fopen(POWER_FILE, "w");
-   if(power == 1)
-      fprintf(Fpower, "1");
-   else
-      fprintf(Fpower, "0");
-   fclose(Fpower);
+   if(Fpower != NULL)
+   {
+      if(power == 1)
+         fprintf(Fpower, "1");
+      else
+         fprintf(Fpower, "0");
+      fclose(Fpower);
+   }
    LCDpower = power;
+
+   // Nothing to do periodically while the LCD is off, let the main loop sleep
+   if(appTask != NULL)
+   {
+      if(power == POWER_ON)
+         lv_task_resume(appTask);
+      else
+         lv_task_pause(appTask);
+   }
 }
 
-static void parseSerial(char* msg)
+// "slider <value>": set the brightness slider
+static void cmdSlider(const cmd_args_t* pArgs)
 {
-   static char delims[] = " ,\t:";
-   char * pTok;
-
-   pTok = strtok(msg, delims);
+   int32_t val;
 
-   if(!strcmp(pTok, "slider"))
+   if(cmd_arg_int(pArgs, 0, &val) && (val <= lv_slider_get_max_value(sldBrightness)))
    {
-      pTok = strtok(NULL, delims);
+      lv_slider_set_value(sldBrightness, val, LV_ANIM_ON);
+   }
+}
 
-      int32_t val = strtol(pTok, NULL, 10);
+// "wake": switch the LCD on
+static void cmdWake(const cmd_args_t* pArgs)
+{
+   (void)pArgs;
+   lv_obj_del(btnWake);
+   powerLCD(POWER_ON);
+   lv_disp_trig_activity(NULL);
+}
 
-      if(val <= lv_slider_get_max_value(sldBrightness))
+// "binary": the receiver switched to binary frames, acknowledge it
+static void cmdBinary(const cmd_args_t* pArgs)
+{
+   static const uint8_t msgAck[] = "binary ok\r\n";
+   (void)pArgs;
+   serial_send(pSerCtx, msgAck, sizeof(msgAck) - 1);
+}
+
+static void serialMsgHandler(const char* pMsg, int32_t length, void* pUser)
+{
+   // Keep the text for the label, the message is in the serial queue only during this call
+   char* pLast = pUser;
+   memcpy(pLast, pMsg, length);
+   pLast[length] = '\0';
+
+   cmd_dispatch(pMsg, length);
+}
+
+static void serialFrameHandler(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser)
+{
+   (void)pUser;
+
+   switch(type)
+   {
+   case FRAME_TYPE_SAMPLES_I16:
+      // Channel, then the samples; they replace the demo curve
+      if((length >= 1) && (pPayload[0] == APP_SAMPLE_CHANNEL) && (dl1 != NULL))
       {
-         lv_slider_set_value(sldBrightness, val, LV_ANIM_ON);
+         uint16_t i;
+         bSamplesReceived = true;
+         for(i = 1; i + 1 < length; i += 2)
+         {
+            lv_chart_set_next(chart, dl1, (int16_t)(pPayload[i] | (pPayload[i + 1] << 8)));
+         }
       }
+      break;
+
+   case FRAME_TYPE_COMMAND:
+      cmd_dispatch((const char*)pPayload, length);
+      break;
+
+   default:
+      break;
    }
-   else if(!strcmp(pTok, "wake"))
+}
+
+static void app_task(lv_task_t * task)
+{
+   (void)task;
+
+   if((lv_disp_get_inactive_time(NULL) >=  sleepTimeout) && (LCDpower == POWER_ON))
    {
-      lv_obj_del(btnWake);
-      powerLCD(POWER_ON);
-      lv_disp_trig_activity(NULL);
+      LCD_Off();
+      return;
    }
 
+   updateSerialStatus();
+
+   if((dl1 != NULL) && !bSamplesReceived)
+   {
+      updateGraph();
+   }
+}
+
+// Show the achieved throughput and the errors of the serial port in the status bar
+static void updateSerialStatus(void)
+{
+   static uint32_t lastTick = 0;
+   static serial_stats_t lastStats;
+   char status[sizeof(ttyName) + 64];
+
+   uint32_t elapsed = lv_tick_elaps(lastTick);
+   if(elapsed < APP_STATUS_PERIOD)
+   {
+      return;
+   }
+
+   serial_stats_t stats;
+   serial_get_stats(pSerCtx, &stats);
+   if(bSerialActive && (lastTick != 0))
+   {
+      uint32_t rxRate = (uint32_t)(((uint64_t)(stats.rxBytes - lastStats.rxBytes) * 1000) / elapsed);
+      uint32_t txRate = (uint32_t)(((uint64_t)(stats.txBytes - lastStats.txBytes) * 1000) / elapsed);
+      uint32_t errors = stats.lineErrors + stats.overruns + stats.frameErrors + stats.dropped;
+      snprintf(status, sizeof(status), "%s-%d  rx %u B/s  tx %u B/s  err %u", ttyName, serial_get_baud(pSerCtx),
+               rxRate, txRate, errors);
+      lv_label_set_text(lblStatus, status);
+      lv_obj_realign(lblStatus);
+   }
+   lastStats = stats;
+   lastTick = lv_tick_get();
 }
 
 static void updateGraph(void)
@@ -36,6 +36,18 @@ extern "C" {
     **********************/
    void lv_application(void);
 
+   /**
+    * Do the I/O of the serial port and handle the received messages.
+    * Call it when the file descriptor from `app_get_serial_fd` is readable.
+    */
+   void app_serial_event(void);
+
+   /**
+    * Get the file descriptor which is readable when the serial port needs `app_serial_event`
+    * @return the file descriptor to wait for with poll/epoll
+    */
+   int32_t app_get_serial_fd(void);
+
    /**********************
     *      MACROS
     **********************/
@@ -0,0 +1,221 @@
+/*
+ * ringbuf.c
+ *
+ * Single producer / single consumer byte ring, used on one thread now (see ringbuf.h).
+ * The producer publishes the bytes by storing head with release order after copying them,
+ * the consumer frees the space by storing tail with release order after copying them out.
+ */
+
+#include "ringbuf.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Size of the length before a message
+#define MSG_HDR_SIZE 2
+
+// ---------------        Internal Functions        ---------------
+
+static void ringbuf_copy_in(ringbuf_t* r, uint32_t index, const uint8_t data[], uint32_t length);
+static void ringbuf_copy_out(ringbuf_t* r, uint32_t index, uint8_t data[], uint32_t length);
+
+
+// ---------------        External Functions        ---------------
+
+bool ringbuf_init(ringbuf_t* r, uint32_t size)
+{
+   uint32_t pow2 = 1;
+   while(pow2 < size)
+   {
+      pow2 <<= 1;
+   }
+
+   r->pBuf = malloc(pow2);
+   r->size = r->pBuf != NULL ? pow2 : 0;
+   r->head = 0;
+   r->tail = 0;
+   return r->pBuf != NULL;
+}
+
+void ringbuf_deinit(ringbuf_t* r)
+{
+   free(r->pBuf);
+   r->pBuf = NULL;
+   r->size = 0;
+}
+
+uint32_t ringbuf_used(ringbuf_t* r)
+{
+   return __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+}
+
+uint32_t ringbuf_space(ringbuf_t* r)
+{
+   return r->size - ringbuf_used(r);
+}
+
+uint32_t ringbuf_write(ringbuf_t* r, const uint8_t data[], uint32_t length)
+{
+   uint32_t head = r->head;   // only the producer writes it
+   uint32_t space = r->size - (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE));
+   if(length > space)
+   {
+      length = space;
+   }
+
+   ringbuf_copy_in(r, head, data, length);
+   __atomic_store_n(&r->head, head + length, __ATOMIC_RELEASE);
+   return length;
+}
+
+uint32_t ringbuf_read(ringbuf_t* r, uint8_t data[], uint32_t maxLength)
+{
+   uint32_t tail = r->tail;   // only the consumer writes it
+   uint32_t used = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+   if(maxLength > used)
+   {
+      maxLength = used;
+   }
+
+   ringbuf_copy_out(r, tail, data, maxLength);
+   __atomic_store_n(&r->tail, tail + maxLength, __ATOMIC_RELEASE);
+   return maxLength;
+}
+
+uint32_t ringbuf_peek(ringbuf_t* r, const uint8_t** ppData)
+{
+   uint32_t tail = r->tail;
+   uint32_t used = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+   uint32_t pos = tail & (r->size - 1);
+   *ppData = &r->pBuf[pos];
+   return used < r->size - pos ? used : r->size - pos;
+}
+
+void ringbuf_skip(ringbuf_t* r, uint32_t length)
+{
+   __atomic_store_n(&r->tail, r->tail + length, __ATOMIC_RELEASE);
+}
+
+bool ringbuf_write_msg(ringbuf_t* r, const uint8_t data[], uint32_t length)
+{
+   return ringbuf_write_msg2(r, NULL, 0, data, length);
+}
+
+bool ringbuf_write_msg2(ringbuf_t* r, const uint8_t hdr[], uint32_t hdrLength, const uint8_t data[], uint32_t length)
+{
+   uint32_t msgLength = hdrLength + length;
+   if(msgLength > UINT16_MAX)
+   {
+      return false;
+   }
+
+   uint32_t head = r->head;
+   uint32_t space = r->size - (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE));
+   if(MSG_HDR_SIZE + msgLength > space)
+   {
+      return false;
+   }
+
+   // Publish the length and the bytes together
+   uint8_t lenBytes[MSG_HDR_SIZE] = {msgLength & 0xFF, msgLength >> 8};
+   ringbuf_copy_in(r, head, lenBytes, MSG_HDR_SIZE);
+   ringbuf_copy_in(r, head + MSG_HDR_SIZE, hdr, hdrLength);
+   ringbuf_copy_in(r, head + MSG_HDR_SIZE + hdrLength, data, length);
+   __atomic_store_n(&r->head, head + MSG_HDR_SIZE + msgLength, __ATOMIC_RELEASE);
+   return true;
+}
+
+int32_t ringbuf_read_msg(ringbuf_t* r, uint8_t data[], uint32_t maxLength)
+{
+   uint32_t tail = r->tail;
+   uint32_t used = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+   if(used < MSG_HDR_SIZE)
+   {
+      return -1;
+   }
+
+   uint8_t hdr[MSG_HDR_SIZE];
+   ringbuf_copy_out(r, tail, hdr, MSG_HDR_SIZE);
+   uint32_t length = hdr[0] | ((uint32_t)hdr[1] << 8);
+
+   uint32_t copied = length < maxLength ? length : maxLength;
+   ringbuf_copy_out(r, tail + MSG_HDR_SIZE, data, copied);
+   __atomic_store_n(&r->tail, tail + MSG_HDR_SIZE + length, __ATOMIC_RELEASE);
+   return copied;
+}
+
+int32_t ringbuf_peek_msg(ringbuf_t* r, const uint8_t** ppData, uint8_t pScratch[], uint32_t maxLength)
+{
+   uint32_t tail = r->tail;
+   uint32_t used = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+   if(used < MSG_HDR_SIZE)
+   {
+      return -1;
+   }
+
+   uint8_t hdr[MSG_HDR_SIZE];
+   ringbuf_copy_out(r, tail, hdr, MSG_HDR_SIZE);
+   uint32_t length = hdr[0] | ((uint32_t)hdr[1] << 8);
+
+   // Point into the storage if the message doesn't wrap
+   uint32_t pos = (tail + MSG_HDR_SIZE) & (r->size - 1);
+   if(pos + length <= r->size)
+   {
+      *ppData = &r->pBuf[pos];
+      return length;
+   }
+
+   if(length > maxLength)
+   {
+      length = maxLength;
+   }
+   ringbuf_copy_out(r, tail + MSG_HDR_SIZE, pScratch, length);
+   *ppData = pScratch;
+   return length;
+}
+
+void ringbuf_release_msg(ringbuf_t* r)
+{
+   uint32_t tail = r->tail;
+   uint8_t hdr[MSG_HDR_SIZE];
+   ringbuf_copy_out(r, tail, hdr, MSG_HDR_SIZE);
+   uint32_t length = hdr[0] | ((uint32_t)hdr[1] << 8);
+   __atomic_store_n(&r->tail, tail + MSG_HDR_SIZE + length, __ATOMIC_RELEASE);
+}
+
+void ringbuf_clear(ringbuf_t* r)
+{
+   __atomic_store_n(&r->tail, __atomic_load_n(&r->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+// ---------------        Internal Functions        --------------
+
+// Copy into the storage from an index, wrapping at the end.
+static void ringbuf_copy_in(ringbuf_t* r, uint32_t index, const uint8_t data[], uint32_t length)
+{
+   if(length == 0)
+   {
+      return;   // data can be NULL
+   }
+   uint32_t pos = index & (r->size - 1);
+   uint32_t first = r->size - pos;
+   if(first > length)
+   {
+      first = length;
+   }
+   memcpy(&r->pBuf[pos], data, first);
+   memcpy(r->pBuf, &data[first], length - first);
+}
+
+// Copy out of the storage from an index, wrapping at the end.
+static void ringbuf_copy_out(ringbuf_t* r, uint32_t index, uint8_t data[], uint32_t length)
+{
+   uint32_t pos = index & (r->size - 1);
+   uint32_t first = r->size - pos;
+   if(first > length)
+   {
+      first = length;
+   }
+   memcpy(data, &r->pBuf[pos], first);
+   memcpy(&data[first], r->pBuf, length - first);
+}
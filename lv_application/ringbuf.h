@@ -0,0 +1,152 @@
+/*
+ * ringbuf.h
+ *
+ * Single producer / single consumer byte ring.
+ * The serial queues are written and read on the main loop's thread only: serial_poll,
+ * serial_send, serial_drain and serial_drain_frames all run there.
+ * The lock-free SPSC ordering is kept only for a possible reader thread, which wouldn't need a mutex.
+ */
+
+#ifndef LV_APPLICATION_RINGBUF_H_
+#define LV_APPLICATION_RINGBUF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+   /**
+    * @struct Ring buffer.
+    * The indices run freely and wrap at 2^32, the position in the buffer is index & (size - 1).
+    * head is written only by the producer, tail only by the consumer.
+    */
+   typedef struct
+   {
+      uint8_t* pBuf;            //>! Storage, size bytes.
+      uint32_t size;            //>! Size of the storage, power of 2.
+      uint32_t head;            //>! Index of the next byte to write.
+      uint32_t tail;            //>! Index of the next byte to read.
+   } ringbuf_t;
+
+   /**
+    * Allocate the storage of a ring buffer.
+    * @param r - ring buffer.
+    * @param size - size in bytes, rounded up to a power of 2.
+    * @return true on success, false if out of memory.
+    */
+   bool ringbuf_init(ringbuf_t* r, uint32_t size);
+
+   /**
+    * Free the storage of a ring buffer.
+    * @param r - ring buffer.
+    */
+   void ringbuf_deinit(ringbuf_t* r);
+
+   /**
+    * Get the number of bytes which can be read.
+    * @param r - ring buffer.
+    * @return number of bytes.
+    */
+   uint32_t ringbuf_used(ringbuf_t* r);
+
+   /**
+    * Get the number of bytes which can be written.
+    * @param r - ring buffer.
+    * @return number of bytes.
+    */
+   uint32_t ringbuf_space(ringbuf_t* r);
+
+   /**
+    * Write bytes (producer).
+    * @param r - ring buffer.
+    * @param data - bytes to write.
+    * @param length - number of bytes.
+    * @return number of bytes written, less than length if the ring is full.
+    */
+   uint32_t ringbuf_write(ringbuf_t* r, const uint8_t data[], uint32_t length);
+
+   /**
+    * Read bytes (consumer).
+    * @param r - ring buffer.
+    * @param data - buffer to read into.
+    * @param maxLength - size of the buffer.
+    * @return number of bytes read.
+    */
+   uint32_t ringbuf_read(ringbuf_t* r, uint8_t data[], uint32_t maxLength);
+
+   /**
+    * Get the bytes which can be read in place, up to the end of the storage (consumer).
+    * @param r - ring buffer.
+    * @param ppData - set to the first byte.
+    * @return number of contiguous bytes, read the rest after ringbuf_skip.
+    */
+   uint32_t ringbuf_peek(ringbuf_t* r, const uint8_t** ppData);
+
+   /**
+    * Drop bytes which were read in place (consumer).
+    * @param r - ring buffer.
+    * @param length - number of bytes, max. ringbuf_used.
+    */
+   void ringbuf_skip(ringbuf_t* r, uint32_t length);
+
+   /**
+    * Write a message as one record: its length and its bytes (producer).
+    * The reader sees the whole message or nothing.
+    * @param r - ring buffer.
+    * @param data - the message.
+    * @param length - length of the message, max. 65535.
+    * @return true if written, false if it doesn't fit.
+    */
+   bool ringbuf_write_msg(ringbuf_t* r, const uint8_t data[], uint32_t length);
+
+   /**
+    * Write a message made of two parts as one record (producer).
+    * @param r - ring buffer.
+    * @param hdr - first part of the message.
+    * @param hdrLength - length of the first part.
+    * @param data - second part of the message.
+    * @param length - length of the second part. The message is max. 65535 bytes.
+    * @return true if written, false if it doesn't fit.
+    */
+   bool ringbuf_write_msg2(ringbuf_t* r, const uint8_t hdr[], uint32_t hdrLength, const uint8_t data[], uint32_t length);
+
+   /**
+    * Read a message written with ringbuf_write_msg (consumer).
+    * @param r - ring buffer.
+    * @param data - buffer to read into.
+    * @param maxLength - size of the buffer. A longer message is truncated.
+    * @return length of the message in the buffer, or -1 if there is no message.
+    */
+   int32_t ringbuf_read_msg(ringbuf_t* r, uint8_t data[], uint32_t maxLength);
+
+   /**
+    * Get the next message written with ringbuf_write_msg without copying it (consumer).
+    * It stays in the ring until ringbuf_release_msg, so the producer can't overwrite it.
+    * A message which wraps at the end of the storage is copied into a scratch buffer.
+    * @param r - ring buffer.
+    * @param ppData - set to the message (in the storage or in pScratch).
+    * @param pScratch - buffer for a wrapped message.
+    * @param maxLength - size of pScratch. A longer wrapped message is truncated.
+    * @return length of the message, or -1 if there is no message.
+    */
+   int32_t ringbuf_peek_msg(ringbuf_t* r, const uint8_t** ppData, uint8_t pScratch[], uint32_t maxLength);
+
+   /**
+    * Remove the message got with ringbuf_peek_msg (consumer).
+    * @param r - ring buffer.
+    */
+   void ringbuf_release_msg(ringbuf_t* r);
+
+   /**
+    * Drop everything which wasn't read yet (consumer).
+    * @param r - ring buffer.
+    */
+   void ringbuf_clear(ringbuf_t* r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LV_APPLICATION_RINGBUF_H_ */
@@ -0,0 +1,296 @@
+/*
+ * serial_test.c
+ *
+ * Test of the serial link through a pseudo terminal pair.
+ * The port under test is opened with serial_connect on the slave side, the test writes the
+ * peer's bytes to the master side and reads what the port sends from it.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE   // posix_openpt, ptsname
+#endif
+
+#include "serial_test.h"
+
+#if LV_USE_TESTS
+
+#include "../uart.h"
+#include "../frame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+
+#define TEST_BAUD       115200
+#define TEST_TIMEOUT    1000     // ms to wait for the bytes to pass the pty
+
+#define CHECK(cond) test_check((cond), #cond, __LINE__)
+
+/**
+ * A frame fetched with serial_drain_frames.
+ */
+typedef struct
+{
+   uint8_t type;
+   uint16_t length;
+   uint8_t payload[FRAME_MAX_PAYLOAD];
+} test_frame_t;
+
+// ---------------        Internal Functions        ---------------
+
+/**
+ * Count and print a failed check.
+ * @param cond - result of the check.
+ * @param pText - the checked expression.
+ * @param line - line of the check.
+ */
+static void test_check(bool cond, const char* pText, int line);
+
+/**
+ * Write the bytes of the peer to the master side and let the port read them.
+ * @param s - serial structure.
+ * @param data - the bytes.
+ * @param length - number of bytes.
+ * @return true if the port received all of them.
+ */
+static bool test_feed(serial_t* s, const void* data, uint32_t length);
+
+/**
+ * Wait until the event file descriptor of the port is readable.
+ * @param s - serial structure.
+ * @return true if it's readable.
+ */
+static bool test_wait(serial_t* s);
+
+/**
+ * Fetch the next frame.
+ * @param s - serial structure.
+ * @param pFrame - the frame is copied here.
+ * @return true if a frame was queued.
+ */
+static bool test_get_frame(serial_t* s, test_frame_t* pFrame);
+
+/**
+ * Copy a frame in the handler of serial_drain_frames.
+ */
+static void test_frame_handler(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser);
+
+/**
+ * Read from the master side what the port sent.
+ * @param pBuf - buffer for the bytes.
+ * @param length - number of bytes to read.
+ * @return true if all of them were read.
+ */
+static bool test_read_peer(uint8_t pBuf[], uint32_t length);
+
+static int32_t master = -1;
+static int32_t failed;
+
+// ---------------        External Functions        ---------------
+
+int32_t serial_test_pty(void)
+{
+   uint8_t buf[FRAME_MAX_SIZE * 2];
+   uint32_t size;
+   char msg[SERIAL_MSG_MAX];
+   test_frame_t frame;
+   serial_stats_t stats;
+
+   failed = 0;
+
+   master = posix_openpt(O_RDWR | O_NOCTTY);
+   if(master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+   {
+      perror("pty");
+      if(master >= 0)
+      {
+         close(master);
+      }
+      return -1;
+   }
+   // The master side passes the bytes unchanged too
+   struct termios tio;
+   tcgetattr(master, &tio);
+   cfmakeraw(&tio);
+   tcsetattr(master, TCSANOW, &tio);
+
+   serial_t* s = serial_create(NULL);
+   CHECK(s != NULL);
+   if(s == NULL)
+   {
+      close(master);
+      return failed;
+   }
+   CHECK(serial_connect(s, ptsname(master), TEST_BAUD) == 0);
+   CHECK(serial_is_open(s));
+   CHECK(serial_get_mode(s) == SERIAL_MODE_TEXT);
+
+   // Text lines, with "\r\n" and "\n" endings, one split over two writes
+   const char lines[] = "hello\r\nworld\nspl";
+   CHECK(test_feed(s, lines, strlen(lines)));
+   CHECK(test_feed(s, "it\r\n", 4));
+   CHECK(serial_gets(s, msg, sizeof(msg)) == 5 && strcmp(msg, "hello") == 0);
+   CHECK(serial_gets(s, msg, sizeof(msg)) == 5 && strcmp(msg, "world") == 0);
+   CHECK(serial_gets(s, msg, sizeof(msg)) == 5 && strcmp(msg, "split") == 0);
+   CHECK(serial_gets(s, msg, sizeof(msg)) == -1);
+
+   // "binary" switches to frames from the next byte, a frame in the same write
+   const uint8_t samples[] = {0x01, 0x34, 0x12, 0xFF, 0xFF};
+   size = sizeof(SERIAL_BINARY_CMD "\r\n") - 1;
+   memcpy(buf, SERIAL_BINARY_CMD "\r\n", size);
+   size += frame_encode(&buf[size], FRAME_TYPE_SAMPLES_I16, samples, sizeof(samples));
+   CHECK(test_feed(s, buf, size));
+   CHECK(serial_get_mode(s) == SERIAL_MODE_BINARY);
+   CHECK(serial_gets(s, msg, sizeof(msg)) > 0 && strcmp(msg, SERIAL_BINARY_CMD) == 0);
+   CHECK(test_get_frame(s, &frame) && frame.type == FRAME_TYPE_SAMPLES_I16 &&
+         frame.length == sizeof(samples) && memcmp(frame.payload, samples, sizeof(samples)) == 0);
+   CHECK(!test_get_frame(s, &frame));
+
+   // A frame with a bad CRC is dropped, the next one is received
+   const uint8_t cmd[] = "slider 50";
+   size = frame_encode(buf, FRAME_TYPE_COMMAND, cmd, sizeof(cmd) - 1);
+   buf[size - 1] ^= 0x01;
+   size += frame_encode(&buf[size], FRAME_TYPE_COMMAND, cmd, sizeof(cmd) - 1);
+   CHECK(test_feed(s, buf, size));
+   serial_get_stats(s, &stats);
+   CHECK(stats.frameErrors == 1);
+   CHECK(test_get_frame(s, &frame) && frame.type == FRAME_TYPE_COMMAND &&
+         frame.length == sizeof(cmd) - 1 && memcmp(frame.payload, cmd, sizeof(cmd) - 1) == 0);
+   CHECK(!test_get_frame(s, &frame));
+
+   // A header with a too large length is dropped at once, the decoder resyncs on the next SYNC
+   size = 0;
+   buf[size++] = FRAME_SYNC;
+   buf[size++] = (FRAME_MAX_PAYLOAD + 1) & 0xFF;
+   buf[size++] = (FRAME_MAX_PAYLOAD + 1) >> 8;
+   buf[size++] = FRAME_TYPE_COMMAND;
+   buf[size++] = 'x';
+   size += frame_encode(&buf[size], FRAME_TYPE_COMMAND, cmd, sizeof(cmd) - 1);
+   CHECK(test_feed(s, buf, size));
+   serial_get_stats(s, &stats);
+   CHECK(stats.frameErrors == 2);
+   CHECK(test_get_frame(s, &frame) && frame.type == FRAME_TYPE_COMMAND &&
+         frame.length == sizeof(cmd) - 1 && memcmp(frame.payload, cmd, sizeof(cmd) - 1) == 0);
+   CHECK(!test_get_frame(s, &frame));
+
+   // A text mode frame switches back to lines from the next byte
+   size = frame_encode(buf, FRAME_TYPE_TEXT_MODE, NULL, 0);
+   memcpy(&buf[size], "after\r\n", 7);
+   size += 7;
+   CHECK(test_feed(s, buf, size));
+   CHECK(serial_get_mode(s) == SERIAL_MODE_TEXT);
+   CHECK(!test_get_frame(s, &frame));
+   CHECK(serial_gets(s, msg, sizeof(msg)) == 5 && strcmp(msg, "after") == 0);
+
+   serial_get_stats(s, &stats);
+   CHECK(stats.rxMsgs == 5);
+   CHECK(stats.rxFrames == 3);
+   CHECK(stats.dropped == 0);
+
+   // Sent bytes are queued and written by serial_poll
+   uint8_t expected[64];
+   const char ping[] = "ping\r\n";
+   CHECK(serial_send(s, (const uint8_t*)ping, strlen(ping)) == (int32_t)strlen(ping));
+   CHECK(serial_send_frame(s, FRAME_TYPE_COMMAND, cmd, sizeof(cmd) - 1) > 0);
+   memcpy(expected, ping, strlen(ping));
+   size = strlen(ping) + frame_encode(&expected[strlen(ping)], FRAME_TYPE_COMMAND, cmd, sizeof(cmd) - 1);
+   CHECK(test_wait(s));      // The port is watched for writing
+   CHECK(serial_poll(s) == 0);
+   CHECK(test_read_peer(buf, size) && memcmp(buf, expected, size) == 0);
+   serial_get_stats(s, &stats);
+   CHECK(stats.txBytes == size);
+
+   // Hang-up of the peer closes the port
+   close(master);
+   master = -1;
+   CHECK(test_wait(s));
+   CHECK(serial_poll(s) == -1);
+   CHECK(!serial_is_open(s));
+
+   serial_destroy(s);
+
+   printf("serial pty test: %d failed\r\n", failed);
+   return failed;
+}
+
+// ---------------        Internal Functions        --------------
+
+static void test_check(bool cond, const char* pText, int line)
+{
+   if(!cond)
+   {
+      printf("serial pty test failed at line %d: %s\r\n", line, pText);
+      failed++;
+   }
+}
+
+static bool test_feed(serial_t* s, const void* data, uint32_t length)
+{
+   serial_stats_t stats;
+   serial_get_stats(s, &stats);
+   uint32_t target = stats.rxBytes + length;
+
+   if(write(master, data, length) != (ssize_t)length)
+   {
+      return false;
+   }
+   // The pty can pass the bytes in several parts
+   while(stats.rxBytes < target)
+   {
+      if(!test_wait(s) || serial_poll(s) < 0)
+      {
+         return false;
+      }
+      serial_get_stats(s, &stats);
+   }
+   return stats.rxBytes == target;
+}
+
+static bool test_wait(serial_t* s)
+{
+   struct pollfd pfd;
+   pfd.fd = serial_get_event_fd(s);
+   pfd.events = POLLIN;
+   return poll(&pfd, 1, TEST_TIMEOUT) == 1;
+}
+
+static bool test_get_frame(serial_t* s, test_frame_t* pFrame)
+{
+   return serial_drain_frames(s, test_frame_handler, pFrame, 1) == 1;
+}
+
+static void test_frame_handler(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser)
+{
+   test_frame_t* pFrame = (test_frame_t*)pUser;
+   pFrame->type = type;
+   pFrame->length = length;
+   memcpy(pFrame->payload, pPayload, length);
+}
+
+static bool test_read_peer(uint8_t pBuf[], uint32_t length)
+{
+   uint32_t count = 0;
+   while(count < length)
+   {
+      struct pollfd pfd;
+      pfd.fd = master;
+      pfd.events = POLLIN;
+      if(poll(&pfd, 1, TEST_TIMEOUT) != 1)
+      {
+         return false;
+      }
+      ssize_t res = read(master, &pBuf[count], length - count);
+      if(res <= 0)
+      {
+         return false;
+      }
+      count += res;
+   }
+   return true;
+}
+
+#endif /* LV_USE_TESTS */
@@ -0,0 +1,39 @@
+/*
+ * serial_test.h
+ *
+ * Test of the serial link (uart.c, frame.c) through a pseudo terminal pair on Linux.
+ * The test talks to the port from the master side of the pty, no hardware is needed.
+ */
+
+#ifndef LV_APPLICATION_SERIAL_TEST_H_
+#define LV_APPLICATION_SERIAL_TEST_H_
+
+#include <stdint.h>
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_app_conf.h"
+#else
+#include "../../lv_app_conf.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if LV_USE_TESTS
+
+   /**
+    * Run the serial link through a pty pair: text lines, the switch to binary frames,
+    * bad frames and resync, command and text mode frames, transmitting and hang-up.
+    * The failed checks are printed.
+    * @return number of failed checks, or -1 if the pty can't be opened.
+    */
+   int32_t serial_test_pty(void);
+
+#endif /* LV_USE_TESTS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LV_APPLICATION_SERIAL_TEST_H_ */
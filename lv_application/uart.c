@@ -1,5 +1,7 @@
 
 #include "uart.h"
+#include "ringbuf.h"
+#include "baud.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -10,9 +12,10 @@
 #include <stdint.h>
 
 #include <unistd.h>
-#include <pthread.h>
-#include <signal.h>
-#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <string.h>
@@ -22,27 +25,41 @@
  * Encapsulates a serial connection.
  */
 struct serial_s {
-   int32_t fd;                  //>! Connection file descriptor.
+   int32_t fd;                  //>! Connection file descriptor, non-blocking.
    int32_t state;               //>! Signifies connection state.
-   int32_t running;             //>! Signifies thread state.
    void (*pRxCallback)(char* pMsg);
-   volatile char rxbuff[BUFF_SIZE];  //>! Buffer for RX data.
-   volatile bool bAvailable;
-   pthread_t rx_thread;     //>! Listening thread.
+   ringbuf_t rxRing;            //>! Received lines.
+   ringbuf_t rxFrameRing;       //>! Received frames (type and payload).
+   ringbuf_t txRing;            //>! Bytes to send, written to the port by serial_poll.
+   bool bTxWatched;             //>! The port is watched for writability.
+   frame_decoder_t decoder;     //>! Binary frame being received.
+   serial_mode_t mode;          //>! Mode of the receiver.
+   uint32_t pending;            //>! Lines and frames queued since the last signal.
+   char line[SERIAL_MSG_MAX];   //>! Line being received.
+   uint32_t lineLen;            //>! Length of the line being received.
+   bool bOverlong;              //>! The line being received is too long, skip it.
+   serial_stats_t stats;        //>! Counters of the port.
+   struct serial_icounter_struct icountBase;   //>! Driver counters when the port was opened.
+   int32_t event_fd;            //>! Signalled while received messages are queued.
+   int32_t epoll_fd;            //>! Waits for the port and event_fd, given to the application.
 };
 
 // ---------------        Internal Functions        ---------------
 
-static int32_t serial_resolve_baud(int32_t baud);
+/**
+ * Set the baud rate through termios2, after the other settings.
+ * @param s - serial structure.
+ * @param baud - rate in bit/s.
+ * @return 0 on success, -3 if the driver doesn't accept the rate.
+ */
+static int32_t serial_apply_baud(serial_t* s, int32_t baud);
 
 /**
- * @brief Start the serial threads.
- * This spawns the listening and transmitting threads
- * if they are not already running.
+ * Take the driver's error counters as the start of the port's line errors and overruns.
+ * The driver counts for the lifetime of the device, not for the connection.
  * @param s - serial structure.
- * @return 0 on success, or -1 on error.
  */
-static int32_t serial_start(serial_t* s);
+static void serial_icount_start(serial_t* s);
 
 /**
  * Recieve data.
@@ -54,26 +71,66 @@ static int32_t serial_start(serial_t* s);
  */
 static int32_t serial_recieve(serial_t* obj, uint8_t data[], int32_t maxLength);
 
-static void serial_rx_callback(serial_t* s, char data[]);
+static bool serial_rx_callback(serial_t* s, char data[], uint32_t length);
 
 /**
- * @brief Serial Listener Thread.
- * This blocks waiting for data to be recieved from the serial device,
- * and calls the serial_callback method with appropriate context when
- * data is recieved.
- * Exits when close method is called, or serial error occurs.
- * @param param - context passed from thread instantiation.
+ * Cut the received bytes into lines.
+ * Stops after the line SERIAL_BINARY_CMD, the next bytes are binary frames.
+ * Called by serial_poll only.
+ * @param s - serial structure.
+ * @param data - received bytes.
+ * @param length - number of bytes.
+ * @return number of bytes used.
  */
-static void *serial_data_listener(void *param);
+static int32_t serial_frame(serial_t* s, const uint8_t data[], int32_t length);
 
+/**
+ * Callback of the frame decoder to store a frame in the queue.
+ * Called by serial_poll only.
+ */
+static void serial_frame_callback(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser);
 
+/**
+ * Pass the received bytes to the line framer or the frame decoder, following the mode switches.
+ * Called by serial_poll only.
+ * @param s - serial structure.
+ * @param data - received bytes.
+ * @param length - number of bytes.
+ */
+static void serial_process(serial_t* s, const uint8_t data[], int32_t length);
 
 /**
- * Stop serial listener thread.
+ * Check if lines or frames are queued.
  * @param s - serial structure.
- * @return 0;
+ * @return true if something is queued.
  */
-static int32_t serial_stop(serial_t* s);
+static bool serial_pending(serial_t* s);
+
+/**
+ * Signal the event file descriptor.
+ * @param s - serial structure.
+ */
+static void serial_signal(serial_t* s);
+
+/**
+ * Acknowledge the event file descriptor.
+ * @param s - serial structure.
+ */
+static void serial_ack(serial_t* s);
+
+/**
+ * Write the queued bytes until the port doesn't accept more.
+ * @param s - serial structure.
+ * @return 0, or -1 on a write error.
+ */
+static int32_t serial_flush(serial_t* s);
+
+/**
+ * Watch the port for writability only while bytes are queued,
+ * else the event file descriptor would be readable all the time.
+ * @param s - serial structure.
+ */
+static void serial_watch(serial_t* s);
 
 
 // ---------------        External Functions        ---------------
@@ -82,13 +139,33 @@ static int32_t serial_stop(serial_t* s);
 serial_t* serial_create(void (*pCallback)(char* pMsg))
 {
    //Allocate serial object.
-   serial_t* s = malloc(sizeof(serial_t));
-   //Reconfigure buffer object.
-   s->bAvailable = false;
+   serial_t* s = calloc(1, sizeof(serial_t));
+   if(s == NULL)
+   {
+      return NULL;
+   }
+   frame_decoder_init(&s->decoder, serial_frame_callback, s);
    s->fd = -1;
-   if(pCallback != NULL)
+   s->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   s->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+   s->pRxCallback = pCallback;
+
+   //Allocate the queues of received lines and frames and of the bytes to send.
+   bool bOk = ringbuf_init(&s->rxRing, SERIAL_RX_RING_SIZE);
+   bOk = bOk && ringbuf_init(&s->rxFrameRing, SERIAL_RX_FRAME_RING_SIZE);
+   bOk = bOk && ringbuf_init(&s->txRing, SERIAL_TX_RING_SIZE);
+
+   //The application waits for the port and the queued messages through one file descriptor.
+   struct epoll_event event;
+   event.events = EPOLLIN;
+   event.data.u64 = 0;
+   event.data.fd = s->event_fd;
+   bOk = bOk && (s->event_fd >= 0) && (s->epoll_fd >= 0) &&
+         (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, s->event_fd, &event) == 0);
+   if(!bOk)
    {
-      s->pRxCallback = pCallback;
+      serial_destroy(s);
+      return NULL;
    }
    //Return pointer.
    return s;
@@ -97,6 +174,18 @@ serial_t* serial_create(void (*pCallback)(char* pMsg))
 
 void serial_destroy(serial_t* s)
 {
+   serial_close(s);
+   if(s->epoll_fd >= 0)
+   {
+      close(s->epoll_fd);
+   }
+   if(s->event_fd >= 0)
+   {
+      close(s->event_fd);
+   }
+   ringbuf_deinit(&s->rxRing);
+   ringbuf_deinit(&s->rxFrameRing);
+   ringbuf_deinit(&s->txRing);
    free(s);
 }
 
@@ -106,15 +195,11 @@ int32_t serial_connect(serial_t* s, char device[], int32_t baud)
 {
    struct termios oldtio;
 
-   // Resolve baud.
-   int32_t speed = serial_resolve_baud(baud);
-   if (speed < 0) {
-      printf("Error: Baud rate not recognized.\r\n");
-      return -3;
-   }
+   //Close the previous connection.
+   serial_close(s);
 
-   //Open device.
-   s->fd = open(device, O_RDWR);
+   //Open device, reads and writes never block.
+   s->fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
    //Catch file open error.
    if (s->fd < 0) {
       perror(device);
@@ -122,22 +207,45 @@ int32_t serial_connect(serial_t* s, char device[], int32_t baud)
    }
    //Retrieve settings.
    tcgetattr(s->fd, &oldtio);
-   //Set baud rate.
-   cfsetspeed(&oldtio, speed);
    //Flush cache.
    tcflush(s->fd, TCIFLUSH);
-   // disable local echo
-   oldtio.c_lflag &= ~ECHO;
+   // raw mode: no echo, no line editing and no translation of the bytes,
+   // serial_poll cuts the lines itself and binary frames pass unchanged
+   cfmakeraw(&oldtio);
+   oldtio.c_cc[VMIN] = 1;
+   oldtio.c_cc[VTIME] = 0;
    //Apply settings.
    tcsetattr(s->fd, TCSANOW, &oldtio);
+   //Set baud rate.
+   if(serial_apply_baud(s, baud) < 0)
+   {
+      close(s->fd);
+      s->fd = -1;
+      return -3;
+   }
 
-   //Start listener thread.
-   int32_t res = serial_start(s);
-   //Catch error.
-   if (res < 0) {
-      printf("Error: serial thread could not be spawned\r\n");
+   //Count the line errors of this connection.
+   serial_icount_start(s);
+
+   //Start with an empty line.
+   s->lineLen = 0;
+   s->bOverlong = false;
+   //Start in text mode.
+   s->mode = SERIAL_MODE_TEXT;
+   frame_decoder_reset(&s->decoder);
+
+   //Wait for the received bytes in the event loop of the application.
+   struct epoll_event event;
+   event.events = EPOLLIN;
+   event.data.u64 = 0;
+   event.data.fd = s->fd;
+   if(epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, s->fd, &event) < 0) {
+      printf("Error: serial port could not be watched\r\n");
+      close(s->fd);
+      s->fd = -1;
       return -2;
    }
+   s->bTxWatched = false;
 
    //Indicate connection was successful.
    s->state = 1;
@@ -155,21 +263,11 @@ int32_t serial_set_params(serial_t* s, ser_param_t* pParam)
    //Retrieve settings.
    tcgetattr(s->fd, &tio);
 
-   int32_t speed = serial_resolve_baud(pParam->baud);
-
-   if (speed < 0) {
-      printf("Error: Baud rate not recognized\n");
-      return -3;
-   }
-
    if((pParam->databits < 5) || (pParam->databits > 8))
    {
       printf("Error: invalid data bits\n");
    }
 
-   // setbaudrate
-   cfsetspeed(&tio, speed);
-
    // set stop bits
    if(pParam->stopbits ==  STOPBITS_1)
    {
@@ -226,49 +324,260 @@ int32_t serial_set_params(serial_t* s, ser_param_t* pParam)
 
    tcsetattr(s->fd, TCSANOW, &tio);
 
-   return 0;
+   // set baud rate
+   return serial_apply_baud(s, pParam->baud);
 }
 
-//Send data.
-int32_t serial_send(serial_t* s, const uint8_t data[], int32_t length)
+int32_t serial_get_baud(serial_t* s)
 {
    if(s->fd < 0)
    {
       return -1;
    }
-   int32_t res = write(s->fd, data, length);
+   return baud_get(s->fd);
+}
+
+int32_t serial_probe_bauds(serial_t* s, const int32_t pRates[], int32_t count, int32_t pAccepted[])
+{
+   if(s->fd < 0)
+   {
+      return -1;
+   }
+   int32_t baud = baud_get(s->fd);
+   int32_t accepted = 0;
+   int32_t i;
+   for(i = 0; i < count; i++)
+   {
+      if(baud_match(pRates[i], baud_set(s->fd, pRates[i])))
+      {
+         pAccepted[accepted++] = pRates[i];
+      }
+   }
+   // Back to the rate in use
+   baud_set(s->fd, baud);
+   // Drop what was received at the wrong rates and don't count its errors
+   tcflush(s->fd, TCIOFLUSH);
+   serial_icount_start(s);
+   return accepted;
+}
+
+//Check the connection.
+bool serial_is_open(serial_t* s)
+{
+   return s->fd >= 0;
+}
+
+//Do the pending I/O.
+int32_t serial_poll(serial_t* s)
+{
+   uint8_t buff[BUFF_SIZE];
+   int32_t res = 0;
+
+   if(s->fd < 0)
+   {
+      return 0;
+   }
+
+   //Read until the port is empty.
+   while(1)
+   {
+      int32_t count = serial_recieve(s, buff, BUFF_SIZE);
+      if(count > 0)
+      {
+         s->stats.rxBytes += count;
+         serial_process(s, buff, count);
+      }
+      else if(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+         break;
+      }
+      else if(count < 0 && errno == EINTR)
+      {
+         continue;
+      }
+      else
+      {
+         //Hang up (0) or error.
+         res = -1;
+         break;
+      }
+   }
+
+   //Wake up the reader once for the complete lines and frames.
+   if(s->pending > 0)
+   {
+      s->pending = 0;
+      serial_signal(s);
+   }
+
+   //Write the queued bytes.
+   if(res == 0)
+   {
+      res = serial_flush(s);
+   }
+
+   if(res < 0)
+   {
+      printf("Error: Serial disconnect\r\n");
+      serial_close(s);
+   }
    return res;
 }
 
+//Send data.
+int32_t serial_send(serial_t* s, const uint8_t data[], int32_t length)
+{
+   if(s->fd < 0 || length < 0)
+   {
+      return -1;
+   }
+   //All or nothing, so a message isn't cut.
+   if((uint32_t)length > ringbuf_space(&s->txRing))
+   {
+      s->stats.txFull++;
+      return SERIAL_ERR_TX_FULL;
+   }
+   //Written by serial_poll together with the rest of the queue.
+   ringbuf_write(&s->txRing, data, length);
+   serial_watch(s);
+   return length;
+}
+
 void serial_put(serial_t* s, uint8_t data)
 {
-   char arr[1];
-   arr[0] = data;
-   write(s->fd, arr, 1);
+   serial_send(s, &data, 1);
+}
+
+//Free space of the transmit queue.
+int32_t serial_tx_space(serial_t* s)
+{
+   return ringbuf_space(&s->txRing);
 }
 
 
 //Fetch a message
-int32_t serial_gets(serial_t* s, char* pBuf)
+int32_t serial_gets(serial_t* s, char* pBuf, int32_t maxLength)
 {
-   int32_t count = -1;
-   if(s->fd < 0)
+   if(maxLength < 1)
+   {
+      return -1;
+   }
+   // Acknowledge the event before taking the message, so a newer one signals again
+   serial_ack(s);
+   int32_t count = ringbuf_read_msg(&s->rxRing, (uint8_t*)pBuf, maxLength - 1);
+   if(count >= 0)
+   {
+      pBuf[count] = '\0';
+   }
+   // Keep the event set while messages are left
+   if(serial_pending(s))
+   {
+      serial_signal(s);
+   }
+   return count;
+}
+
+//Fetch several messages
+int32_t serial_drain(serial_t* s, void (*pHandler)(const char* pMsg, int32_t length, void* pUser), void* pUser,
+                     int32_t maxMsgs)
+{
+   uint8_t scratch[SERIAL_MSG_MAX];   // only for a message wrapping at the end of the queue
+   int32_t count = 0;
+
+   serial_ack(s);
+   while(count < maxMsgs)
    {
-      return count;
+      const uint8_t* pMsg;
+      int32_t length = ringbuf_peek_msg(&s->rxRing, &pMsg, scratch, sizeof(scratch));
+      if(length < 0)
+      {
+         break;
+      }
+      pHandler((const char*)pMsg, length, pUser);
+      ringbuf_release_msg(&s->rxRing);
+      count++;
    }
-   if(s->bAvailable)
+   // Keep the event set while messages are left
+   if(serial_pending(s))
    {
-      strcpy(pBuf, (void*)s->rxbuff);
-      s->bAvailable = false;
-      count = strlen(pBuf);
+      serial_signal(s);
    }
    return count;
 }
 
+//Fetch several frames
+int32_t serial_drain_frames(serial_t* s, frame_handler_t pHandler, void* pUser, int32_t maxFrames)
+{
+   uint8_t scratch[1 + FRAME_MAX_PAYLOAD];   // only for a frame wrapping at the end of the queue
+   int32_t count = 0;
+
+   serial_ack(s);
+   while(count < maxFrames)
+   {
+      const uint8_t* pMsg;
+      int32_t length = ringbuf_peek_msg(&s->rxFrameRing, &pMsg, scratch, sizeof(scratch));
+      if(length < 1)
+      {
+         break;
+      }
+      // The type is stored before the payload
+      pHandler(pMsg[0], &pMsg[1], length - 1, pUser);
+      ringbuf_release_msg(&s->rxFrameRing);
+      count++;
+   }
+   // Keep the event set while frames are left
+   if(serial_pending(s))
+   {
+      serial_signal(s);
+   }
+   return count;
+}
+
+//Send a frame
+int32_t serial_send_frame(serial_t* s, uint8_t type, const uint8_t pPayload[], uint16_t length)
+{
+   uint8_t buf[FRAME_MAX_SIZE];
+   uint32_t size = frame_encode(buf, type, pPayload, length);
+   if(size == 0)
+   {
+      return -1;
+   }
+   return serial_send(s, buf, size);
+}
+
+//Get the receiver mode
+serial_mode_t serial_get_mode(serial_t* s)
+{
+   return s->mode;
+}
+
+//Get the counters
+void serial_get_stats(serial_t* s, serial_stats_t* pStats)
+{
+   *pStats = s->stats;
+   pStats->frameErrors = s->decoder.errors;
+
+   //Line errors counted by the driver, not every driver counts them.
+   struct serial_icounter_struct icount;
+   if(s->fd >= 0 && ioctl(s->fd, TIOCGICOUNT, &icount) == 0)
+   {
+      pStats->lineErrors = (icount.frame + icount.parity) - (s->icountBase.frame + s->icountBase.parity);
+      pStats->overruns = (icount.overrun + icount.buf_overrun) -
+                         (s->icountBase.overrun + s->icountBase.buf_overrun);
+   }
+}
+
+//Get the file descriptor to wait for
+int32_t serial_get_event_fd(serial_t* s)
+{
+   return s->epoll_fd;
+}
+
 void serial_clear(serial_t* s)
 {
-   //Clear the buffer.
-   s->bAvailable = false;
+   //Drop the queued lines and frames.
+   ringbuf_clear(&s->rxRing);
+   ringbuf_clear(&s->rxFrameRing);
 }
 
 //Close serial port.
@@ -278,126 +587,227 @@ int32_t serial_close(serial_t* s)
    {
       return -1;
    }
-   //Stop thread.
-   serial_stop(s);
-   close(s->fd);
-   return 0;
+   //Send what the port accepts from the queue without waiting, drop the rest.
+   serial_flush(s);
+   ringbuf_clear(&s->txRing);
+   s->bTxWatched = false;
+   //Nothing runs in the background, the port is free when it's closed.
+   epoll_ctl(s->epoll_fd, EPOLL_CTL_DEL, s->fd, NULL);
+   int32_t res = close(s->fd);
+   s->fd = -1;
+   s->state = 0;
+   return res;
 }
 
 // ---------------        Internal Functions        --------------
 
-//Stop serial listener thread.
-static int32_t serial_stop(serial_t* s)
+//Set the baud rate.
+static int32_t serial_apply_baud(serial_t* s, int32_t baud)
 {
-   s->running = 0;
+   int32_t actual = baud_set(s->fd, baud);
+   if(!baud_match(baud, actual))
+   {
+      printf("Error: Baud rate %d not accepted by the driver (%d).\r\n", baud, actual);
+      return -3;
+   }
    return 0;
 }
 
-// Resolves standard baud rates to linux constants.
-static int32_t serial_resolve_baud(int32_t baud)
+//Start counting the line errors.
+static void serial_icount_start(serial_t* s)
 {
-   int32_t speed;
-   // Switch common baud rates to temios constants.
-   switch (baud) {
-   case 9600:
-      speed = B9600;
-      break;
-   case 19200:
-      speed = B19200;
-      break;
-   case 38400:
-      speed = B38400;
-      break;
-   case 57600:
-      speed = B57600;
-      break;
-   case 115200:
-      speed = B115200;
-      break;
-   default:
-      speed = -1;
-      break;
+   if(ioctl(s->fd, TIOCGICOUNT, &s->icountBase) < 0)
+   {
+      memset(&s->icountBase, 0, sizeof(s->icountBase));
    }
-   // Return.
-   return speed;
 }
 
-// Start serial listener.
-static int32_t serial_start(serial_t* s)
+//Recieve data.
+static int32_t serial_recieve(serial_t* s, uint8_t data[], int32_t maxLength)
 {
-   //Only start if it is not currently running.
-   if (s->running != 1) {
-      //Set running.
-      s->running = 1;
-      //Spawn thread.
-      int32_t res;
-      res = pthread_create(&s->rx_thread, NULL, serial_data_listener, (void*) s);
-      if (res != 0) {
-         return -2;
+   return read(s->fd, data, maxLength);
+}
+
+//Callback to store a line in the queue.
+static bool serial_rx_callback(serial_t* s, char data[], uint32_t length)
+{
+   //Put the line into the queue, the reader gets all of it or nothing.
+   bool bQueued = ringbuf_write_msg(&s->rxRing, (uint8_t*)data, length);
+   if(bQueued)
+   {
+      s->stats.rxMsgs++;
+      s->pending++;
+   }
+   else
+   {
+      s->stats.dropped++;
+   }
+   if(s->pRxCallback != NULL)
+   {
+      s->pRxCallback(data);
+   }
+   return bQueued;
+}
+
+//Cut the received bytes into lines.
+static int32_t serial_frame(serial_t* s, const uint8_t data[], int32_t length)
+{
+   int32_t i;
+   for(i = 0; i < length; i++)
+   {
+      uint8_t c = data[i];
+      if(c == '\n')
+      {
+         //Remove the '\r' of "\r\n" line endings.
+         if(s->lineLen > 0 && s->line[s->lineLen - 1] == '\r')
+         {
+            s->lineLen--;
+         }
+         if(s->bOverlong)
+         {
+            s->stats.overlong++;
+         }
+         else if(s->lineLen > 0)
+         {
+            s->line[s->lineLen] = '\0';
+            serial_rx_callback(s, s->line, s->lineLen);
+         }
+         bool bBinary = !s->bOverlong && strcmp(s->line, SERIAL_BINARY_CMD) == 0;
+         s->lineLen = 0;
+         s->bOverlong = false;
+         s->line[0] = '\0';
+         //The next bytes are binary frames.
+         if(bBinary)
+         {
+            frame_decoder_reset(&s->decoder);
+            s->mode = SERIAL_MODE_BINARY;
+            return i + 1;
+         }
+      }
+      else if(s->lineLen < SERIAL_MSG_MAX - 1)
+      {
+         s->line[s->lineLen++] = c;
+      }
+      else
+      {
+         s->bOverlong = true;
       }
-      //Return result.
-      return 0;
-   } else {
-      return -1;
    }
+   return length;
 }
 
+//Callback to store a frame in the queue.
+static void serial_frame_callback(uint8_t type, const uint8_t* pPayload, uint16_t length, void* pUser)
+{
+   serial_t* s = (serial_t*)pUser;
+   if(type == FRAME_TYPE_TEXT_MODE)
+   {
+      //The next bytes are text lines.
+      s->mode = SERIAL_MODE_TEXT;
+      return;
+   }
+   //Store the type before the payload, the reader gets all of it or nothing.
+   if(ringbuf_write_msg2(&s->rxFrameRing, &type, 1, pPayload, length))
+   {
+      s->stats.rxFrames++;
+      s->pending++;
+   }
+   else
+   {
+      s->stats.dropped++;
+   }
+}
 
+//Pass the received bytes on in the current mode.
+static void serial_process(serial_t* s, const uint8_t data[], int32_t length)
+{
+   while(length > 0)
+   {
+      int32_t used;
+      if(s->mode == SERIAL_MODE_BINARY)
+      {
+         used = frame_decode(&s->decoder, data, length);
+      }
+      else
+      {
+         used = serial_frame(s, data, length);
+      }
+      data += used;
+      length -= used;
+   }
+}
 
-//Recieve data.
-static int32_t serial_recieve(serial_t* s, uint8_t data[], int32_t maxLength)
+//Check if lines or frames are queued.
+static bool serial_pending(serial_t* s)
 {
-   return read(s->fd, data, maxLength);
+   return ringbuf_used(&s->rxRing) > 0 || ringbuf_used(&s->rxFrameRing) > 0;
 }
 
-//Callback to store data in buffer.
-static void serial_rx_callback(serial_t* s, char data[])
+//Signal the event file descriptor.
+static void serial_signal(serial_t* s)
 {
-   //Put data into buffer.
-   strcpy((void*)s->rxbuff, data);
-   s->bAvailable = true;
-   if(s->pRxCallback != NULL)
+   if(s->event_fd >= 0)
    {
-      s->pRxCallback(data);
+      uint64_t event = 1;
+      write(s->event_fd, &event, sizeof(event));
    }
 }
 
-//Serial data listener thread.
-static void *serial_data_listener(void *param)
+//Acknowledge the event file descriptor.
+static void serial_ack(serial_t* s)
 {
-   int32_t res = 0;
-   int32_t err = 0;
-   struct pollfd ufds;
-   uint8_t buff[BUFF_SIZE];
+   if(s->event_fd >= 0)
+   {
+      uint64_t events;
+      read(s->event_fd, &events, sizeof(events));
+   }
+}
 
-   //Retrieve paramaters and store locally.
-   serial_t* serial = (serial_t*) param;
-
-   //Run until ended.
-   while (serial->running != 0) {
-      int32_t count = serial_recieve(serial, buff, BUFF_SIZE - 1);
-      //If data was recieved.
-      if (count > 0) {
-         //Pad end of buffer to ensure there is a termination symbol.
-         buff[count-1] = '\0';
-         // Call the serial callback.
-         serial_rx_callback(serial, (char *)buff);
-         //If an error occured.
-      } else if (count < 0) {
-         //Inform user and exit thread.
-         printf("Error: Serial disconnect\r\n");
-         err = 1;
+//Write the queued bytes.
+static int32_t serial_flush(serial_t* s)
+{
+   const uint8_t* pData;
+   uint32_t length;
+
+   //The queue is written in one or two parts, it can wrap at the end of its storage.
+   while((length = ringbuf_peek(&s->txRing, &pData)) > 0)
+   {
+      int32_t res = write(s->fd, pData, length);
+      if(res < 0)
+      {
+         if(errno == EINTR)
+         {
+            continue;
+         }
+         if(errno == EAGAIN || errno == EWOULDBLOCK)
+         {
+            break;
+         }
+         return -1;
+      }
+      ringbuf_skip(&s->txRing, res);
+      s->stats.txBytes += res;
+      //The port's buffer is full, continue when it's writable.
+      if((uint32_t)res < length)
+      {
          break;
       }
-      //Otherwise, keep going around.
    }
-   //If there was an error, close socket.
-   if (err) {
-      serial_close(serial);
-      //raise(SIGLOST);
-   }
-   //Close file.
-   res = close(serial->fd);
+   serial_watch(s);
+   return 0;
+}
 
-   return NULL;
+//Watch the port for writability while bytes are queued.
+static void serial_watch(serial_t* s)
+{
+   bool bTx = ringbuf_used(&s->txRing) > 0;
+   if(s->fd >= 0 && bTx != s->bTxWatched)
+   {
+      struct epoll_event event;
+      event.events = bTx ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+      event.data.u64 = 0;
+      event.data.fd = s->fd;
+      epoll_ctl(s->epoll_fd, EPOLL_CTL_MOD, s->fd, &event);
+      s->bTxWatched = bTx;
+   }
 }
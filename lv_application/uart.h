@@ -2,11 +2,19 @@
 #ifndef SERIAL_H
 #define SERIAL_H
 
-#define BUFF_SIZE 512
+#define BUFF_SIZE 4096   // Bytes read at once, a few ms at Mbaud rates
 #define POLL_TIMEOUT 2000
+#define SERIAL_MSG_MAX 256          // Max. length of a received line + 1
+#define SERIAL_RX_RING_SIZE 16384   // Bytes of the queue of received lines
+#define SERIAL_RX_FRAME_RING_SIZE 65536   // Bytes of the queue of received binary frames
+#define SERIAL_BINARY_CMD "binary"  // Text line switching the receiver to binary frames
+#define SERIAL_TX_RING_SIZE 4096    // Bytes of the transmit queue
+#define SERIAL_ERR_TX_FULL (-2)     // serial_send: the transmit queue is full, nothing was sent
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "tty_info.h"
+#include "frame.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +35,30 @@ extern "C" {
       uint8_t databits;
    }ser_param_t ;
 
+   /**
+    * Receiver modes.
+    * The receiver starts in text mode. The line SERIAL_BINARY_CMD switches it to binary frames
+    * from the next byte, and a FRAME_TYPE_TEXT_MODE frame switches it back.
+    */
+   typedef enum {SERIAL_MODE_TEXT, SERIAL_MODE_BINARY} serial_mode_t;
+
+   /**
+    * Counters of the port.
+    */
+   typedef struct
+   {
+      uint32_t rxBytes;    // Received bytes.
+      uint32_t rxMsgs;     // Received lines.
+      uint32_t dropped;    // Lines or frames dropped because their queue was full.
+      uint32_t overlong;   // Lines dropped because they were longer than SERIAL_MSG_MAX - 1.
+      uint32_t rxFrames;   // Received binary frames.
+      uint32_t frameErrors;   // Binary frames dropped because of a bad length or CRC.
+      uint32_t txBytes;    // Bytes written to the port.
+      uint32_t txFull;     // Sends refused because the transmit queue was full.
+      uint32_t lineErrors; // Framing and parity errors counted by the driver since serial_connect.
+      uint32_t overruns;   // Bytes lost by the UART or the driver since serial_connect.
+   } serial_stats_t;
+
    /**
     * Create the serial structure.
     * Convenience method to allocate memory
@@ -44,11 +76,27 @@ extern "C" {
     * Connect to a serial device.
     * @param s - serial structure.
     * @param device - serial device name.
-    * @param baud - baud rate for connection.
-    * @return -ve on error, 0 on success.
+    * @param baud - baud rate for connection, any rate the driver accepts.
+    * @return -ve on error (-3 if the driver doesn't accept the baud rate), 0 on success.
     */
    int32_t serial_connect(serial_t* s, char device[], int32_t baud);
 
+   /**
+    * Check if the port is open. It's closed by serial_poll if the device disappears.
+    * @param s - serial structure.
+    * @return true if connected.
+    */
+   bool serial_is_open(serial_t* s);
+
+   /**
+    * Do the pending I/O of the port without blocking: read the received bytes into the
+    * queues of lines and frames, and write the queued bytes.
+    * Call it when the file descriptor from serial_get_event_fd is readable.
+    * @param s - serial structure.
+    * @return 0, or -1 if the port was closed because of an error.
+    */
+   int32_t serial_poll(serial_t* s);
+
    /**
     * Set port parameters.
     * @param s - serial structure.
@@ -56,13 +104,35 @@ extern "C" {
     * @param length - size of the data array.
     */
    int32_t serial_set_params(serial_t* s, ser_param_t* pParam);
+   /**
+    * Get the baud rate set by the driver, which can be rounded.
+    * @param s - serial structure.
+    * @return rate in bit/s, or -1 if the port is closed.
+    */
+   int32_t serial_get_baud(serial_t* s);
+
+   /**
+    * Find the baud rates accepted by the driver of the open port.
+    * Every rate is set and read back, then the rate in use is restored.
+    * The bytes received and not yet sent meanwhile are dropped, so probe right after serial_connect.
+    * @param s - serial structure.
+    * @param pRates - rates to try.
+    * @param count - number of rates.
+    * @param pAccepted - the accepted rates are stored here, max. count.
+    * @return number of accepted rates, or -1 if the port is closed.
+    */
+   int32_t serial_probe_bauds(serial_t* s, const int32_t pRates[], int32_t count, int32_t pAccepted[]);
+
    /**
     * Send data.
+    * The data is queued and written by serial_poll, so sending never blocks and
+    * the data of several calls is written at once.
     * @param s - serial structure.
     * @param data - character array to transmit.
     * @param length - size of the data array.
+    * @return length if queued, SERIAL_ERR_TX_FULL if it doesn't fit in the queue (nothing is queued),
+    *         or -1 if the port is closed.
     */
-
    int32_t serial_send(serial_t* s, const uint8_t data[], int32_t length);
 
    /**
@@ -73,14 +143,81 @@ extern "C" {
    void serial_put(serial_t* s, uint8_t data);
 
    /**
-    * Fetch message from the serial buffer.
+    * Get the free space of the transmit queue, to hold back data before serial_send refuses it.
+    * @param s - serial structure.
+    * @return number of bytes which can be sent.
+    */
+   int32_t serial_tx_space(serial_t* s);
+
+   /**
+    * Fetch a message (a received line without the line ending) from the queue.
+    * @param s - serial structure.
+    * @param pBuf - buffer for the message, it's terminated with '\0'.
+    * @param maxLength - size of the buffer.
+    * @return length of the message, or -1 if the queue is empty.
+    */
+   int32_t serial_gets(serial_t* s, char* pBuf, int32_t maxLength);
+
+   /**
+    * Fetch several messages from the queue and pass them to a handler.
+    * The messages are passed in place in the queue (not copied) and are not '\0' terminated.
+    * If messages are left the event file descriptor stays readable.
+    * @param s - serial structure.
+    * @param pHandler - called with every message and its length.
+    * @param pUser - passed to the handler.
+    * @param maxMsgs - max. number of messages to fetch.
+    * @return number of messages fetched.
+    */
+   int32_t serial_drain(serial_t* s, void (*pHandler)(const char* pMsg, int32_t length, void* pUser), void* pUser,
+                        int32_t maxMsgs);
+
+   /**
+    * Fetch several binary frames from the queue and pass them to a handler.
+    * The payloads are passed in place in the queue (not copied).
+    * If frames or messages are left the event file descriptor stays readable.
+    * @param s - serial structure.
+    * @param pHandler - called with the type, the payload and its length of every frame.
+    * @param pUser - passed to the handler.
+    * @param maxFrames - max. number of frames to fetch.
+    * @return number of frames fetched.
+    */
+   int32_t serial_drain_frames(serial_t* s, frame_handler_t pHandler, void* pUser, int32_t maxFrames);
+
+   /**
+    * Send a binary frame.
+    * @param s - serial structure.
+    * @param type - frame type.
+    * @param pPayload - the payload.
+    * @param length - length of the payload, max. FRAME_MAX_PAYLOAD.
+    * @return as serial_send.
+    */
+   int32_t serial_send_frame(serial_t* s, uint8_t type, const uint8_t pPayload[], uint16_t length);
+
+   /**
+    * Get the mode of the receiver.
+    * @param s - serial structure.
+    * @return SERIAL_MODE_TEXT or SERIAL_MODE_BINARY.
+    */
+   serial_mode_t serial_get_mode(serial_t* s);
+
+   /**
+    * Get the counters of the port.
+    * @param s - serial structure.
+    * @param pStats - the counters are copied here.
+    */
+   void serial_get_stats(serial_t* s, serial_stats_t* pStats);
+
+   /**
+    * Get a file descriptor which becomes readable when the port needs serial_poll
+    * or received messages are queued.
+    * It can be waited for with poll/epoll; it stays the same when the port is reopened.
     * @param s - serial structure.
-    * @return character. Null if empty.
+    * @return file descriptor, or -1 on error.
     */
-   int32_t serial_gets(serial_t* s, char* pBuf);
+   int32_t serial_get_event_fd(serial_t* s);
 
    /**
-    * Clear the serial buffer.
+    * Drop the received messages which weren't fetched yet.
     * @param s - serial structure.
     */
    void serial_clear(serial_t* s);
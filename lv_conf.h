@@ -50,6 +50,22 @@
  * Can be changed in the display driver (`lv_disp_drv_t`).*/
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 
+/* Number of threads rendering the invalidated areas in parallel (uses pthreads).
+ * Every area is cut into horizontal slices, one for each thread.
+ * 0 or 1: render only in the thread of `lv_task_handler`*/
+#define LV_REFR_THREADS     4
+
+/* Don't draw the objects (or parts of them) which are hidden by opaque objects drawn later.
+ * The opaque areas are collected with `LV_DESIGN_COVER_CHK` before drawing an area.
+ * The statistics can be read with `lv_refr_cull_monitor()`*/
+#define LV_REFR_OCCLUSION   1
+
+/* Extra cost of refreshing one more area, in pixels (finding the objects, flushing, waking the threads).
+ * Two invalidated areas are refreshed together if their bounding box is smaller than
+ * their sizes plus this cost. If the buffer of the areas is full the two areas are joined which cost the least.
+ * 0: join the areas only if the bounding box is smaller than their sizes (overlapping areas)*/
+#define LV_REFR_AREA_COST   4000
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -78,14 +94,45 @@ typedef int16_t lv_coord_t;
  * Can be in external SRAM too. */
 #  define LV_MEM_ADR          0
 
-/* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
+/* Not used: the built-in allocator always joins the adjacent free cells on free. Kept for compatibility. */
 #  define LV_MEM_AUTO_DEFRAG  1
+
+/* Add new memory regions (with `mmap`) if the work memory is full. Empty regions are given back.
+ * The size of a new region in bytes (larger if a larger memory is allocated). 0: disable*/
+#  define LV_MEM_REGION_SIZE  (256U * 1024U)
+
+/* Maximal size of the work memory and the added regions together in bytes*/
+#  define LV_MEM_MAX_SIZE     (16U * 1024U * 1024U)
+
+/* Allocate the small memories (objects, linked list nodes, ext. attributes) from slabs:
+ * chunks of same sized items which are allocated and freed quickly.
+ * Memories up to this size in bytes are allocated from the slabs. 0: disable*/
+#  define LV_MEM_SLAB_MAX     256
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
 #  define LV_MEM_CUSTOM_FREE    free         /*Wrapper to free*/
 #endif     /*LV_MEM_CUSTOM*/
 
+/* Trace `lv_mem_alloc`, `lv_mem_realloc` and `lv_mem_free`: record the call site, size and time of every call
+ * and keep the live memories per call site and per module (widget type or subsystem).
+ * See `lv_mem_trace_dump()`. 1: enable*/
+#define LV_MEM_TRACE 1
+#if LV_MEM_TRACE
+/* Number of the last calls kept in the event ring buffer*/
+#  define LV_MEM_TRACE_EVENT_CNT    1024
+
+/* Number of live memories which can be followed. The others are not counted in the tables*/
+#  define LV_MEM_TRACE_LIVE_CNT     4096
+
+/* Number of call sites (file and line) which can be followed*/
+#  define LV_MEM_TRACE_SITE_CNT     256
+
+/* Sample the heap's usage and fragmentation for the timeline with this period [ms].
+ * The period is doubled when the timeline is full so it always covers the whole uptime*/
+#  define LV_MEM_TRACE_PERIOD       60000
+#endif /*LV_MEM_TRACE*/
+
 /* Garbage Collector settings
  * Used if lvgl is binded to higher level language and the memory is managed by that language */
 #define LV_ENABLE_GC 0
@@ -193,6 +240,11 @@ typedef void * lv_img_decoder_user_data_t;
  * font's bitmaps */
 #define LV_ATTRIBUTE_LARGE_CONST
 
+/* Blend colors with SIMD instructions (NEON, SSE2 or AVX2) if the compiler enables them
+ * (e.g. `-mfpu=neon`, `-msse2`, `-mavx2`). Used with 32 bit and not swapped 16 bit colors.
+ * 0: always use the plain C code*/
+#define LV_USE_SIMD     1
+
 /*===================
  *  HAL settings
  *==================*/
@@ -206,6 +258,24 @@ uint32_t custom_tick_get(void);
 #define LV_TICK_CUSTOM_SYS_TIME_EXPR custom_tick_get()     /*Expression evaluating to current systime in ms*/
 #endif   /*LV_TICK_CUSTOM*/
 
+/* 1: read the tick from the POSIX monotonic clock (`clock_gettime(CLOCK_MONOTONIC)`).
+ * It doesn't drift or jump with the system time and `lv_tick_inc` is not needed.
+ * Ignored if `LV_TICK_CUSTOM` is 1. */
+#define LV_TICK_MONOTONIC  1
+
+/* 1: count the runs, the execution time, the start delay (jitter) and the missed periods of every lv_task.
+ * See `lv_task_get_stat()` and `lv_task_stat_dump()`. */
+#define LV_TASK_STATS      1
+
+/* 1: record the phases of the display refresh (joining the areas, drawing the areas, the objects by type,
+ * flushing and waiting for the flush), the input device reads and the lv_tasks with microsecond time stamps.
+ * See `lv_prof_dump()` to write them as a Chrome trace (open it in `chrome://tracing` or ui.perfetto.dev)*/
+#define LV_USE_PROF        1
+#if LV_USE_PROF
+/* Number of the last events kept in the ring buffer (power of 2)*/
+#  define LV_PROF_EVENT_CNT  8192
+#endif /*LV_USE_PROF*/
+
 typedef void * lv_disp_drv_user_data_t;             /*Type of user data in the display driver*/
 typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the input device driver*/
 
@@ -276,6 +346,21 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
 /*Always set a default font from the built-in fonts*/
 #define LV_FONT_DEFAULT        &lv_font_roboto_22
 
+/* Cache the letters decoded to 8 bit opacity maps. Shared by all fonts.
+ * Redrawing a cached letter needs no glyph lookup and bit unpacking.
+ * The maps are allocated with `lv_mem_alloc`. The least recently used letters are dropped
+ * to keep the cache below LV_GLYPH_CACHE_SIZE bytes and LV_GLYPH_CACHE_CNT letters.
+ * LV_GLYPH_CACHE_SIZE 0: disable the cache*/
+#define LV_GLYPH_CACHE_SIZE     (12U * 1024U)
+#define LV_GLYPH_CACHE_CNT      64
+
+/* Build direct lookup tables for fonts registered with `lv_font_fmt_txt_build_lut()`.
+ * The glyph IDs of the code points 0..255 and of the used part of the private use area (U+E000..U+F8FF)
+ * are read from a table instead of searching the character maps.
+ * The kerning values of the ASCII/Latin-1 letters are stored in a dense class-pair table too.
+ * The tables are allocated with `lv_mem_alloc` (~0.5..5 kB per font).*/
+#define LV_FONT_FMT_TXT_LUT     1
+
 /*Declare the type of the user data of fonts (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_font_user_data_t;
 
@@ -388,6 +473,9 @@ typedef void * lv_obj_user_data_t;
 
 /*Store extra some info in labels (12 bytes) to speed up drawing of very long texts*/
 #  define LV_LABEL_LONG_TXT_HINT          0
+
+/*Keep the line breaks and letter widths of labels to draw them without measuring the text again*/
+#  define LV_LABEL_LAYOUT_CACHE           1
 #endif
 
 /*LED (dependencies: -)*/
@@ -6,6 +6,9 @@
 /*********************
  *      INCLUDES
  *********************/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /*For memfd_create*/
+#endif
 #include "fbdev.h"
 #if USE_FBDEV || USE_BSD_FBDEV
 
@@ -16,6 +19,10 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <stdbool.h>
+#if FBDEV_FLUSH_THREAD
+#include <pthread.h>
+#endif
 
 #if USE_BSD_FBDEV
 #include <sys/fcntl.h>
@@ -33,6 +40,14 @@
 #define FBDEV_PATH  "/dev/fb0"
 #endif
 
+#ifndef FBDEV_FLUSH_THREAD
+#define FBDEV_FLUSH_THREAD  0
+#endif
+
+#ifndef FBDEV_PAGE_FLIP
+#define FBDEV_PAGE_FLIP  0
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -53,9 +68,28 @@ struct bsd_fb_fix_info{
     long int line_length;
 };
 
+#if FBDEV_FLUSH_THREAD
+/*A buffer waiting to be copied to the frame buffer by the flush thread*/
+typedef struct {
+    lv_disp_drv_t * drv;
+    lv_area_t area;
+    lv_color_t * color_p;
+    bool flip;          /*true: show the page `color_p` instead of copying it*/
+} fbdev_flush_job_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void fbdev_copy(const lv_area_t * area, lv_color_t * color_p);
+static void fbdev_start(void);
+#if FBDEV_PAGE_FLIP
+static void fbdev_pan(lv_color_t * color_p);
+#endif
+#if FBDEV_FLUSH_THREAD
+static bool fbdev_post(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p, bool flip);
+static void * fbdev_flush_thread(void * param);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -70,6 +104,19 @@ static struct fb_fix_screeninfo finfo;
 static char *fbp = 0;
 static long int screensize = 0;
 static int fbfd = 0;
+#if FBDEV_PAGE_FLIP
+static bool fb_stub = false;    /*The frame buffer is in memory, not on a device: don't use ioctl()*/
+#endif
+
+#if FBDEV_FLUSH_THREAD
+static pthread_t flush_thread;
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_job_cond = PTHREAD_COND_INITIALIZER;   /*Signaled when a job is posted*/
+static pthread_cond_t flush_done_cond = PTHREAD_COND_INITIALIZER;  /*Signaled when a job is ready*/
+static fbdev_flush_job_t flush_job;
+static bool flush_pending = false;
+static bool flush_run = false;
+#endif
 
 /**********************
  *      MACROS
@@ -135,16 +182,84 @@ void fbdev_init(void)
     fbp = (char *)mmap(0, screensize, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
     if((intptr_t)fbp == -1) {
         printf("Error: failed to map framebuffer device to memory");
+        fbp = NULL;
         return;
     }
     memset(fbp, 0, screensize);
 
     printf("The framebuffer device was mapped to memory successfully.\n");
 
+    fbdev_start();
+}
+
+#if FBDEV_PAGE_FLIP && USE_BSD_FBDEV == 0
+/**
+ * Initialize a stub frame buffer backed by a memfd instead of `FBDEV_PATH`.
+ * It has two pages so page flipping can be tested on Linux without a panel.
+ * Panning only changes `yoffset`, no ioctl() is called.
+ * @param xres horizontal resolution
+ * @param yres vertical resolution
+ */
+void fbdev_init_stub(uint32_t xres, uint32_t yres)
+{
+    fbfd = memfd_create("fbdev_stub", 0);
+    if(fbfd == -1) {
+        printf("Error: cannot create stub framebuffer");
+        return;
+    }
+
+    memset(&vinfo, 0, sizeof(vinfo));
+    memset(&finfo, 0, sizeof(finfo));
+    vinfo.xres = xres;
+    vinfo.yres = yres;
+    vinfo.xres_virtual = xres;
+    vinfo.yres_virtual = yres * 2;
+    vinfo.bits_per_pixel = sizeof(lv_color_t) * 8;
+    finfo.line_length = xres * sizeof(lv_color_t);
+    finfo.smem_len = finfo.line_length * vinfo.yres_virtual;
+
+    screensize = finfo.smem_len;
+    if(ftruncate(fbfd, screensize) == -1) {
+        printf("Error: cannot size stub framebuffer");
+        return;
+    }
+
+    fbp = (char *)mmap(0, screensize, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
+    if((intptr_t)fbp == -1) {
+        printf("Error: failed to map stub framebuffer to memory");
+        fbp = NULL;
+        return;
+    }
+    fb_stub = true;
+
+    printf("Stub framebuffer %dx%d, %dbpp\n", vinfo.xres, vinfo.yres, vinfo.bits_per_pixel);
+
+    fbdev_start();
+}
+#endif
+
+/**
+ * Get the resolution of the frame buffer
+ * @param width store the horizontal resolution here
+ * @param height store the vertical resolution here
+ */
+void fbdev_get_sizes(uint32_t * width, uint32_t * height)
+{
+    if(width) *width = vinfo.xres;
+    if(height) *height = vinfo.yres;
 }
 
 void fbdev_exit(void)
 {
+#if FBDEV_FLUSH_THREAD
+    if(flush_run) {
+        pthread_mutex_lock(&flush_mutex);
+        flush_run = false;
+        pthread_cond_signal(&flush_job_cond);
+        pthread_mutex_unlock(&flush_mutex);
+        pthread_join(flush_thread, NULL);
+    }
+#endif
     close(fbfd);
 }
 
@@ -165,6 +280,178 @@ void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color
         return;
     }
 
+#if FBDEV_FLUSH_THREAD
+    /*Hand the buffer to the flush thread. LittlevGL renders into the other buffer meanwhile
+     *and waits in `fbdev_wait` before touching this one again*/
+    if(fbdev_post(drv, area, color_p, false)) return;
+#endif
+
+    fbdev_copy(area, color_p);
+
+    lv_disp_flush_ready(drv);
+}
+
+/**
+ * Wait until the flush thread has finished copying the last buffer.
+ * Set as `wait_cb` of the display driver to avoid busy waiting in `lv_refr`.
+ * @param drv pointer to driver where this function belongs
+ */
+void fbdev_wait(lv_disp_drv_t * drv)
+{
+#if FBDEV_FLUSH_THREAD
+    pthread_mutex_lock(&flush_mutex);
+    while(flush_pending) pthread_cond_wait(&flush_done_cond, &flush_mutex);
+    pthread_mutex_unlock(&flush_mutex);
+#else
+    (void)drv; /*Unused*/
+#endif
+}
+
+#if FBDEV_PAGE_FLIP
+/**
+ * Use two pages of the frame buffer as true double buffer.
+ * LittlevGL renders directly into the hidden page and `fbdev_flip` pans the display to it.
+ * The virtual resolution is doubled if required. The buffer is not touched on failure.
+ * The display driver's `hor_res` and `ver_res` has to match `fbdev_get_sizes`.
+ * @param disp_buf pointer to a display buffer to initialize with the two pages
+ * @return true: page flipping is possible and `disp_buf` is initialized;
+ *         false: the frame buffer can't hold two pages in LittlevGL's color format
+ */
+bool fbdev_page_flip_init(lv_disp_buf_t * disp_buf)
+{
+#if USE_BSD_FBDEV
+    (void)disp_buf; /*Unused*/
+    return false;
+#else
+    if(fbp == NULL) return false;
+
+    /*LittlevGL draws with `hor_res` stride in its own color format*/
+    if(vinfo.bits_per_pixel != sizeof(lv_color_t) * 8 || finfo.line_length != vinfo.xres * sizeof(lv_color_t)) {
+        printf("Page flipping requires %d bpp without line padding\n", (int)sizeof(lv_color_t) * 8);
+        return false;
+    }
+
+    /*Ask for a virtual screen twice as high as the visible one*/
+    if(fb_stub == false && vinfo.yres_virtual < vinfo.yres * 2) {
+        struct fb_var_screeninfo v = vinfo;
+        v.xres_virtual = v.xres;
+        v.yres_virtual = v.yres * 2;
+        v.xoffset = 0;
+        v.yoffset = 0;
+        if(ioctl(fbfd, FBIOPUT_VSCREENINFO, &v) == -1 ||
+           ioctl(fbfd, FBIOGET_VSCREENINFO, &vinfo) == -1 ||
+           ioctl(fbfd, FBIOGET_FSCREENINFO, &finfo) == -1) {
+            printf("Error setting virtual resolution for page flipping\n");
+            return false;
+        }
+
+        /*The frame buffer memory might have grown, map it again*/
+        munmap(fbp, screensize);
+        screensize = finfo.smem_len;
+        fbp = (char *)mmap(0, screensize, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
+        if((intptr_t)fbp == -1) {
+            printf("Error: failed to map framebuffer device to memory");
+            fbp = NULL;
+            return false;
+        }
+        memset(fbp, 0, screensize);
+    }
+
+    long int page_size = finfo.line_length * vinfo.yres;
+    if(vinfo.yres_virtual < vinfo.yres * 2 || screensize < page_size * 2) {
+        printf("Not enough frame buffer memory for page flipping\n");
+        return false;
+    }
+
+    /*Render first into the page which is not visible*/
+    char * page0 = fbp;
+    char * page1 = fbp + page_size;
+    if(vinfo.yoffset >= vinfo.yres) lv_disp_buf_init(disp_buf, page0, page1, vinfo.xres * vinfo.yres);
+    else lv_disp_buf_init(disp_buf, page1, page0, vinfo.xres * vinfo.yres);
+
+    printf("Page flipping enabled\n");
+
+    return true;
+#endif
+}
+
+/**
+ * Show a fully rendered page of the frame buffer. Use as `flush_cb` with `fbdev_page_flip_init`.
+ * The display is panned to the page and it's reported ready only after the next vertical blank,
+ * when the other page is surely not scanned out any more.
+ * LittlevGL copies the changed areas to the other page after it.
+ * @param drv pointer to driver where this function belongs
+ * @param area the refreshed area (the whole screen)
+ * @param color_p pointer to the page to show
+ */
+void fbdev_flip(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+#if FBDEV_FLUSH_THREAD
+    /*Wait for the vertical blank in the flush thread, LittlevGL waits in `fbdev_wait`*/
+    if(fbdev_post(drv, area, color_p, true)) return;
+#else
+    (void)area; /*Unused*/
+#endif
+
+    fbdev_pan(color_p);
+
+    lv_disp_flush_ready(drv);
+}
+#endif /*FBDEV_PAGE_FLIP*/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Start the flush thread if enabled
+ */
+static void fbdev_start(void)
+{
+#if FBDEV_FLUSH_THREAD
+    flush_run = true;
+    if(pthread_create(&flush_thread, NULL, fbdev_flush_thread, NULL) != 0) {
+        printf("Error: cannot create flush thread, flushing synchronously\n");
+        flush_run = false;
+    }
+#endif
+}
+
+#if FBDEV_PAGE_FLIP
+/**
+ * Pan the display to a page and wait until it's shown.
+ * The pan is latched at the next vertical blank, so wait for it after the pan, not before.
+ * @param color_p pointer to the page to show
+ */
+static void fbdev_pan(lv_color_t * color_p)
+{
+#if USE_BSD_FBDEV == 0
+    vinfo.xoffset = 0;
+    vinfo.yoffset = ((char *)color_p - fbp) / finfo.line_length;
+
+    if(fb_stub) return;
+
+    if(ioctl(fbfd, FBIOPAN_DISPLAY, &vinfo) == -1) {
+        printf("Error panning display\n");
+        return;
+    }
+#ifdef FBIO_WAITFORVSYNC
+    uint32_t crtc = 0;
+    ioctl(fbfd, FBIO_WAITFORVSYNC, &crtc);
+#endif
+#else
+    (void)color_p; /*Unused*/
+#endif
+}
+#endif
+
+/**
+ * Copy a buffer to the marked area of the frame buffer
+ * @param area an area where to copy `color_p`. Has to be at least partially on the screen.
+ * @param color_p an array of pixel to copy to the `area` part of the screen
+ */
+static void fbdev_copy(const lv_area_t * area, lv_color_t * color_p)
+{
     /*Truncate the area to the screen*/
     int32_t act_x1 = area->x1 < 0 ? 0 : area->x1;
     int32_t act_y1 = area->y1 < 0 ? 0 : area->y1;
@@ -230,12 +517,67 @@ void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color
 
     //May be some direct update command is required
     //ret = ioctl(state->fd, FBIO_UPDATE, (unsigned long)((uintptr_t)rect));
+}
 
-    lv_disp_flush_ready(drv);
+#if FBDEV_FLUSH_THREAD
+/**
+ * Post a buffer to the flush thread
+ * @param drv pointer to driver where the buffer belongs
+ * @param area the area of `color_p`
+ * @param color_p the buffer to copy or the page to show
+ * @param flip true: pan the display to `color_p`; false: copy `color_p` to `area`
+ * @return true: posted; false: the flush thread is not running
+ */
+static bool fbdev_post(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p, bool flip)
+{
+    if(flush_run == false) return false;
+
+    pthread_mutex_lock(&flush_mutex);
+    while(flush_pending) pthread_cond_wait(&flush_done_cond, &flush_mutex);
+    flush_job.drv = drv;
+    lv_area_copy(&flush_job.area, area);
+    flush_job.color_p = color_p;
+    flush_job.flip = flip;
+    flush_pending = true;
+    pthread_cond_signal(&flush_job_cond);
+    pthread_mutex_unlock(&flush_mutex);
+
+    return true;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+/**
+ * Copy the posted buffers to the frame buffer (or show the posted pages) and report them ready
+ * @param param unused
+ */
+static void * fbdev_flush_thread(void * param)
+{
+    (void)param; /*Unused*/
+    fbdev_flush_job_t job;
+
+    pthread_mutex_lock(&flush_mutex);
+    while(1) {
+        while(flush_pending == false && flush_run) pthread_cond_wait(&flush_job_cond, &flush_mutex);
+        if(flush_pending == false) break; /*Exit requested and nothing left to copy*/
+
+        job = flush_job;
+        pthread_mutex_unlock(&flush_mutex);
+
+#if FBDEV_PAGE_FLIP
+        if(job.flip) fbdev_pan(job.color_p);
+        else fbdev_copy(&job.area, job.color_p);
+#else
+        fbdev_copy(&job.area, job.color_p);
+#endif
+
+        pthread_mutex_lock(&flush_mutex);
+        flush_pending = false;
+        lv_disp_flush_ready(job.drv);
+        pthread_cond_broadcast(&flush_done_cond);
+    }
+    pthread_mutex_unlock(&flush_mutex);
+
+    return NULL;
+}
+#endif
 
 #endif
@@ -41,8 +41,17 @@ extern "C" {
  * GLOBAL PROTOTYPES
  **********************/
 void fbdev_init(void);
+#if FBDEV_PAGE_FLIP && USE_BSD_FBDEV == 0
+void fbdev_init_stub(uint32_t xres, uint32_t yres);
+#endif
 void fbdev_exit(void);
+void fbdev_get_sizes(uint32_t * width, uint32_t * height);
 void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+void fbdev_wait(lv_disp_drv_t * drv);
+#if FBDEV_PAGE_FLIP
+bool fbdev_page_flip_init(lv_disp_buf_t * disp_buf);
+void fbdev_flip(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+#endif
 
 
 /**********************
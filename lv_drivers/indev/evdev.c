@@ -32,7 +32,7 @@ int map(int x, int in_min, int in_max, int out_min, int out_max);
 /**********************
  *  STATIC VARIABLES
  **********************/
-int evdev_fd;
+int evdev_fd = -1;
 int evdev_root_x;
 int evdev_root_y;
 int evdev_button;
@@ -109,6 +109,16 @@ bool evdev_set_file(char* dev_name)
 
      return true;
 }
+
+/**
+ * Get the file descriptor of the evdev device file
+ * @return the file descriptor to wait for input events on (e.g. with `epoll`) or -1 if not opened
+ */
+int evdev_get_fd(void)
+{
+    return evdev_fd;
+}
+
 /**
  * Get the current position and state of the evdev
  * @param data store the evdev data here
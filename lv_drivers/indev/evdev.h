@@ -53,6 +53,11 @@ bool evdev_init(void);
  *         false: the device file doesn't exist current system
  */
 bool evdev_set_file(char* dev_name);
+/**
+ * Get the file descriptor of the evdev device file
+ * @return the file descriptor to wait for input events on (e.g. with `epoll`) or -1 if not opened
+ */
+int evdev_get_fd(void);
 /**
  * Get the current position and state of the evdev
  * @param data store the evdev data here
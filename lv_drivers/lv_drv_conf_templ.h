@@ -224,6 +224,8 @@
 
 #if USE_FBDEV
 #  define FBDEV_PATH          "/dev/fb0"
+#  define FBDEV_FLUSH_THREAD  0   /*1: Copy to the frame buffer in a separate thread. Use with two draw buffers and `fbdev_wait`*/
+#  define FBDEV_PAGE_FLIP     0   /*1: Allow rendering directly into two pages of the frame buffer (see `fbdev_page_flip_init`)*/
 #endif
 
 /*-----------------------------------------
@@ -143,6 +143,15 @@ static void sysmon_task(lv_task_t * param)
             (int)mem_mon.total_size,
             (int)mem_mon.total_size - mem_mon.free_size, mem_mon.free_size, mem_mon.frag_pct);
 
+#if LV_MEM_TRACE
+    lv_mem_trace_monitor_t trace_mon;
+    lv_mem_trace_monitor(&trace_mon);
+    sprintf(buf_long, "%s\n"
+            "Peak: %d bytes\n"
+            "Failed: %d",
+            buf_long,
+            (int)trace_mon.peak_size, (int)trace_mon.fail_cnt);
+#endif
 #else
     sprintf(buf_long, "%s"LV_TXT_COLOR_CMD"%s MEMORY: N/A"LV_TXT_COLOR_CMD,
             buf_long,
@@ -1,5 +1,6 @@
 include $(LVGL_DIR)/lv_examples/lv_tests/lv_test_obj/lv_test_obj.mk
 include $(LVGL_DIR)/lv_examples/lv_tests/lv_test_stress/lv_test_stress.mk
+include $(LVGL_DIR)/lv_examples/lv_tests/lv_test_draw/lv_test_draw.mk
 include $(LVGL_DIR)/lv_examples/lv_tests/lv_test_theme/lv_test_theme.mk
 include $(LVGL_DIR)/lv_examples/lv_tests/lv_test_group/lv_test_group.mk
 include $(LVGL_DIR)/lv_examples/lv_tests/lv_test_objx/lv_test_arc/lv_test_arc.mk
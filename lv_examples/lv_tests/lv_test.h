@@ -62,6 +62,8 @@ extern "C" {
 
 #include "lv_test_stress/lv_test_stress.h"
 
+#include "lv_test_draw/lv_test_blend.h"
+
 /*********************
  *      DEFINES
  *********************/
@@ -0,0 +1,237 @@
+/**
+ * @file lv_test_blend.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "lv_test_blend.h"
+
+#if LV_USE_TESTS
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUF_LEN     300     /*Longer than a few vectors of any instruction set*/
+#define ALIGN_MAX   8       /*Start the buffers at 0..7 pixels from an aligned address*/
+#define CASE_CNT    8       /*Random cases for every opacity*/
+#define ROW_CASE_CNT 2000   /*Random letter rows for every bpp*/
+#define ROW_LEN_MAX 255     /*`box_w` is `uint8_t`*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t rnd(void);
+static void rnd_colors(lv_color_t * buf, uint32_t len);
+static void rnd_mask(lv_opa_t * buf, uint32_t len);
+static bool check(const char * name, const lv_color_t * act, const lv_color_t * ref, uint32_t len, lv_opa_t opa);
+static uint32_t test_letter_rows(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t rnd_state = 0x12345678;
+static lv_color_t dest[BUF_LEN + ALIGN_MAX];
+static lv_color_t dest_ref[BUF_LEN + ALIGN_MAX];
+static lv_color_t src[BUF_LEN + ALIGN_MAX];
+static lv_opa_t mask[BUF_LEN + ALIGN_MAX];
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Compare `lv_draw_blend_map`, `lv_draw_blend_fill` and `lv_draw_blend_mask` with their plain C
+ * reference versions. Random buffers with random lengths and misaligned starts are blended with every
+ * opacity in the configured color format (`LV_COLOR_DEPTH`).
+ * The rows of 1, 2, 4 and 8 bpp letters (`lv_draw_letter_row`) are compared with a naive bit extractor.
+ * @return number of mismatching cases (0: the optimized kernels are exact)
+ */
+uint32_t lv_test_blend_1(void)
+{
+    uint32_t err_cnt = 0;
+    uint32_t opa;
+    uint32_t c;
+
+    for(opa = 0; opa <= LV_OPA_COVER; opa++) {
+        for(c = 0; c < CASE_CNT; c++) {
+            uint32_t len = rnd() % (BUF_LEN + 1);
+            uint32_t dest_ofs = rnd() % ALIGN_MAX;
+            uint32_t src_ofs = rnd() % ALIGN_MAX;
+
+            /*Map*/
+            rnd_colors(dest, BUF_LEN + ALIGN_MAX);
+            rnd_colors(src, BUF_LEN + ALIGN_MAX);
+            memcpy(dest_ref, dest, sizeof(dest));
+            lv_draw_blend_map(dest + dest_ofs, src + src_ofs, len, opa);
+            lv_draw_blend_map_ref(dest_ref + dest_ofs, src + src_ofs, len, opa);
+            if(check("map", dest, dest_ref, BUF_LEN + ALIGN_MAX, opa) == false) err_cnt++;
+
+            /*Fill*/
+            lv_color_t color;
+            rnd_colors(&color, 1);
+            rnd_colors(dest, BUF_LEN + ALIGN_MAX);
+            memcpy(dest_ref, dest, sizeof(dest));
+            lv_draw_blend_fill(dest + dest_ofs, color, len, opa);
+            lv_draw_blend_fill_ref(dest_ref + dest_ofs, color, len, opa);
+            if(check("fill", dest, dest_ref, BUF_LEN + ALIGN_MAX, opa) == false) err_cnt++;
+
+            /*Mask*/
+            rnd_colors(&color, 1);
+            rnd_mask(mask, BUF_LEN + ALIGN_MAX);
+            rnd_colors(dest, BUF_LEN + ALIGN_MAX);
+            memcpy(dest_ref, dest, sizeof(dest));
+            lv_draw_blend_mask(dest + dest_ofs, color, mask + src_ofs, len);
+            lv_draw_blend_mask_ref(dest_ref + dest_ofs, color, mask + src_ofs, len);
+            if(check("mask", dest, dest_ref, BUF_LEN + ALIGN_MAX, opa) == false) err_cnt++;
+        }
+    }
+
+    err_cnt += test_letter_rows();
+
+#if LV_EX_PRINTF
+    printf("blend (%s, %d bit): %d mismatches\n", lv_draw_blend_get_isa(), LV_COLOR_DEPTH, (int)err_cnt);
+#endif
+
+    return err_cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * A small xorshift generator so the cases are the same on every run
+ * @return a pseudo random number
+ */
+static uint32_t rnd(void)
+{
+    rnd_state ^= rnd_state << 13;
+    rnd_state ^= rnd_state >> 17;
+    rnd_state ^= rnd_state << 5;
+    return rnd_state;
+}
+
+/**
+ * Fill a buffer with random colors
+ * @param buf pointer to a buffer
+ * @param len number of colors
+ */
+static void rnd_colors(lv_color_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        uint32_t r = rnd();
+        memcpy(&buf[i], &r, sizeof(lv_color_t));
+    }
+}
+
+/**
+ * Fill a buffer with random opacities. Fully transparent and fully opaque pixels are
+ * frequent, like on the edges and in the middle of letters.
+ * @param buf pointer to a buffer
+ * @param len number of opacities
+ */
+static void rnd_mask(lv_opa_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        uint32_t r = rnd();
+        switch(r & 0x3) {
+            case 0: buf[i] = LV_OPA_TRANSP; break;
+            case 1: buf[i] = LV_OPA_COVER; break;
+            default: buf[i] = r >> 8; break;
+        }
+    }
+}
+
+/**
+ * Compare the result of a blend function with the reference
+ * @param name name of the tested function
+ * @param act result of the tested function
+ * @param ref result of the reference function
+ * @param len number of colors to compare
+ * @param opa opacity used for blending
+ * @return true: the results are the same
+ */
+static bool check(const char * name, const lv_color_t * act, const lv_color_t * ref, uint32_t len, lv_opa_t opa)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        if(memcmp(&act[i], &ref[i], sizeof(lv_color_t)) != 0) {
+#if LV_EX_PRINTF
+            printf("blend %s mismatch at %d with opa %d\n", name, (int)i, opa);
+#else
+            (void)name; /*Unused*/
+            (void)opa;  /*Unused*/
+#endif
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Compare `lv_draw_letter_row` with a naive bit extractor on random glyph rows
+ * of every bpp, starting at every possible bit offset
+ * @return number of mismatching cases
+ */
+static uint32_t test_letter_rows(void)
+{
+    static const uint8_t bpp_list[] = {1, 2, 4, 8};
+    uint8_t map[ROW_LEN_MAX + 1];         /*Enough for `ROW_LEN_MAX` pixels of 8 bpp*/
+    lv_opa_t row[ROW_LEN_MAX + ALIGN_MAX]; /*Some more to see the writes after the row*/
+    lv_opa_t opa_table[16];
+    uint32_t err_cnt = 0;
+    uint32_t b;
+    uint32_t c;
+    uint32_t i;
+
+    for(b = 0; b < sizeof(bpp_list); b++) {
+        uint8_t bpp = bpp_list[b];
+        for(c = 0; c < ROW_CASE_CNT; c++) {
+            lv_coord_t len = rnd() % (ROW_LEN_MAX + 1);
+            uint8_t bit_ofs = bpp == 8 ? 0 : (rnd() % (8 / bpp)) * bpp;
+
+            for(i = 0; i < sizeof(map); i++) map[i] = rnd();
+            for(i = 0; i < sizeof(opa_table); i++) opa_table[i] = rnd();
+            memset(row, 0xA5, sizeof(row));
+
+            lv_draw_letter_row(bpp, map, bit_ofs, row, len, opa_table);
+
+            for(i = 0; i < sizeof(row); i++) {
+                lv_opa_t exp = 0xA5;
+                if(i < (uint32_t)len) {
+                    uint32_t bit = bit_ofs + i * bpp;
+                    uint8_t px = (map[bit >> 3] >> (8 - bpp - (bit & 0x7))) & ((1 << bpp) - 1);
+                    exp = bpp == 8 ? px : opa_table[px];
+                }
+
+                if(row[i] != exp) {
+#if LV_EX_PRINTF
+                    printf("letter row mismatch at %d with bpp %d, bit_ofs %d, len %d\n", (int)i, bpp, bit_ofs,
+                           (int)len);
+#endif
+                    err_cnt++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return err_cnt;
+}
+
+#endif /*LV_USE_TESTS*/
@@ -0,0 +1,57 @@
+/**
+ * @file lv_test_blend.h
+ *
+ */
+
+#ifndef LV_TEST_BLEND_H
+#define LV_TEST_BLEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "../../../lvgl/lvgl.h"
+#include "../../../lv_ex_conf.h"
+#endif
+
+#if LV_USE_TESTS
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Compare `lv_draw_blend_map`, `lv_draw_blend_fill` and `lv_draw_blend_mask` with their plain C
+ * reference versions. Random buffers with random lengths and misaligned starts are blended with every
+ * opacity in the configured color format (`LV_COLOR_DEPTH`).
+ * The rows of 1, 2, 4 and 8 bpp letters (`lv_draw_letter_row`) are compared with a naive bit extractor.
+ * @return number of mismatching cases (0: the optimized kernels are exact)
+ */
+uint32_t lv_test_blend_1(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_TESTS*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_TEST_BLEND_H*/
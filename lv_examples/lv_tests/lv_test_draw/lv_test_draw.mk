@@ -0,0 +1,6 @@
+CSRCS += lv_test_blend.c
+
+DEPPATH += --dep-path $(LVGL_DIR)/lv_examples/lv_tests/lv_test_draw
+VPATH += :$(LVGL_DIR)/lv_examples/lv_tests/lv_test_draw
+
+CFLAGS += "-I$(LVGL_DIR)/lv_examples/lv_tests/lv_test_draw"
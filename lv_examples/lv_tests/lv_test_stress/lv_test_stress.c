@@ -33,6 +33,7 @@ static lv_obj_t * all_obj_h;
 static lv_obj_t * alloc_label;
 static lv_obj_t * alloc_ta;
 static const char * mbox_btns[] = {"Ok", "Cancel", ""};
+static int16_t obj_tester_state;
 LV_IMG_DECLARE(img_flower_icon)
 
 /**********************
@@ -83,6 +84,33 @@ void lv_test_stress_1(void)
     lv_style_anim_create(&sa);
 }
 
+/**
+ * Measure the speed of creating and deleting objects.
+ * Run the object create/delete test of `lv_test_stress_1` a few times without waiting.
+ * `lv_test_stress_1` should be called first.
+ * @param cycle_cnt number of create/delete cycles
+ * @return the elapsed time in milliseconds
+ */
+uint32_t lv_test_stress_obj_speed(uint32_t cycle_cnt)
+{
+    uint32_t start = lv_tick_get();
+    uint32_t i;
+    for(i = 0; i < cycle_cnt; i++) {
+        /*Run the test until it starts again*/
+        do {
+            obj_mem_leak_tester(NULL);
+        } while(obj_tester_state != 0);
+    }
+
+    uint32_t elaps = lv_tick_elaps(start);
+
+#if LV_EX_PRINTF
+    printf("%d object create/delete cycles: %d ms\n", (int)cycle_cnt, (int)elaps);
+#endif
+
+    return elaps;
+}
+
 
 /**********************
  *   STATIC FUNCTIONS
@@ -110,7 +138,6 @@ static void obj_mem_leak_tester(lv_task_t * param)
     lv_coord_t hres = lv_disp_get_hor_res(NULL);
     lv_coord_t vres = lv_disp_get_ver_res(NULL);
 
-    static int16_t state = 0;
     lv_obj_t * obj;
     static lv_obj_t * page;
 
@@ -124,7 +151,7 @@ static void obj_mem_leak_tester(lv_task_t * param)
     a.playback_pause = 100;
     a.repeat_pause = 100;
 
-    switch(state) {
+    switch(obj_tester_state) {
         case 0:
             obj = lv_obj_create(all_obj_h, NULL);
             lv_obj_set_pos(obj, 10, 5);
@@ -243,40 +270,40 @@ static void obj_mem_leak_tester(lv_task_t * param)
             obj = lv_obj_get_child(lv_page_get_scrl(page), NULL);
             if(obj) lv_obj_del(obj);
             else  {
-                state = 24;
+                obj_tester_state = 24;
             }
             break;
         case 21:
             obj = lv_obj_get_child_back(lv_page_get_scrl(page), NULL);       /*Delete from the end too to be more random*/
             if(obj) {
                 lv_obj_del(obj);
-                state -= 2;     /*Go back to delete state*/
+                obj_tester_state -= 2;     /*Go back to delete state*/
             } else {
-                state = 24;
+                obj_tester_state = 24;
             }
             break;
         /*Remove object from 'all_obj_h'*/
         case 25:
             obj = lv_obj_get_child(all_obj_h, NULL);
             if(obj) lv_obj_del(obj);
-            else state = 29;
+            else obj_tester_state = 29;
             break;
         case 26:
             obj = lv_obj_get_child_back(all_obj_h, NULL);       /*Delete from the end too to be more random*/
             if(obj) {
                 lv_obj_del(obj);
-                state -= 2;     /*Go back to delete state*/
-            } else state = 29;
+                obj_tester_state -= 2;     /*Go back to delete state*/
+            } else obj_tester_state = 29;
             break;
 
         case 30:
-            state = -1;
+            obj_tester_state = -1;
             break;
         default:
             break;
     }
 
-    state ++;
+    obj_tester_state++;
 }
 
 
@@ -40,6 +40,15 @@ extern "C" {
  */
 void lv_test_stress_1(void);
 
+/**
+ * Measure the speed of creating and deleting objects.
+ * Run the object create/delete test of `lv_test_stress_1` a few times without waiting.
+ * `lv_test_stress_1` should be called first.
+ * @param cycle_cnt number of create/delete cycles
+ * @return the elapsed time in milliseconds
+ */
+uint32_t lv_test_stress_obj_speed(uint32_t cycle_cnt);
+
 /**********************
  *      MACROS
  **********************/
@@ -20,6 +20,7 @@ extern "C" {
 #include "src/lv_misc/lv_task.h"
 #include "src/lv_misc/lv_math.h"
 #include "src/lv_misc/lv_async.h"
+#include "src/lv_misc/lv_prof.h"
 
 #include "src/lv_hal/lv_hal.h"
 
@@ -61,6 +61,28 @@
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 #endif
 
+/* Number of threads rendering the invalidated areas in parallel (uses pthreads).
+ * Every area is cut into horizontal slices, one for each thread.
+ * 0 or 1: render only in the thread of `lv_task_handler`*/
+#ifndef LV_REFR_THREADS
+#define LV_REFR_THREADS     0
+#endif
+
+/* Don't draw the objects (or parts of them) which are hidden by opaque objects drawn later.
+ * The opaque areas are collected with `LV_DESIGN_COVER_CHK` before drawing an area.
+ * The statistics can be read with `lv_refr_cull_monitor()`*/
+#ifndef LV_REFR_OCCLUSION
+#define LV_REFR_OCCLUSION   0
+#endif
+
+/* Extra cost of refreshing one more area, in pixels (finding the objects, flushing, waking the threads).
+ * Two invalidated areas are refreshed together if their bounding box is smaller than
+ * their sizes plus this cost. If the buffer of the areas is full the two areas are joined which cost the least.
+ * 0: join the areas only if the bounding box is smaller than their sizes (overlapping areas)*/
+#ifndef LV_REFR_AREA_COST
+#define LV_REFR_AREA_COST   0
+#endif
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -98,10 +120,28 @@
 #  define LV_MEM_ADR          0
 #endif
 
-/* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
+/* Not used: the built-in allocator always joins the adjacent free cells on free. Kept for compatibility. */
 #ifndef LV_MEM_AUTO_DEFRAG
 #  define LV_MEM_AUTO_DEFRAG  1
 #endif
+
+/* Add new memory regions (with `mmap`) if the work memory is full. Empty regions are given back.
+ * The size of a new region in bytes (larger if a larger memory is allocated). 0: disable*/
+#ifndef LV_MEM_REGION_SIZE
+#  define LV_MEM_REGION_SIZE  0
+#endif
+
+/* Maximal size of the work memory and the added regions together in bytes*/
+#ifndef LV_MEM_MAX_SIZE
+#  define LV_MEM_MAX_SIZE     (1024U * 1024U)
+#endif
+
+/* Allocate the small memories (objects, linked list nodes, ext. attributes) from slabs:
+ * chunks of same sized items which are allocated and freed quickly.
+ * Memories up to this size in bytes are allocated from the slabs. 0: disable*/
+#ifndef LV_MEM_SLAB_MAX
+#  define LV_MEM_SLAB_MAX     0
+#endif
 #else       /*LV_MEM_CUSTOM*/
 #ifndef LV_MEM_CUSTOM_INCLUDE
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
@@ -114,6 +154,35 @@
 #endif
 #endif     /*LV_MEM_CUSTOM*/
 
+/* Trace `lv_mem_alloc`, `lv_mem_realloc` and `lv_mem_free`: record the call site, size and time of every call
+ * and keep the live memories per call site and per module (widget type or subsystem).
+ * See `lv_mem_trace_dump()`. 1: enable*/
+#ifndef LV_MEM_TRACE
+#define LV_MEM_TRACE 0
+#endif
+#if LV_MEM_TRACE
+/* Number of the last calls kept in the event ring buffer*/
+#ifndef LV_MEM_TRACE_EVENT_CNT
+#  define LV_MEM_TRACE_EVENT_CNT    256
+#endif
+
+/* Number of live memories which can be followed. The others are not counted in the tables*/
+#ifndef LV_MEM_TRACE_LIVE_CNT
+#  define LV_MEM_TRACE_LIVE_CNT     1024
+#endif
+
+/* Number of call sites (file and line) which can be followed*/
+#ifndef LV_MEM_TRACE_SITE_CNT
+#  define LV_MEM_TRACE_SITE_CNT     128
+#endif
+
+/* Sample the heap's usage and fragmentation for the timeline with this period [ms].
+ * The period is doubled when the timeline is full so it always covers the whole uptime*/
+#ifndef LV_MEM_TRACE_PERIOD
+#  define LV_MEM_TRACE_PERIOD       60000
+#endif
+#endif /*LV_MEM_TRACE*/
+
 /* Garbage Collector settings
  * Used if lvgl is binded to higher level language and the memory is managed by that language */
 #ifndef LV_ENABLE_GC
@@ -261,6 +330,13 @@
 #define LV_ATTRIBUTE_LARGE_CONST
 #endif
 
+/* Blend colors with SIMD instructions (NEON, SSE2 or AVX2) if the compiler enables them
+ * (e.g. `-mfpu=neon`, `-msse2`, `-mavx2`). Used with 32 bit and not swapped 16 bit colors.
+ * 0: always use the plain C code*/
+#ifndef LV_USE_SIMD
+#define LV_USE_SIMD     1
+#endif
+
 /*===================
  *  HAL settings
  *==================*/
@@ -279,6 +355,32 @@
 #endif
 #endif   /*LV_TICK_CUSTOM*/
 
+/* 1: read the tick from the POSIX monotonic clock (`clock_gettime(CLOCK_MONOTONIC)`).
+ * It doesn't drift or jump with the system time and `lv_tick_inc` is not needed.
+ * Ignored if `LV_TICK_CUSTOM` is 1. */
+#ifndef LV_TICK_MONOTONIC
+#define LV_TICK_MONOTONIC  0
+#endif
+
+/* 1: count the runs, the execution time, the start delay (jitter) and the missed periods of every lv_task.
+ * See `lv_task_get_stat()` and `lv_task_stat_dump()`. */
+#ifndef LV_TASK_STATS
+#define LV_TASK_STATS      0
+#endif
+
+/* 1: record the phases of the display refresh (joining the areas, drawing the areas, the objects by type,
+ * flushing and waiting for the flush), the input device reads and the lv_tasks with microsecond time stamps.
+ * See `lv_prof_dump()` to write them as a Chrome trace (open it in `chrome://tracing` or ui.perfetto.dev)*/
+#ifndef LV_USE_PROF
+#define LV_USE_PROF        0
+#endif
+#if LV_USE_PROF
+/* Number of the last events kept in the ring buffer (power of 2)*/
+#ifndef LV_PROF_EVENT_CNT
+#  define LV_PROF_EVENT_CNT  1024
+#endif
+#endif /*LV_USE_PROF*/
+
 
 /*================
  * Log settings
@@ -392,6 +494,27 @@
 #define LV_FONT_FMT_TXT_LARGE   0
 #endif
 
+/* Cache the letters decoded to 8 bit opacity maps. Shared by all fonts.
+ * Redrawing a cached letter needs no glyph lookup and bit unpacking.
+ * The maps are allocated with `lv_mem_alloc`. The least recently used letters are dropped
+ * to keep the cache below LV_GLYPH_CACHE_SIZE bytes and LV_GLYPH_CACHE_CNT letters.
+ * LV_GLYPH_CACHE_SIZE 0: disable the cache*/
+#ifndef LV_GLYPH_CACHE_SIZE
+#define LV_GLYPH_CACHE_SIZE     0
+#endif
+#ifndef LV_GLYPH_CACHE_CNT
+#define LV_GLYPH_CACHE_CNT      64
+#endif
+
+/* Build direct lookup tables for fonts registered with `lv_font_fmt_txt_build_lut()`.
+ * The glyph IDs of the code points 0..255 and of the used part of the private use area (U+E000..U+F8FF)
+ * are read from a table instead of searching the character maps.
+ * The kerning values of the ASCII/Latin-1 letters are stored in a dense class-pair table too.
+ * The tables are allocated with `lv_mem_alloc` (~0.5..5 kB per font).*/
+#ifndef LV_FONT_FMT_TXT_LUT
+#define LV_FONT_FMT_TXT_LUT     0
+#endif
+
 /*Declare the type of the user data of fonts (can be e.g. `void *`, `int`, `struct`)*/
 
 /*=================
@@ -556,6 +679,11 @@
 #ifndef LV_LABEL_LONG_TXT_HINT
 #  define LV_LABEL_LONG_TXT_HINT          0
 #endif
+
+/*Keep the line breaks and letter widths of labels to draw them without measuring the text again*/
+#ifndef LV_LABEL_LAYOUT_CACHE
+#  define LV_LABEL_LAYOUT_CACHE           1
+#endif
 #endif
 
 /*LED (dependencies: -)*/
@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "lv_group.h"
+#include "lv_refr.h"
 #if LV_USE_GROUP != 0
 #include "../lv_themes/lv_theme.h"
 #include <stddef.h>
@@ -398,15 +399,23 @@ void lv_group_set_wrap(lv_group_t * group, bool en)
  */
 lv_style_t * lv_group_mod_style(lv_group_t * group, const lv_style_t * style)
 {
+#if LV_REFR_THREADS > 1
+    /*The refresh threads get the focused style in parallel so each needs its own copy*/
+    static LV_REFR_THREAD_LOCAL lv_style_t style_tmp;
+    lv_style_t * style_mod = &style_tmp;
+#else
+    lv_style_t * style_mod = &group->style_tmp;
+#endif
+
     /*Load the current style. It will be modified by the callback*/
-    lv_style_copy(&group->style_tmp, style);
+    lv_style_copy(style_mod, style);
 
     if(group->editing) {
-        if(group->style_mod_edit_cb) group->style_mod_edit_cb(group, &group->style_tmp);
+        if(group->style_mod_edit_cb) group->style_mod_edit_cb(group, style_mod);
     } else {
-        if(group->style_mod_cb) group->style_mod_cb(group, &group->style_tmp);
+        if(group->style_mod_cb) group->style_mod_cb(group, style_mod);
     }
-    return &group->style_tmp;
+    return style_mod;
 }
 
 /**
@@ -64,7 +64,7 @@ typedef struct _lv_group_t
     lv_group_style_mod_cb_t style_mod_cb;      /**< A function to modifies the style of the focused object*/
     lv_group_style_mod_cb_t style_mod_edit_cb; /**< A function which modifies the style of the edited object*/
     lv_group_focus_cb_t focus_cb;              /**< A function to call when a new object is focused (optional)*/
-    lv_style_t style_tmp;                      /**< Stores the modified style of the focused object */
+    lv_style_t style_tmp;                      /**< Stores the modified style of the focused object (a thread local copy is used if `LV_REFR_THREADS > 1`) */
 #if LV_USE_USER_DATA
     lv_group_user_data_t user_data;
 #endif
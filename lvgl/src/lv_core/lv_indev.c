@@ -15,6 +15,7 @@
 #include "../lv_core/lv_refr.h"
 #include "../lv_misc/lv_task.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_prof.h"
 
 /*********************
  *      DEFINES
@@ -88,7 +89,9 @@ void lv_indev_read_task(lv_task_t * task)
     bool more_to_read;
     do {
         /*Read the data*/
+        LV_PROF_START(prof_start);
         more_to_read = lv_indev_read(indev_act, &data);
+        LV_PROF_STOP(prof_start, LV_PROF_CAT_INDEV, "read");
 
         /*The active object might deleted even in the read function*/
         indev_proc_reset_query_handler(indev_act);
@@ -116,6 +119,15 @@ void lv_indev_read_task(lv_task_t * task)
         indev_proc_reset_query_handler(indev_act);
     } while(more_to_read);
 
+    /*Event driven devices need to be read periodically only to detect long press and drag throw*/
+    if(indev_act->driver.read_on_event && indev_act->proc.state == LV_INDEV_STATE_REL) {
+        bool drag_in_prog = false;
+        if(indev_act->driver.type == LV_INDEV_TYPE_POINTER || indev_act->driver.type == LV_INDEV_TYPE_BUTTON) {
+            drag_in_prog = indev_act->proc.types.pointer.drag_in_prog ? true : false;
+        }
+        if(!drag_in_prog) lv_task_pause(task);
+    }
+
     /*End of indev processing, so no act indev*/
     indev_act     = NULL;
     indev_obj_act = NULL;
@@ -316,6 +328,20 @@ lv_task_t * lv_indev_get_read_task(lv_disp_t * indev)
     return indev->refr_task;
 }
 
+/**
+ * Read an input device in the next `lv_task_handler` call without waiting for the read period.
+ * Call it when new data is available, e.g. the device's file became readable.
+ * Required to read the devices with `read_on_event` set in the driver.
+ * @param indev pointer to an input device
+ */
+void lv_indev_trig_read(lv_indev_t * indev)
+{
+    if(!indev || !indev->driver.read_task) return;
+
+    lv_task_resume(indev->driver.read_task);
+    lv_task_ready(indev->driver.read_task);
+}
+
 /**
  * Gets a pointer to the currently active object in the currently processed input device.
  * @return pointer to currently active object or NULL if no active object
@@ -141,6 +141,14 @@ void lv_indev_wait_release(lv_indev_t * indev);
  */
 lv_task_t * lv_indev_get_read_task(lv_disp_t * indev);
 
+/**
+ * Read an input device in the next `lv_task_handler` call without waiting for the read period.
+ * Call it when new data is available, e.g. the device's file became readable.
+ * Required to read the devices with `read_on_event` set in the driver.
+ * @param indev pointer to an input device
+ */
+void lv_indev_trig_read(lv_indev_t * indev);
+
 /**
  * Gets a pointer to the currently active object in indev proc functions.
  * NULL if no object is currently being handled or if groups aren't used.
@@ -27,6 +27,11 @@
 #include LV_GC_INCLUDE
 #endif /* LV_ENABLE_GC */
 
+/*Define the real function here, not the tracing one*/
+#if LV_MEM_TRACE
+#undef lv_obj_allocate_ext_attr
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -61,6 +66,9 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
 static bool lv_initialized = false;
 static lv_event_temp_data_t * event_temp_data_head;
 static const void * event_act_data;
+static uint16_t ext_size_reserved; /*Ext. data size of the created object (see `lv_obj_reserve_ext_attr`)*/
+static LV_REFR_THREAD_LOCAL const lv_obj_t * style_tmp_obj; /*See `lv_obj_set_style_tmp`*/
+static LV_REFR_THREAD_LOCAL const lv_style_t * style_tmp_p;
 
 /**********************
  *      MACROS
@@ -114,6 +122,10 @@ void lv_init(void)
     lv_img_decoder_init();
     lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
 
+#if LV_GLYPH_CACHE_SIZE != 0
+    lv_glyph_cache_init();
+#endif
+
     lv_initialized = true;
     LV_LOG_INFO("lv_init ready");
 }
@@ -145,6 +157,9 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj = lv_ll_ins_head(&disp->scr_ll);
         lv_mem_assert(new_obj);
         if(new_obj == NULL) return NULL;
+#if LV_MEM_TRACE
+        lv_mem_trace_set_owner(new_obj, __FILE__, __LINE__);
+#endif
 
         new_obj->par = NULL; /*Screens has no a parent*/
         lv_ll_init(&(new_obj->child_ll), sizeof(lv_obj_t));
@@ -218,6 +233,9 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj = lv_ll_ins_head(&parent->child_ll);
         lv_mem_assert(new_obj);
         if(new_obj == NULL) return NULL;
+#if LV_MEM_TRACE
+        lv_mem_trace_set_owner(new_obj, __FILE__, __LINE__);
+#endif
 
         new_obj->par = parent; /*Set the parent*/
         lv_ll_init(&(new_obj->child_ll), sizeof(lv_obj_t));
@@ -1134,6 +1152,19 @@ void lv_obj_refresh_style(lv_obj_t * obj)
     lv_obj_invalidate(obj);
 }
 
+/**
+ * Draw an object with a temporal style. Only the calling thread sees the new style
+ * so the other refresh threads can draw the object in parallel.
+ * Used by the design functions instead of changing `obj->style_p` around the ancestor's design.
+ * @param obj pointer to an object
+ * @param style pointer to the temporal style or NULL to use the object's own style again
+ */
+void lv_obj_set_style_tmp(const lv_obj_t * obj, const lv_style_t * style)
+{
+    style_tmp_obj = style ? obj : NULL;
+    style_tmp_p   = style;
+}
+
 /**
  * Notify all object if a style is modified
  * @param style pointer to a style. Only the objects with this style will be notified
@@ -1436,11 +1467,49 @@ void lv_obj_set_design_cb(lv_obj_t * obj, lv_design_cb_t design_cb)
  */
 void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size)
 {
+    /*Allocate the final size at once if it's known*/
+    if(obj->ext_attr == NULL && ext_size < ext_size_reserved) ext_size = ext_size_reserved;
+    ext_size_reserved = 0;
+
+    /*The ancestor types allocate smaller ext. data so keep it if it's large enough*/
+    if(lv_mem_get_size(obj->ext_attr) >= ext_size) return obj->ext_attr;
+
     obj->ext_attr = lv_mem_realloc(obj->ext_attr, ext_size);
 
     return (void *)obj->ext_attr;
 }
 
+/**
+ * Set the final ext. data size of the next created object.
+ * Call it in `lv_..._create` before creating the ancestor type to allocate the ext. data only once.
+ * @param ext_size size of the ext. data of the created type
+ */
+void lv_obj_reserve_ext_attr(uint16_t ext_size)
+{
+    /*The descendant types are called first and they have the largest size*/
+    if(ext_size > ext_size_reserved) ext_size_reserved = ext_size;
+}
+
+#if LV_MEM_TRACE
+/**
+ * Give an object and its ext. data to a call site in the memory trace.
+ * Called by `lv_obj_allocate_ext_attr` so they belong to the created type, not to `lv_ll` or an ancestor.
+ * @param ext pointer to the ext. data of `obj`
+ * @param obj pointer to an object
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return `ext`
+ */
+void * lv_obj_trace_ext_attr(void * ext, const lv_obj_t * obj, const char * file, uint32_t line)
+{
+    /*The object is the data of a node in its parent's (or the display's) list*/
+    lv_mem_trace_set_owner(obj, file, line);
+    lv_mem_trace_set_owner(ext, file, line);
+
+    return ext;
+}
+#endif
+
 /**
  * Send a 'LV_SIGNAL_REFR_EXT_SIZE' signal to the object
  * @param obj pointer to an object
@@ -1797,7 +1866,7 @@ lv_coord_t lv_obj_get_ext_draw_pad(const lv_obj_t * obj)
  */
 const lv_style_t * lv_obj_get_style(const lv_obj_t * obj)
 {
-    const lv_style_t * style_act = obj->style_p;
+    const lv_style_t * style_act = obj == style_tmp_obj ? style_tmp_p : obj->style_p;
     if(style_act == NULL) {
         lv_obj_t * par = obj->par;
 
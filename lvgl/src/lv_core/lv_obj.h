@@ -441,6 +441,13 @@ void lv_obj_set_style(lv_obj_t * obj, const lv_style_t * style);
  */
 void lv_obj_refresh_style(lv_obj_t * obj);
 
+/**
+ * Draw an object with a temporal style. Only the calling thread sees the new style.
+ * @param obj pointer to an object
+ * @param style pointer to the temporal style or NULL to use the object's own style again
+ */
+void lv_obj_set_style_tmp(const lv_obj_t * obj, const lv_style_t * style);
+
 /**
  * Notify all object if a style is modified
  * @param style pointer to a style. Only the objects with this style will be notified
@@ -610,6 +617,26 @@ void lv_obj_set_design_cb(lv_obj_t * obj, lv_design_cb_t design_cb);
  */
 void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size);
 
+/**
+ * Set the final ext. data size of the next created object.
+ * Call it in `lv_..._create` before creating the ancestor type to allocate the ext. data only once.
+ * @param ext_size size of the ext. data of the created type
+ */
+void lv_obj_reserve_ext_attr(uint16_t ext_size);
+
+#if LV_MEM_TRACE
+/**
+ * Give an object and its ext. data to a call site in the memory trace.
+ * Called by `lv_obj_allocate_ext_attr` so they belong to the created type, not to `lv_ll` or an ancestor.
+ * @param ext pointer to the ext. data of `obj`
+ * @param obj pointer to an object
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return `ext`
+ */
+void * lv_obj_trace_ext_attr(void * ext, const lv_obj_t * obj, const char * file, uint32_t line);
+#endif
+
 /**
  * Send a 'LV_SIGNAL_REFR_EXT_SIZE' signal to the object
  * @param obj pointer to an object
@@ -980,6 +1007,12 @@ bool lv_obj_is_focused(const lv_obj_t * obj);
  */
 #define LV_EVENT_CB_DECLARE(name) void name(lv_obj_t * obj, lv_event_t e)
 
+/*The types allocate their ext. data last in `lv_..._create` so give the object to them in the memory trace*/
+#if LV_MEM_TRACE
+#define lv_obj_allocate_ext_attr(obj, ext_size)                                                                        \
+    lv_obj_trace_ext_attr(lv_obj_allocate_ext_attr(obj, ext_size), obj, __FILE__, __LINE__)
+#endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
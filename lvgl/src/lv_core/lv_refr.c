@@ -14,33 +14,80 @@
 #include "../lv_misc/lv_task.h"
 #include "../lv_misc/lv_mem.h"
 #include "../lv_misc/lv_gc.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_prof.h"
 #include "../lv_draw/lv_draw.h"
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
 #endif /* LV_ENABLE_GC */
 
+#if LV_REFR_THREADS > 1
+#include <pthread.h>
+#endif
+
 /*********************
  *      DEFINES
  *********************/
 /* Draw translucent random colored areas on the invalidated (redrawn) areas*/
 #define MASK_AREA_DEBUG 0
 
+/* Don't give less rows than this to a refresh thread. Waking the threads costs more on small areas*/
+#define REFR_SLICE_MIN_ROWS 8
+
+/* Max. number of opaque areas collected in an area to draw. The largest ones are kept*/
+#define REFR_COVER_MAX 16
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_REFR_THREADS > 1
+/*A refresh thread drawing a horizontal slice of the area being refreshed*/
+typedef struct
+{
+    pthread_t thread;
+    lv_area_t mask; /*The slice to draw*/
+    lv_draw_arena_t * arena; /*Scratch memory for drawing the slice*/
+    bool has_job;
+} lv_refr_worker_t;
+#endif
+
+#if LV_REFR_OCCLUSION
+/*An area fully covered by an opaque object*/
+typedef struct
+{
+    lv_area_t area;
+    uint32_t draw_id; /*Drawing order of the object. Only the objects drawn earlier are hidden by it*/
+} lv_refr_cover_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static void lv_inv_join_cheapest(lv_disp_t * disp, const lv_area_t * area_p);
+static int32_t join_gain(const lv_area_t * a1_p, const lv_area_t * a2_p, lv_area_t * res_p);
 static void lv_refr_areas(void);
 static void lv_refr_area(const lv_area_t * area_p);
 static void lv_refr_area_part(const lv_area_t * area_p);
+static void lv_refr_mask(const lv_area_t * mask_p);
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void lv_refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p);
 static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p);
 static void lv_refr_vdb_flush(void);
+static void lv_refr_wait_flush(lv_disp_buf_t * vdb);
+#if LV_USE_PROF
+static const char * prof_obj_type(lv_obj_t * obj);
+#endif
+#if LV_REFR_THREADS > 1
+static void lv_refr_mask_parallel(const lv_area_t * mask_p);
+static void * lv_refr_worker(void * param);
+#endif
+#if LV_REFR_OCCLUSION
+static void cover_add(lv_obj_t * obj, const lv_area_t * mask_p, uint32_t draw_id);
+static bool cover_clip(lv_area_t * res_p, const lv_area_t * mask_p, uint32_t draw_id);
+static bool cover_hides(const lv_area_t * area_p, uint32_t draw_id);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -48,6 +95,27 @@ static void lv_refr_vdb_flush(void);
 static uint32_t px_num;
 static lv_disp_t * disp_refr; /*Display being refreshed*/
 
+#if LV_REFR_THREADS > 1
+static lv_refr_worker_t workers[LV_REFR_THREADS - 1]; /*The calling thread draws a slice too*/
+static uint8_t worker_cnt;
+static pthread_mutex_t worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t worker_start_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t worker_done_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t worker_gen; /*Incremented when new jobs are given to the workers*/
+static uint8_t worker_busy_cnt;
+static pthread_mutex_t design_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#if LV_REFR_OCCLUSION
+static LV_REFR_THREAD_LOCAL lv_refr_cover_t covers[REFR_COVER_MAX]; /*Opaque areas in the area being drawn*/
+static LV_REFR_THREAD_LOCAL uint8_t cover_cnt;
+static LV_REFR_THREAD_LOCAL uint32_t draw_id_act;          /*Counts the objects in drawing order*/
+static LV_REFR_THREAD_LOCAL bool cover_collect;            /*true: only collect the opaque areas*/
+static LV_REFR_THREAD_LOCAL lv_refr_cull_monitor_t cull_act; /*Statistics of the area being drawn*/
+static lv_refr_cull_monitor_t cull_frame;                  /*Statistics of the refresh in progress*/
+static lv_refr_cull_monitor_t cull_last;                   /*Statistics of the last refresh*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -61,7 +129,19 @@ static lv_disp_t * disp_refr; /*Display being refreshed*/
  */
 void lv_refr_init(void)
 {
-    /*Nothing to do*/
+#if LV_REFR_THREADS > 1
+    /*Start the refresh threads. If some can't be created use less*/
+    if(worker_cnt != 0) return;
+    uint8_t i;
+    for(i = 0; i < LV_REFR_THREADS - 1; i++) {
+        workers[i].has_job = false;
+        if(pthread_create(&workers[i].thread, NULL, lv_refr_worker, &workers[i]) != 0) {
+            LV_LOG_WARN("lv_refr_init: can't create refresh thread");
+            break;
+        }
+        worker_cnt++;
+    }
+#endif
 }
 
 /**
@@ -115,6 +195,9 @@ void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 
     /*The area is truncated to the screen*/
     if(suc != false) {
+        /*The refresh task is paused while there is nothing to redraw*/
+        if(disp->refr_task) lv_task_resume(disp->refr_task);
+
         if(disp->driver.rounder_cb) disp->driver.rounder_cb(&disp->driver, &com_area);
 
         /*Save only if this area is not in one of the saved areas*/
@@ -123,14 +206,22 @@ void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
             if(lv_area_is_in(&com_area, &disp->inv_areas[i]) != false) return;
         }
 
+        /*If a saved area is in this area replace it.
+         * (The saved areas are modified only in place to keep `lv_disp_pop_from_inv_buf` working)*/
+        for(i = 0; i < disp->inv_p; i++) {
+            if(lv_area_is_in(&disp->inv_areas[i], &com_area) != false) {
+                lv_area_copy(&disp->inv_areas[i], &com_area);
+                return;
+            }
+        }
+
         /*Save the area*/
         if(disp->inv_p < LV_INV_BUF_SIZE) {
             lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
-        } else { /*If no place for the area add the screen*/
-            disp->inv_p = 0;
-            lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+            disp->inv_p++;
+        } else { /*If no place for the area join two areas to make room*/
+            lv_inv_join_cheapest(disp, &com_area);
         }
-        disp->inv_p++;
     }
 }
 
@@ -154,6 +245,41 @@ void lv_refr_set_disp_refreshing(lv_disp_t * disp)
     disp_refr = disp;
 }
 
+/**
+ * Lock the objects against the other refresh threads.
+ * Design functions which temporarily modify their object (e.g. a field of the ext. data) should
+ * call it before the modification and `lv_refr_design_unlock` after restoring the object.
+ * To draw with a temporal style use `lv_obj_set_style_tmp` instead.
+ * Does nothing if `LV_REFR_THREADS <= 1`
+ */
+void lv_refr_design_lock(void)
+{
+#if LV_REFR_THREADS > 1
+    pthread_mutex_lock(&design_mutex);
+#endif
+}
+
+/**
+ * Release the lock taken by `lv_refr_design_lock`
+ */
+void lv_refr_design_unlock(void)
+{
+#if LV_REFR_THREADS > 1
+    pthread_mutex_unlock(&design_mutex);
+#endif
+}
+
+#if LV_REFR_OCCLUSION
+/**
+ * Give information about the hidden objects in the last refresh
+ * @param mon_p pointer to a monitor variable to store the result
+ */
+void lv_refr_cull_monitor(lv_refr_cull_monitor_t * mon_p)
+{
+    *mon_p = cull_last;
+}
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param task pointer to the task itself
@@ -165,8 +291,15 @@ void lv_disp_refr_task(lv_task_t * task)
     uint32_t start = lv_tick_get();
 
     disp_refr = task->user_data;
+    lv_draw_arena_set_act(&disp_refr->draw_arena[0]);
 
+#if LV_REFR_OCCLUSION
+    memset(&cull_frame, 0, sizeof(cull_frame));
+#endif
+
+    LV_PROF_START(prof_join);
     lv_refr_join_area();
+    LV_PROF_STOP(prof_join, LV_PROF_CAT_REFR, "join_area");
 
     lv_refr_areas();
 
@@ -183,9 +316,9 @@ void lv_disp_refr_task(lv_task_t * task)
             /* With true double buffering the flushing should be only the address change of the
              * current frame buffer. Wait until the address change is ready and copy the changed
              * content to the other frame buffer (new active VDB) to keep the buffers synchronized*/
-            while(vdb->flushing)
-                ;
+            lv_refr_wait_flush(vdb);
 
+            LV_PROF_START(prof_copy);
             uint8_t * buf_act = (uint8_t *)vdb->buf_act;
             uint8_t * buf_ina = (uint8_t *)vdb->buf_act == vdb->buf1 ? vdb->buf2 : vdb->buf1;
 
@@ -204,6 +337,7 @@ void lv_disp_refr_task(lv_task_t * task)
                     }
                 }
             }
+            LV_PROF_STOP(prof_copy, LV_PROF_CAT_FLUSH, "copy");
         } /*End of true double buffer handling*/
 
         /*Clean up*/
@@ -211,13 +345,23 @@ void lv_disp_refr_task(lv_task_t * task)
         memset(disp_refr->inv_area_joined, 0, sizeof(disp_refr->inv_area_joined));
         disp_refr->inv_p = 0;
 
+#if LV_REFR_OCCLUSION
+        cull_last = cull_frame;
+#endif
+
         /*Call monitor cb if present*/
         if(disp_refr->driver.monitor_cb) {
             disp_refr->driver.monitor_cb(&disp_refr->driver, lv_tick_elaps(start), px_num);
         }
     }
 
-    lv_draw_free_buf();
+    /*Keep the scratch memory for the next frame*/
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_ARENA_CNT; i++) lv_draw_arena_reset(&disp_refr->draw_arena[i]);
+    lv_draw_arena_set_act(NULL);
+
+    /*Sleep until an area is invalidated (see `lv_inv_area`)*/
+    if(disp_refr->inv_p == 0) lv_task_pause(task);
 
     LV_LOG_TRACE("lv_refr_task: ready");
 }
@@ -227,40 +371,93 @@ void lv_disp_refr_task(lv_task_t * task)
  **********************/
 
 /**
- * Join the areas which has got common parts
+ * Join the areas if it's cheaper to refresh them together (see `LV_REFR_AREA_COST`).
+ * Always the pair with the largest gain is joined first.
  */
 static void lv_refr_join_area(void)
 {
     uint32_t join_from;
     uint32_t join_in;
     lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
-
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
+    while(1) {
+        int32_t best_gain = 0;
+        uint32_t best_in  = 0;
+        uint32_t best_from = 0;
+        for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
+            if(disp_refr->inv_area_joined[join_in] != 0) continue;
+
+            /*Check all areas to join them in 'join_in'*/
+            for(join_from = join_in + 1; join_from < disp_refr->inv_p; join_from++) {
+                /*Handle only unjoined areas*/
+                if(disp_refr->inv_area_joined[join_from] != 0) continue;
+
+                int32_t gain = join_gain(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from], &joined_area);
+                if(gain > best_gain) {
+                    best_gain = gain;
+                    best_in   = join_in;
+                    best_from = join_from;
+                }
             }
+        }
 
-            /*Check if the areas are on each other*/
-            if(lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
-            }
+        /*Stop if no joining is worth it*/
+        if(best_gain <= 0) break;
 
-            lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+        lv_area_join(&disp_refr->inv_areas[best_in], &disp_refr->inv_areas[best_in], &disp_refr->inv_areas[best_from]);
 
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+        /*Mark 'join_form' is joined into 'join_in'*/
+        disp_refr->inv_area_joined[best_from] = 1;
+    }
+}
 
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+/**
+ * Make room for a new area in the full buffer of invalidated areas.
+ * Join the two areas (the new one included) which are the cheapest to refresh together.
+ * @param disp pointer to display with full `inv_areas`
+ * @param area_p the new area to save
+ */
+static void lv_inv_join_cheapest(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    lv_area_t joined_area;
+    int32_t best_gain = INT32_MIN;
+    uint32_t best_1   = 0;
+    uint32_t best_2   = 0;
+    uint32_t i;
+    uint32_t j;
+
+    /*The index `inv_p` means the new area*/
+    for(i = 0; i < disp->inv_p; i++) {
+        for(j = i + 1; j <= disp->inv_p; j++) {
+            const lv_area_t * a2_p = j == disp->inv_p ? area_p : &disp->inv_areas[j];
+            int32_t gain = join_gain(&disp->inv_areas[i], a2_p, &joined_area);
+            if(gain > best_gain) {
+                best_gain = gain;
+                best_1    = i;
+                best_2    = j;
             }
         }
     }
+
+    if(best_2 == disp->inv_p) {
+        lv_area_join(&disp->inv_areas[best_1], &disp->inv_areas[best_1], area_p);
+    } else {
+        lv_area_join(&disp->inv_areas[best_1], &disp->inv_areas[best_1], &disp->inv_areas[best_2]);
+        lv_area_copy(&disp->inv_areas[best_2], area_p);
+    }
+}
+
+/**
+ * Calculate how much is saved by refreshing two areas together
+ * @param a1_p pointer to an area
+ * @param a2_p pointer to an other area
+ * @param res_p store the joined area here
+ * @return the saved cost in pixels (negative if the joined area costs more)
+ */
+static int32_t join_gain(const lv_area_t * a1_p, const lv_area_t * a2_p, lv_area_t * res_p)
+{
+    lv_area_join(res_p, a1_p, a2_p);
+    return (int32_t)lv_area_get_size(a1_p) + (int32_t)lv_area_get_size(a2_p) + LV_REFR_AREA_COST -
+           (int32_t)lv_area_get_size(res_p);
 }
 
 /**
@@ -373,39 +570,161 @@ static void lv_refr_area(const lv_area_t * area_p)
  */
 static void lv_refr_area_part(const lv_area_t * area_p)
 {
+    LV_PROF_START(prof_start);
 
     lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
 
     /*In non double buffered mode, before rendering the next part wait until the previous image is
      * flushed*/
     if(lv_disp_is_double_buf(disp_refr) == false) {
-        while(vdb->flushing)
-            ;
+        lv_refr_wait_flush(vdb);
     }
 
-    lv_obj_t * top_p;
-
     /*Get the new mask from the original area and the act. VDB
      It will be a part of 'area_p'*/
     lv_area_t start_mask;
     lv_area_intersect(&start_mask, area_p, &vdb->area);
 
+#if LV_REFR_THREADS > 1
+    lv_refr_mask_parallel(&start_mask);
+#else
+    lv_refr_mask(&start_mask);
+#endif
+
+    /* In true double buffered mode flush only once when all areas were rendered.
+     * In normal mode flush after every area */
+    if(lv_disp_is_true_double_buf(disp_refr) == false) {
+        lv_refr_vdb_flush();
+    }
+
+    LV_PROF_STOP(prof_start, LV_PROF_CAT_REFR, "area_part");
+}
+
+/**
+ * Draw everything on an area of the VDB
+ * @param mask_p pointer to an area on the act. VDB
+ */
+static void lv_refr_mask(const lv_area_t * mask_p)
+{
+    LV_PROF_START(prof_start);
+
     /*Get the most top object which is not covered by others*/
-    top_p = lv_refr_get_top_obj(&start_mask, lv_disp_get_scr_act(disp_refr));
+    lv_obj_t * top_p = lv_refr_get_top_obj(mask_p, lv_disp_get_scr_act(disp_refr));
+
+#if LV_REFR_OCCLUSION
+    /*Walk the objects like when drawing but only collect the areas covered by opaque objects.
+     * So it's known which objects will be hidden by the ones drawn later*/
+    memset(&cull_act, 0, sizeof(cull_act));
+    cover_cnt     = 0;
+    draw_id_act   = 0;
+    cover_collect = true;
+    lv_refr_obj_and_children(top_p, mask_p);
+    lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), mask_p);
+    lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), mask_p);
+
+    draw_id_act   = 0;
+    cover_collect = false;
+#endif
 
     /*Do the refreshing from the top object*/
-    lv_refr_obj_and_children(top_p, &start_mask);
+    lv_refr_obj_and_children(top_p, mask_p);
 
     /*Also refresh top and sys layer unconditionally*/
-    lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), &start_mask);
-    lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), &start_mask);
+    lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), mask_p);
+    lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), mask_p);
+
+#if LV_REFR_OCCLUSION
+    cull_act.cover_cnt = cover_cnt;
+
+    /*The refresh threads add their statistics in parallel*/
+    lv_refr_design_lock();
+    cull_frame.obj_skip_cnt += cull_act.obj_skip_cnt;
+    cull_frame.obj_clip_cnt += cull_act.obj_clip_cnt;
+    cull_frame.cover_cnt += cull_act.cover_cnt;
+    cull_frame.px_saved += cull_act.px_saved;
+    lv_refr_design_unlock();
+#endif
 
-    /* In true double buffered mode flush only once when all areas were rendered.
-     * In normal mode flush after every area */
-    if(lv_disp_is_true_double_buf(disp_refr) == false) {
-        lv_refr_vdb_flush();
+    LV_PROF_STOP(prof_start, LV_PROF_CAT_REFR, "draw_mask");
+}
+
+#if LV_REFR_THREADS > 1
+/**
+ * Draw an area of the VDB in horizontal slices on the refresh threads and on the calling thread.
+ * The slices don't overlap so the threads can draw into the same VDB.
+ * @param mask_p pointer to an area on the act. VDB
+ */
+static void lv_refr_mask_parallel(const lv_area_t * mask_p)
+{
+    lv_coord_t h       = lv_area_get_height(mask_p);
+    uint32_t slice_cnt = h / REFR_SLICE_MIN_ROWS;
+    if(slice_cnt > (uint32_t)worker_cnt + 1) slice_cnt = worker_cnt + 1;
+
+    if(slice_cnt < 2) {
+        lv_refr_mask(mask_p);
+        return;
     }
+
+    lv_coord_t slice_h = h / slice_cnt;
+    lv_area_t first_slice;
+    lv_area_copy(&first_slice, mask_p);
+    first_slice.y2 = first_slice.y1 + slice_h - 1;
+
+    /*Give the other slices to the workers. The last slice gets the remaining rows too*/
+    pthread_mutex_lock(&worker_mutex);
+    uint32_t i;
+    lv_coord_t y = first_slice.y2 + 1;
+    for(i = 0; i < slice_cnt - 1; i++) {
+        lv_area_copy(&workers[i].mask, mask_p);
+        workers[i].mask.y1 = y;
+        workers[i].mask.y2 = i == slice_cnt - 2 ? mask_p->y2 : y + slice_h - 1;
+        workers[i].arena   = &disp_refr->draw_arena[i + 1];
+        workers[i].has_job = true;
+        y += slice_h;
+    }
+    worker_busy_cnt = slice_cnt - 1;
+    worker_gen++;
+    pthread_cond_broadcast(&worker_start_cond);
+    pthread_mutex_unlock(&worker_mutex);
+
+    lv_refr_mask(&first_slice);
+
+    /*Wait for the workers because the VDB will be flushed*/
+    pthread_mutex_lock(&worker_mutex);
+    while(worker_busy_cnt != 0) pthread_cond_wait(&worker_done_cond, &worker_mutex);
+    pthread_mutex_unlock(&worker_mutex);
+}
+
+/**
+ * A refresh thread. Wait for a slice to draw, draw it and report it's ready.
+ * @param param pointer to the thread's `lv_refr_worker_t`
+ */
+static void * lv_refr_worker(void * param)
+{
+    lv_refr_worker_t * w = param;
+    uint32_t gen         = 0;
+
+    pthread_mutex_lock(&worker_mutex);
+    while(1) {
+        while(gen == worker_gen) pthread_cond_wait(&worker_start_cond, &worker_mutex);
+        gen = worker_gen;
+        if(w->has_job == false) continue;
+
+        pthread_mutex_unlock(&worker_mutex);
+
+        lv_draw_arena_set_act(w->arena);
+        lv_refr_mask(&w->mask);
+        lv_draw_arena_set_act(NULL);
+
+        pthread_mutex_lock(&worker_mutex);
+        w->has_job = false;
+        worker_busy_cnt--;
+        if(worker_busy_cnt == 0) pthread_cond_signal(&worker_done_cond);
+    }
+
+    return NULL;
 }
+#endif
 
 /**
  * Search the most top object which fully covers an area
@@ -476,7 +795,10 @@ static void lv_refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p)
         }
 
         /*Call the post draw design function of the parents of the to object*/
-        par->design_cb(par, mask_p, LV_DESIGN_DRAW_POST);
+#if LV_REFR_OCCLUSION
+        if(cover_collect == false)
+#endif
+            par->design_cb(par, mask_p, LV_DESIGN_DRAW_POST);
 
         /*The new border will be there last parents,
          *so the 'younger' brothers of parent will be refreshed*/
@@ -513,14 +835,35 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
     /*Draw the parent and its children only if they ore on 'mask_parent'*/
     if(union_ok != false) {
 
+#if LV_REFR_OCCLUSION
+        uint32_t draw_id = draw_id_act++;
+        lv_area_t main_mask;
+        if(cover_collect) {
+            cover_add(obj, mask_ori_p, draw_id);
+        }
+        /* Redraw the not hidden part of the object */
+        else if(cover_clip(&main_mask, &obj_ext_mask, draw_id)) {
+            LV_PROF_START(prof_main);
+            obj->design_cb(obj, &main_mask, LV_DESIGN_DRAW_MAIN);
+            LV_PROF_STOP(prof_main, LV_PROF_CAT_DRAW, prof_obj_type(obj));
+        }
+#else
         /* Redraw the object */
+        LV_PROF_START(prof_main);
         obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_MAIN);
+        LV_PROF_STOP(prof_main, LV_PROF_CAT_DRAW, prof_obj_type(obj));
+#endif
 
 #if MASK_AREA_DEBUG
-        static lv_color_t debug_color = LV_COLOR_RED;
-        lv_draw_fill(&obj_ext_mask, &obj_ext_mask, debug_color, LV_OPA_50);
-        debug_color.full *= 17;
-        debug_color.full += 0xA1;
+#if LV_REFR_OCCLUSION
+        if(cover_collect == false)
+#endif
+        {
+            static lv_color_t debug_color = LV_COLOR_RED;
+            lv_draw_fill(&obj_ext_mask, &obj_ext_mask, debug_color, LV_OPA_50);
+            debug_color.full *= 17;
+            debug_color.full += 0xA1;
+        }
 #endif
         /*Create a new 'obj_mask' without 'ext_size' because the children can't be visible there*/
         lv_obj_get_coords(obj, &obj_area);
@@ -549,11 +892,139 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
             }
         }
 
-        /* If all the children are redrawn make 'post draw' design */
-        obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_POST);
+        /* If all the children are redrawn make 'post draw' design.
+         * It's hidden only by the objects drawn after the children*/
+#if LV_REFR_OCCLUSION
+        if(cover_collect == false && cover_hides(&obj_ext_mask, draw_id_act) == false)
+#endif
+        {
+            LV_PROF_START(prof_post);
+            obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_POST);
+            LV_PROF_STOP(prof_post, LV_PROF_CAT_DRAW_POST, prof_obj_type(obj));
+        }
     }
 }
 
+#if LV_REFR_OCCLUSION
+/**
+ * Save the area of an object if it's fully opaque there
+ * @param obj pointer to an object
+ * @param mask_p the area where the object is visible (already truncated to the parents)
+ * @param draw_id drawing order of the object
+ */
+static void cover_add(lv_obj_t * obj, const lv_area_t * mask_p, uint32_t draw_id)
+{
+    lv_area_t a;
+    if(lv_area_intersect(&a, mask_p, &obj->coords) == false) return;
+
+    /*Same conditions as in `lv_refr_get_top_obj`*/
+    const lv_style_t * style = lv_obj_get_style(obj);
+    if(style->body.opa != LV_OPA_COVER || lv_obj_get_opa_scale(obj) != LV_OPA_COVER) return;
+
+    if(obj->design_cb(obj, &a, LV_DESIGN_COVER_CHK) == false) {
+        /*The rounded corners are not covered. Try without them*/
+        lv_coord_t r = style->body.radius;
+        if(r == 0 || r == LV_RADIUS_CIRCLE) return;
+
+        a.x1 = LV_MATH_MAX(a.x1, obj->coords.x1 + r);
+        a.x2 = LV_MATH_MIN(a.x2, obj->coords.x2 - r);
+        a.y1 = LV_MATH_MAX(a.y1, obj->coords.y1 + r);
+        a.y2 = LV_MATH_MIN(a.y2, obj->coords.y2 - r);
+        if(a.x1 > a.x2 || a.y1 > a.y2) return;
+        if(obj->design_cb(obj, &a, LV_DESIGN_COVER_CHK) == false) return;
+    }
+
+    /*If there is no more space replace the smallest area if the new is larger*/
+    uint8_t i = cover_cnt;
+    if(cover_cnt < REFR_COVER_MAX) {
+        cover_cnt++;
+    } else {
+        uint8_t j;
+        i = 0;
+        for(j = 1; j < REFR_COVER_MAX; j++) {
+            if(lv_area_get_size(&covers[j].area) < lv_area_get_size(&covers[i].area)) i = j;
+        }
+        if(lv_area_get_size(&covers[i].area) >= lv_area_get_size(&a)) return;
+    }
+
+    lv_area_copy(&covers[i].area, &a);
+    covers[i].draw_id = draw_id;
+}
+
+/**
+ * Remove the parts of an object's area which are hidden by the objects drawn later.
+ * Only the parts which leave a rectangle are removed (covered edges).
+ * @param res_p store the not hidden part here
+ * @param mask_p the area to draw the object
+ * @param draw_id drawing order of the object
+ * @return false: the object is fully hidden
+ */
+static bool cover_clip(lv_area_t * res_p, const lv_area_t * mask_p, uint32_t draw_id)
+{
+    lv_area_copy(res_p, mask_p);
+
+    uint8_t i;
+    for(i = 0; i < cover_cnt; i++) {
+        const lv_area_t * c = &covers[i].area;
+        if(covers[i].draw_id <= draw_id) continue;
+        if(c->x1 > res_p->x2 || c->x2 < res_p->x1 || c->y1 > res_p->y2 || c->y2 < res_p->y1) continue;
+
+        if(lv_area_is_in(res_p, c)) {
+            cull_act.obj_skip_cnt++;
+            cull_act.px_saved += lv_area_get_size(mask_p);
+            return false;
+        }
+
+        bool cut = false;
+        if(c->x1 <= res_p->x1 && c->x2 >= res_p->x2) {
+            /*Covers the full width: cut from the top or the bottom*/
+            if(c->y1 <= res_p->y1) {
+                res_p->y1 = c->y2 + 1;
+                cut       = true;
+            } else if(c->y2 >= res_p->y2) {
+                res_p->y2 = c->y1 - 1;
+                cut       = true;
+            }
+        } else if(c->y1 <= res_p->y1 && c->y2 >= res_p->y2) {
+            /*Covers the full height: cut from the left or the right*/
+            if(c->x1 <= res_p->x1) {
+                res_p->x1 = c->x2 + 1;
+                cut       = true;
+            } else if(c->x2 >= res_p->x2) {
+                res_p->x2 = c->x1 - 1;
+                cut       = true;
+            }
+        }
+
+        /*An other area might cover the rest now so check all of them again*/
+        if(cut) i = (uint8_t)-1;
+    }
+
+    if(res_p->x1 != mask_p->x1 || res_p->y1 != mask_p->y1 || res_p->x2 != mask_p->x2 || res_p->y2 != mask_p->y2) {
+        cull_act.obj_clip_cnt++;
+        cull_act.px_saved += lv_area_get_size(mask_p) - lv_area_get_size(res_p);
+    }
+
+    return true;
+}
+
+/**
+ * Tell whether an area is hidden by an object drawn later
+ * @param area_p pointer to an area
+ * @param draw_id the areas of the objects drawn from this are considered
+ * @return true: `area_p` is fully covered
+ */
+static bool cover_hides(const lv_area_t * area_p, uint32_t draw_id)
+{
+    uint8_t i;
+    for(i = 0; i < cover_cnt; i++) {
+        if(covers[i].draw_id >= draw_id && lv_area_is_in(area_p, &covers[i].area)) return true;
+    }
+
+    return false;
+}
+#endif
+
 /**
  * Flush the content of the VDB
  */
@@ -564,15 +1035,16 @@ static void lv_refr_vdb_flush(void)
     /*In double buffered mode wait until the other buffer is flushed before flushing the current
      * one*/
     if(lv_disp_is_double_buf(disp_refr)) {
-        while(vdb->flushing)
-            ;
+        lv_refr_wait_flush(vdb);
     }
 
     vdb->flushing = 1;
 
     /*Flush the rendered content to the display*/
     lv_disp_t * disp = lv_refr_get_disp_refreshing();
+    LV_PROF_START(prof_start);
     if(disp->driver.flush_cb) disp->driver.flush_cb(&disp->driver, &vdb->area, vdb->buf_act);
+    LV_PROF_STOP(prof_start, LV_PROF_CAT_FLUSH, "flush_cb");
 
     if(vdb->buf1 && vdb->buf2) {
         if(vdb->buf_act == vdb->buf1)
@@ -581,3 +1053,41 @@ static void lv_refr_vdb_flush(void)
             vdb->buf_act = vdb->buf1;
     }
 }
+
+/**
+ * Wait until the flushing of the VDB is finished.
+ * Use the driver's `wait_cb` if set, else busy wait.
+ * @param vdb pointer to the VDB of the display being refreshed
+ */
+static void lv_refr_wait_flush(lv_disp_buf_t * vdb)
+{
+    if(vdb->flushing == 0) return;
+
+    LV_PROF_START(prof_start);
+
+    if(disp_refr->driver.wait_cb) {
+        while(vdb->flushing) {
+            disp_refr->driver.wait_cb(&disp_refr->driver);
+        }
+    } else {
+        while(vdb->flushing)
+            ;
+    }
+
+    LV_PROF_STOP(prof_start, LV_PROF_CAT_FLUSH, "wait_flush");
+}
+
+#if LV_USE_PROF
+/**
+ * Get the type of an object to name its drawing in the profiler
+ * @param obj pointer to an object
+ * @return the type, e.g. "lv_btn"
+ */
+static const char * prof_obj_type(lv_obj_t * obj)
+{
+    lv_obj_type_t type;
+    lv_obj_get_type(obj, &type);
+
+    return type.type[0] ? type.type[0] : "lv_obj";
+}
+#endif
@@ -20,10 +20,31 @@ extern "C" {
  *      DEFINES
  *********************/
 
+/*Storage class of the drawing functions' scratch variables. Every refresh thread needs its own copy*/
+#if LV_REFR_THREADS > 1
+#define LV_REFR_THREAD_LOCAL __thread
+#else
+#define LV_REFR_THREAD_LOCAL
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 
+#if LV_REFR_OCCLUSION
+/**
+ * Statistics of the objects hidden by opaque objects in a refresh.
+ * Every refreshed part of an area (e.g. slice of a refresh thread) is counted separately.
+ */
+typedef struct
+{
+    uint32_t obj_skip_cnt; /**< Number of objects not drawn because they were fully hidden*/
+    uint32_t obj_clip_cnt; /**< Number of objects drawn only on their not hidden part*/
+    uint32_t cover_cnt;    /**< Number of opaque areas found*/
+    uint32_t px_saved;     /**< Number of pixels not drawn because they were hidden*/
+} lv_refr_cull_monitor_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -76,6 +97,28 @@ lv_disp_t * lv_refr_get_disp_refreshing(void);
  */
 void lv_refr_set_disp_refreshing(lv_disp_t * disp);
 
+/**
+ * Lock the objects against the other refresh threads.
+ * Design functions which temporarily modify their object (e.g. a field of the ext. data) should
+ * call it before the modification and `lv_refr_design_unlock` after restoring the object.
+ * To draw with a temporal style use `lv_obj_set_style_tmp` instead.
+ * Does nothing if `LV_REFR_THREADS <= 1`
+ */
+void lv_refr_design_lock(void);
+
+/**
+ * Release the lock taken by `lv_refr_design_lock`
+ */
+void lv_refr_design_unlock(void);
+
+#if LV_REFR_OCCLUSION
+/**
+ * Give information about the hidden objects in the last refresh
+ * @param mon_p pointer to a monitor variable to store the result
+ */
+void lv_refr_cull_monitor(lv_refr_cull_monitor_t * mon_p);
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param task pointer to the task itself
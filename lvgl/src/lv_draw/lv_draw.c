@@ -15,6 +15,7 @@
 #include "../lv_misc/lv_math.h"
 #include "../lv_misc/lv_mem.h"
 #include "../lv_misc/lv_gc.h"
+#include "../lv_core/lv_refr.h"
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
@@ -35,7 +36,6 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
-static uint32_t draw_buf_size = 0;
 
 /**********************
  *      MACROS
@@ -45,42 +45,6 @@ static uint32_t draw_buf_size = 0;
  *   GLOBAL FUNCTIONS
  **********************/
 
-/**
- * Give a buffer with the given to use during drawing.
- * Be careful to not use the buffer while other processes are using it.
- * @param size the required size
- */
-void * lv_draw_get_buf(uint32_t size)
-{
-    if(size <= draw_buf_size) return LV_GC_ROOT(_lv_draw_buf);
-
-    LV_LOG_TRACE("lv_draw_get_buf: allocate");
-
-    draw_buf_size = size;
-
-    if(LV_GC_ROOT(_lv_draw_buf) == NULL) {
-        LV_GC_ROOT(_lv_draw_buf) = lv_mem_alloc(size);
-        lv_mem_assert(LV_GC_ROOT(_lv_draw_buf));
-        return LV_GC_ROOT(_lv_draw_buf);
-    }
-
-    LV_GC_ROOT(_lv_draw_buf) = lv_mem_realloc(LV_GC_ROOT(_lv_draw_buf), size);
-    lv_mem_assert(LV_GC_ROOT(_lv_draw_buf));
-    return LV_GC_ROOT(_lv_draw_buf);
-}
-
-/**
- * Free the draw buffer
- */
-void lv_draw_free_buf(void)
-{
-    if(LV_GC_ROOT(_lv_draw_buf)) {
-        lv_mem_free(LV_GC_ROOT(_lv_draw_buf));
-        LV_GC_ROOT(_lv_draw_buf) = NULL;
-        draw_buf_size = 0;
-    }
-}
-
 #if LV_ANTIALIAS
 
 /**
@@ -35,18 +35,6 @@ extern "C" {
  * GLOBAL PROTOTYPES
  **********************/
 
-/**
- * Give a buffer with the given to use during drawing.
- * Be careful to not use the buffer while other processes are using it.
- * @param size the required size
- */
-void * lv_draw_get_buf(uint32_t size);
-
-/**
- * Free the draw buffer
- */
-void lv_draw_free_buf(void);
-
 #if LV_ANTIALIAS
 
 /**
@@ -94,7 +82,10 @@ void lv_draw_aa_hor_seg(lv_coord_t x, lv_coord_t y, lv_coord_t length, const lv_
 /**********************
  *   POST INCLUDES
  *********************/
+#include "lv_draw_arena.h"
 #include "lv_draw_basic.h"
+#include "lv_draw_blend.h"
+#include "lv_glyph_cache.h"
 #include "lv_draw_rect.h"
 #include "lv_draw_label.h"
 #include "lv_draw_img.h"
@@ -0,0 +1,234 @@
+/**
+ * @file lv_draw_arena.c
+ * Scratch memory of the drawing functions (shadow tables, image lines, line patterns).
+ * Every display has an arena for every drawing thread. The memories are taken from the arena's buffer
+ * with a moving offset and the buffer is kept between the frames, so drawing doesn't use the heap
+ * once the buffer grew to the largest need. The buffer is enlarged when it's empty or at the end of the frame.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_arena.h"
+#include "../lv_hal/lv_hal_disp.h"
+#include "../lv_core/lv_refr.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_types.h"
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Alignment of the given memories*/
+#define ARENA_ALIGN (sizeof(void *))
+
+/*The buffer is enlarged in these steps to not grow it in every frame*/
+#define ARENA_GROW_STEP 1024
+
+/*A memory from the heap starts with its size*/
+#define OVERFLOW_HEADER_SIZE ARENA_ALIGN
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t align_size(uint32_t size);
+static void buf_resize(lv_draw_arena_t * arena, uint32_t size);
+static bool is_in_buf(const lv_draw_arena_t * arena, const void * p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static LV_REFR_THREAD_LOCAL lv_draw_arena_t * arena_act;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize a draw arena. The buffer is allocated when the first memory is needed.
+ * @param arena pointer to an arena
+ */
+void lv_draw_arena_init(lv_draw_arena_t * arena)
+{
+    arena->buf          = NULL;
+    arena->size         = 0;
+    arena->used         = 0;
+    arena->overflow     = 0;
+    arena->frame_peak   = 0;
+    arena->peak         = 0;
+    arena->overflow_cnt = 0;
+}
+
+/**
+ * Free the buffer of a draw arena
+ * @param arena pointer to an arena
+ */
+void lv_draw_arena_deinit(lv_draw_arena_t * arena)
+{
+    if(arena->buf) lv_mem_free(arena->buf);
+    lv_draw_arena_init(arena);
+}
+
+/**
+ * Set the arena of the calling thread. `lv_draw_arena_alloc` takes the memories from it.
+ * @param arena pointer to an arena or NULL to allocate from the heap (e.g. when drawing on a canvas)
+ */
+void lv_draw_arena_set_act(lv_draw_arena_t * arena)
+{
+    arena_act = arena;
+}
+
+/**
+ * Give a scratch memory to use during drawing.
+ * Give it back with `lv_draw_arena_release` before the drawing function returns.
+ * The memories can be nested but should be given back in reverse order.
+ * @param size the required size in bytes
+ * @return pointer to the memory
+ */
+void * lv_draw_arena_alloc(uint32_t size)
+{
+    lv_draw_arena_t * arena = arena_act;
+    size                    = align_size(size);
+
+    /*Nothing points into an empty buffer so it can be enlarged now*/
+    if(arena && arena->used == 0 && arena->size < size) {
+        buf_resize(arena, LV_MATH_MAX(size, arena->frame_peak));
+    }
+
+    if(arena && arena->size - arena->used >= size) {
+        void * p = &arena->buf[arena->used];
+        arena->used += size;
+        if(arena->used + arena->overflow > arena->frame_peak) arena->frame_peak = arena->used + arena->overflow;
+        return p;
+    }
+
+    /*Doesn't fit: allocate it from the heap and remember its size*/
+    LV_LOG_TRACE("lv_draw_arena_alloc: allocate from the heap");
+
+    uint8_t * p = lv_mem_alloc(size + OVERFLOW_HEADER_SIZE);
+    lv_mem_assert(p);
+    if(p == NULL) return NULL;
+
+    *((uint32_t *)p) = size;
+
+    if(arena) {
+        arena->overflow += size;
+        arena->overflow_cnt++;
+        if(arena->used + arena->overflow > arena->frame_peak) arena->frame_peak = arena->used + arena->overflow;
+    }
+
+    return p + OVERFLOW_HEADER_SIZE;
+}
+
+/**
+ * Give back a memory from `lv_draw_arena_alloc`.
+ * The memories given later from the arena's buffer are given back too.
+ * @param p pointer to the memory
+ */
+void lv_draw_arena_release(void * p)
+{
+    if(p == NULL) return;
+
+    lv_draw_arena_t * arena = arena_act;
+
+    if(arena && is_in_buf(arena, p)) {
+        arena->used = (uint32_t)((uint8_t *)p - arena->buf);
+        return;
+    }
+
+    uint8_t * header = (uint8_t *)p - OVERFLOW_HEADER_SIZE;
+    if(arena) arena->overflow -= *((uint32_t *)header);
+    lv_mem_free(header);
+}
+
+/**
+ * Give back all memories of an arena at the end of a frame.
+ * Enlarge the buffer if the frame needed more so the next frames don't use the heap.
+ * @param arena pointer to an arena
+ */
+void lv_draw_arena_reset(lv_draw_arena_t * arena)
+{
+    if(arena->overflow != 0) LV_LOG_WARN("lv_draw_arena_reset: a memory wasn't given back");
+
+    if(arena->frame_peak > arena->peak) arena->peak = arena->frame_peak;
+
+    if(arena->frame_peak > arena->size) buf_resize(arena, arena->frame_peak);
+
+    arena->used       = 0;
+    arena->overflow   = 0;
+    arena->frame_peak = 0;
+}
+
+/**
+ * Give information about the draw arenas of a display
+ * @param disp pointer to a display
+ * @param mon_p pointer to a monitor variable, the result will be stored here
+ */
+void lv_draw_arena_monitor(const struct _disp_t * disp, lv_draw_arena_monitor_t * mon_p)
+{
+    mon_p->size         = 0;
+    mon_p->peak         = 0;
+    mon_p->overflow_cnt = 0;
+
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_ARENA_CNT; i++) {
+        const lv_draw_arena_t * arena = &disp->draw_arena[i];
+        mon_p->size += arena->size;
+        mon_p->overflow_cnt += arena->overflow_cnt;
+        if(arena->peak > mon_p->peak) mon_p->peak = arena->peak;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Round up a size to keep the next memory aligned
+ * @param size a size in bytes
+ * @return the aligned size (not 0)
+ */
+static uint32_t align_size(uint32_t size)
+{
+    /*A 0 sized memory would point to the end of the buffer*/
+    if(size == 0) return ARENA_ALIGN;
+
+    return (size + ARENA_ALIGN - 1) & ~((uint32_t)ARENA_ALIGN - 1);
+}
+
+/**
+ * Reallocate the buffer of an arena with a larger size. The content is lost.
+ * @param arena pointer to an arena whose buffer is not used
+ * @param size the required size in bytes
+ */
+static void buf_resize(lv_draw_arena_t * arena, uint32_t size)
+{
+    /*The content is not needed so don't copy it with realloc*/
+    size = ((size + ARENA_GROW_STEP - 1) / ARENA_GROW_STEP) * ARENA_GROW_STEP;
+    if(arena->buf) lv_mem_free(arena->buf);
+    arena->buf = lv_mem_alloc(size);
+    lv_mem_assert(arena->buf);
+    arena->size = arena->buf ? size : 0;
+}
+
+/**
+ * Check if a memory is in the buffer of an arena
+ * @param arena pointer to an arena
+ * @param p pointer to a memory
+ * @return true: `p` is in the buffer
+ */
+static bool is_in_buf(const lv_draw_arena_t * arena, const void * p)
+{
+    const uint8_t * p8 = p;
+    return arena->buf != NULL && p8 >= arena->buf && p8 < arena->buf + arena->size;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file lv_draw_arena.h
+ *
+ */
+
+#ifndef LV_DRAW_ARENA_H
+#define LV_DRAW_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Number of draw arenas of a display: one for every thread drawing in parallel*/
+#if LV_REFR_THREADS > 1
+#define LV_DRAW_ARENA_CNT LV_REFR_THREADS
+#else
+#define LV_DRAW_ARENA_CNT 1
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+struct _disp_t;
+
+/**
+ * Scratch memory of the drawing functions. The memories are taken from the end of a buffer
+ * and given back in reverse order. The buffer is kept between the refreshes.
+ * If the buffer is too small it's enlarged when it's empty, else the memory is allocated with `lv_mem_alloc`
+ * and the buffer is enlarged after the frame.
+ */
+typedef struct
+{
+    uint8_t * buf;         /**< The buffer. NULL if nothing was drawn yet*/
+    uint32_t size;         /**< Size of `buf` in bytes*/
+    uint32_t used;         /**< Size of the given memories in `buf`*/
+    uint32_t overflow;     /**< Size of the given memories which didn't fit into `buf`*/
+    uint32_t frame_peak;   /**< Largest `used + overflow` in the current frame*/
+    uint32_t peak;         /**< Largest `frame_peak` so far (high-water mark)*/
+    uint32_t overflow_cnt; /**< Number of memories which didn't fit into `buf` so far*/
+} lv_draw_arena_t;
+
+/**
+ * Information about the draw arenas of a display
+ */
+typedef struct
+{
+    uint32_t size;         /**< Size of the buffers together*/
+    uint32_t peak;         /**< Largest need of a thread in a frame*/
+    uint32_t overflow_cnt; /**< Number of memories allocated from the heap because a buffer was too small*/
+} lv_draw_arena_monitor_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize a draw arena. The buffer is allocated when the first memory is needed.
+ * @param arena pointer to an arena
+ */
+void lv_draw_arena_init(lv_draw_arena_t * arena);
+
+/**
+ * Free the buffer of a draw arena
+ * @param arena pointer to an arena
+ */
+void lv_draw_arena_deinit(lv_draw_arena_t * arena);
+
+/**
+ * Set the arena of the calling thread. `lv_draw_arena_alloc` takes the memories from it.
+ * @param arena pointer to an arena or NULL to allocate from the heap (e.g. when drawing on a canvas)
+ */
+void lv_draw_arena_set_act(lv_draw_arena_t * arena);
+
+/**
+ * Give a scratch memory to use during drawing.
+ * Give it back with `lv_draw_arena_release` before the drawing function returns.
+ * The memories can be nested but should be given back in reverse order.
+ * @param size the required size in bytes
+ * @return pointer to the memory
+ */
+void * lv_draw_arena_alloc(uint32_t size);
+
+/**
+ * Give back a memory from `lv_draw_arena_alloc`.
+ * The memories given later from the arena's buffer are given back too.
+ * @param p pointer to the memory
+ */
+void lv_draw_arena_release(void * p);
+
+/**
+ * Give back all memories of an arena at the end of a frame.
+ * Enlarge the buffer if the frame needed more so the next frames don't use the heap.
+ * @param arena pointer to an arena
+ */
+void lv_draw_arena_reset(lv_draw_arena_t * arena);
+
+/**
+ * Give information about the draw arenas of a display
+ * @param disp pointer to a display
+ * @param mon_p pointer to a monitor variable, the result will be stored here
+ */
+void lv_draw_arena_monitor(const struct _disp_t * disp, lv_draw_arena_monitor_t * mon_p);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_DRAW_ARENA_H*/
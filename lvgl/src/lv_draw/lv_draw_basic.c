@@ -38,10 +38,24 @@
  *      TYPEDEFS
  **********************/
 
+/*Expands a row of a glyph bitmap to opacity values*/
+typedef void (*letter_row_cb_t)(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                                const lv_opa_t * opa_table);
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+static void draw_letter_map(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv_font_t * font_p,
+                            const lv_font_glyph_dsc_t * g, const uint8_t * map_p, lv_color_t color, lv_opa_t opa);
+static void letter_row_1(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                         const lv_opa_t * opa_table);
+static void letter_row_2(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                         const lv_opa_t * opa_table);
+static void letter_row_4(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                         const lv_opa_t * opa_table);
+static void letter_row_8(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                         const lv_opa_t * opa_table);
 static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area, lv_color_t color,
                           lv_opa_t opa);
 
@@ -153,8 +167,8 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
     vdb_buf_tmp += vdb_width * vdb_rel_a.y1;
 
 #if LV_USE_GPU
-    static LV_ATTRIBUTE_MEM_ALIGN lv_color_t color_array_tmp[LV_HOR_RES_MAX]; /*Used by 'lv_disp_mem_blend'*/
-    static lv_coord_t last_width = -1;
+    static LV_REFR_THREAD_LOCAL LV_ATTRIBUTE_MEM_ALIGN lv_color_t color_array_tmp[LV_HOR_RES_MAX]; /*Used by 'lv_disp_mem_blend'*/
+    static LV_REFR_THREAD_LOCAL lv_coord_t last_width = -1;
 
     lv_coord_t w = lv_area_get_width(&vdb_rel_a);
     /*Don't use hw. acc. for every small fill (because of the init overhead)*/
@@ -233,13 +247,6 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
 void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv_font_t * font_p, uint32_t letter,
                     lv_color_t color, lv_opa_t opa)
 {
-    /*clang-format off*/
-    const uint8_t bpp1_opa_table[2]  = {0, 255};          /*Opacity mapping with bpp = 1 (Just for compatibility)*/
-    const uint8_t bpp2_opa_table[4]  = {0, 85, 170, 255}; /*Opacity mapping with bpp = 2*/
-    const uint8_t bpp4_opa_table[16] = {0,  17, 34,  51,  /*Opacity mapping with bpp = 4*/
-                                        68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255};
-    /*clang-format on*/
-
     if(opa < LV_OPA_MIN) return;
     if(opa > LV_OPA_MAX) opa = LV_OPA_COVER;
 
@@ -248,127 +255,44 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
         return;
     }
 
+#if LV_GLYPH_CACHE_SIZE != 0
+    /*Draw the already decoded letter if possible*/
+    lv_glyph_cache_entry_t * cached = lv_glyph_cache_get(font_p, letter);
+    if(cached) {
+        if(cached->map) draw_letter_map(pos_p, mask_p, font_p, &cached->dsc, cached->map, color, opa);
+        lv_glyph_cache_release(cached);
+        return;
+    }
+#endif
+
     lv_font_glyph_dsc_t g;
     bool g_ret = lv_font_get_glyph_dsc(font_p, &g, letter, '\0');
     if(g_ret == false) return;
 
-    lv_coord_t pos_x = pos_p->x + g.ofs_x;
-    lv_coord_t pos_y = pos_p->y + (font_p->line_height - font_p->base_line) - g.box_h - g.ofs_y;
-
-    const uint8_t * bpp_opa_table;
-    uint8_t bitmask_init;
-    uint8_t bitmask;
-
-    switch(g.bpp) {
-        case 1:
-            bpp_opa_table = bpp1_opa_table;
-            bitmask_init  = 0x80;
-            break;
-        case 2:
-            bpp_opa_table = bpp2_opa_table;
-            bitmask_init  = 0xC0;
-            break;
-        case 4:
-            bpp_opa_table = bpp4_opa_table;
-            bitmask_init  = 0xF0;
-            break;
-        case 8:
-            bpp_opa_table = NULL;
-            bitmask_init  = 0xFF;
-            break;       /*No opa table, pixel value will be used directly*/
-        default: return; /*Invalid bpp. Can't render the letter*/
-    }
-
     const uint8_t * map_p = lv_font_get_glyph_bitmap(font_p, letter);
-
     if(map_p == NULL) return;
 
-    /*If the letter is completely out of mask don't draw it */
-    if(pos_x + g.box_w < mask_p->x1 || pos_x > mask_p->x2 || pos_y + g.box_h < mask_p->y1 || pos_y > mask_p->y2) return;
-
-    lv_disp_t * disp    = lv_refr_get_disp_refreshing();
-    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
-
-    lv_coord_t vdb_width     = lv_area_get_width(&vdb->area);
-    lv_color_t * vdb_buf_tmp = vdb->buf_act;
-    lv_coord_t col, row;
-
-    uint8_t width_byte_scr = g.box_w >> 3; /*Width in bytes (on the screen finally) (e.g. w = 11 -> 2 bytes wide)*/
-    if(g.box_w & 0x7) width_byte_scr++;
-    uint16_t width_bit = g.box_w * g.bpp; /*Letter width in bits*/
-
-    /* Calculate the col/row start/end on the map*/
-    lv_coord_t col_start = pos_x >= mask_p->x1 ? 0 : mask_p->x1 - pos_x;
-    lv_coord_t col_end   = pos_x + g.box_w <= mask_p->x2 ? g.box_w : mask_p->x2 - pos_x + 1;
-    lv_coord_t row_start = pos_y >= mask_p->y1 ? 0 : mask_p->y1 - pos_y;
-    lv_coord_t row_end   = pos_y + g.box_h <= mask_p->y2 ? g.box_h : mask_p->y2 - pos_y + 1;
-
-    /*Set a pointer on VDB to the first pixel of the letter*/
-    vdb_buf_tmp += ((pos_y - vdb->area.y1) * vdb_width) + pos_x - vdb->area.x1;
-
-    /*If the letter is partially out of mask the move there on VDB*/
-    vdb_buf_tmp += (row_start * vdb_width) + col_start;
-
-    /*Move on the map too*/
-    uint32_t bit_ofs = (row_start * width_bit) + (col_start * g.bpp);
-    map_p += bit_ofs >> 3;
-
-    uint8_t letter_px;
-    lv_opa_t px_opa;
-    uint16_t col_bit;
-    col_bit = bit_ofs & 0x7; /* "& 0x7" equals to "% 8" just faster */
-
-    bool scr_transp = false;
-#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
-    scr_transp = disp->driver.screen_transp;
-#endif
-
-    for(row = row_start; row < row_end; row++) {
-        bitmask = bitmask_init >> col_bit;
-        for(col = col_start; col < col_end; col++) {
-            letter_px = (*map_p & bitmask) >> (8 - col_bit - g.bpp);
-            if(letter_px != 0) {
-                if(opa == LV_OPA_COVER) {
-                    px_opa = g.bpp == 8 ? letter_px : bpp_opa_table[letter_px];
-                } else {
-                    px_opa = g.bpp == 8 ? (uint16_t)((uint16_t)letter_px * opa) >> 8
-                                        : (uint16_t)((uint16_t)bpp_opa_table[letter_px] * opa) >> 8;
-                }
-
-                if(disp->driver.set_px_cb) {
-                    disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width,
-                                           (col + pos_x) - vdb->area.x1, (row + pos_y) - vdb->area.y1, color, px_opa);
-                } else if(vdb_buf_tmp->full != color.full) {
-                    if(px_opa > LV_OPA_MAX)
-                        *vdb_buf_tmp = color;
-                    else if(px_opa > LV_OPA_MIN) {
-                        if(scr_transp == false) {
-                            *vdb_buf_tmp = lv_color_mix(color, *vdb_buf_tmp, px_opa);
-                        } else {
-#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
-                            *vdb_buf_tmp = color_mix_2_alpha(*vdb_buf_tmp, (*vdb_buf_tmp).ch.alpha, color, px_opa);
-#endif
-                        }
-                    }
-                }
-            }
-
-            vdb_buf_tmp++;
-
-            if(col_bit < 8 - g.bpp) {
-                col_bit += g.bpp;
-                bitmask = bitmask >> g.bpp;
-            } else {
-                col_bit = 0;
-                bitmask = bitmask_init;
-                map_p++;
-            }
-        }
-        col_bit += ((g.box_w - col_end) + col_start) * g.bpp;
+    draw_letter_map(pos_p, mask_p, font_p, &g, map_p, color, opa);
+}
 
-        map_p += (col_bit >> 3);
-        col_bit = col_bit & 0x7;
-        vdb_buf_tmp += vdb_width - (col_end - col_start); /*Next row in VDB*/
+/**
+ * Expand a row of a glyph bitmap to opacity values, the way `lv_draw_letter` does it
+ * @param bpp bit per pixel of the glyph (1, 2, 4 or 8)
+ * @param map_p pointer to the byte of the glyph bitmap with the first pixel
+ * @param bit_ofs bit offset of the first pixel in `map_p[0]` (0 with 8 bpp)
+ * @param row_opa store the opacities here
+ * @param len number of pixels to expand
+ * @param opa_table map the pixel values to opacities (not used with 8 bpp)
+ */
+void lv_draw_letter_row(uint8_t bpp, const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                        const lv_opa_t * opa_table)
+{
+    switch(bpp) {
+        case 1: letter_row_1(map_p, bit_ofs, row_opa, len, opa_table); break;
+        case 2: letter_row_2(map_p, bit_ofs, row_opa, len, opa_table); break;
+        case 4: letter_row_4(map_p, bit_ofs, row_opa, len, opa_table); break;
+        case 8: letter_row_8(map_p, bit_ofs, row_opa, len, opa_table); break;
+        default: break; /*Invalid bpp*/
     }
 }
 
@@ -569,10 +493,7 @@ static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t len
     if(opa == LV_OPA_COVER) {
         memcpy(dest, src, length * sizeof(lv_color_t));
     } else {
-        uint32_t col;
-        for(col = 0; col < length; col++) {
-            dest[col] = lv_color_mix(src[col], dest[col], opa);
-        }
+        lv_draw_blend_map(dest, src, length, opa);
     }
 }
 
@@ -626,24 +547,16 @@ static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_
             scr_transp = disp->driver.screen_transp;
 #endif
 
-            lv_color_t bg_tmp  = LV_COLOR_BLACK;
-            lv_color_t opa_tmp = lv_color_mix(color, bg_tmp, opa);
+            uint32_t fill_w = fill_area->x2 - fill_area->x1 + 1;
             for(row = fill_area->y1; row <= fill_area->y2; row++) {
-                for(col = fill_area->x1; col <= fill_area->x2; col++) {
-                    if(scr_transp == false) {
-                        /*If the bg color changed recalculate the result color*/
-                        if(mem[col].full != bg_tmp.full) {
-                            bg_tmp  = mem[col];
-                            opa_tmp = lv_color_mix(color, bg_tmp, opa);
-                        }
-
-                        mem[col] = opa_tmp;
-
-                    } else {
+                if(scr_transp == false) {
+                    lv_draw_blend_fill(&mem[fill_area->x1], color, fill_w, opa);
+                } else {
 #if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+                    for(col = fill_area->x1; col <= fill_area->x2; col++) {
                         mem[col] = color_mix_2_alpha(mem[col], mem[col].ch.alpha, color, opa);
-#endif
                     }
+#endif
                 }
                 mem += mem_width;
             }
@@ -651,6 +564,193 @@ static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_
     }
 }
 
+/**
+ * Draw a glyph bitmap in the Virtual Display Buffer
+ * @param pos_p left-top coordinate of the latter
+ * @param mask_p the letter will be drawn only on this area  (truncated to VDB area)
+ * @param font_p pointer to font
+ * @param g descriptor of the glyph
+ * @param map_p bitmap of the glyph
+ * @param color color of letter
+ * @param opa opacity of letter (LV_OPA_MIN..LV_OPA_MAX or LV_OPA_COVER)
+ */
+static void draw_letter_map(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv_font_t * font_p,
+                            const lv_font_glyph_dsc_t * g, const uint8_t * map_p, lv_color_t color, lv_opa_t opa)
+{
+    /*clang-format off*/
+    const uint8_t bpp1_opa_table[2]  = {0, 255};          /*Opacity mapping with bpp = 1 (Just for compatibility)*/
+    const uint8_t bpp2_opa_table[4]  = {0, 85, 170, 255}; /*Opacity mapping with bpp = 2*/
+    const uint8_t bpp4_opa_table[16] = {0,  17, 34,  51,  /*Opacity mapping with bpp = 4*/
+                                        68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255};
+    /*clang-format on*/
+
+    lv_coord_t pos_x = pos_p->x + g->ofs_x;
+    lv_coord_t pos_y = pos_p->y + (font_p->line_height - font_p->base_line) - g->box_h - g->ofs_y;
+
+    const uint8_t * bpp_opa_table;
+    letter_row_cb_t row_cb;
+
+    switch(g->bpp) {
+        case 1:
+            bpp_opa_table = bpp1_opa_table;
+            row_cb        = letter_row_1;
+            break;
+        case 2:
+            bpp_opa_table = bpp2_opa_table;
+            row_cb        = letter_row_2;
+            break;
+        case 4:
+            bpp_opa_table = bpp4_opa_table;
+            row_cb        = letter_row_4;
+            break;
+        case 8:
+            bpp_opa_table = NULL;
+            row_cb        = letter_row_8;
+            break;       /*No opa table, pixel value will be used directly*/
+        default: return; /*Invalid bpp. Can't render the letter*/
+    }
+
+    /*If the letter is completely out of mask don't draw it */
+    if(pos_x + g->box_w < mask_p->x1 || pos_x > mask_p->x2 || pos_y + g->box_h < mask_p->y1 || pos_y > mask_p->y2) return;
+
+    lv_disp_t * disp    = lv_refr_get_disp_refreshing();
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+
+    lv_coord_t vdb_width     = lv_area_get_width(&vdb->area);
+    lv_color_t * vdb_buf_tmp = vdb->buf_act;
+    lv_coord_t col, row;
+
+    uint16_t width_bit = g->box_w * g->bpp; /*Letter width in bits*/
+
+    /* Calculate the col/row start/end on the map*/
+    lv_coord_t col_start = pos_x >= mask_p->x1 ? 0 : mask_p->x1 - pos_x;
+    lv_coord_t col_end   = pos_x + g->box_w <= mask_p->x2 ? g->box_w : mask_p->x2 - pos_x + 1;
+    lv_coord_t row_start = pos_y >= mask_p->y1 ? 0 : mask_p->y1 - pos_y;
+    lv_coord_t row_end   = pos_y + g->box_h <= mask_p->y2 ? g->box_h : mask_p->y2 - pos_y + 1;
+    lv_coord_t row_len   = col_end - col_start;
+
+    /*Set a pointer on VDB to the first pixel of the letter*/
+    vdb_buf_tmp += ((pos_y - vdb->area.y1) * vdb_width) + pos_x - vdb->area.x1;
+
+    /*If the letter is partially out of mask the move there on VDB*/
+    vdb_buf_tmp += (row_start * vdb_width) + col_start;
+
+    /*Opacity of the pixel values with `opa` applied*/
+    lv_opa_t opa_table[16];
+    if(bpp_opa_table) {
+        uint8_t i;
+        for(i = 0; i < (1 << g->bpp); i++) {
+            opa_table[i] = opa == LV_OPA_COVER ? bpp_opa_table[i] : (uint16_t)((uint16_t)bpp_opa_table[i] * opa) >> 8;
+        }
+    }
+
+    bool scr_transp = false;
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+    scr_transp = disp->driver.screen_transp;
+#endif
+
+    lv_opa_t row_buf[UINT8_MAX + 1]; /*Opacity of the pixels in a row. (`box_w` is `uint8_t`)*/
+    const lv_opa_t * row_opa;
+    for(row = row_start; row < row_end; row++) {
+        uint32_t bit_ofs = (row * width_bit) + (col_start * g->bpp);
+
+        if(g->bpp == 8 && opa == LV_OPA_COVER) {
+            /*The pixel values are the opacities. (E.g. letters from the glyph cache)*/
+            row_opa = map_p + (bit_ofs >> 3);
+        } else {
+            row_cb(map_p + (bit_ofs >> 3), bit_ofs & 0x7, row_buf, row_len, opa_table);
+            if(g->bpp == 8) {
+                for(col = 0; col < row_len; col++) {
+                    row_buf[col] = (uint16_t)((uint16_t)row_buf[col] * opa) >> 8;
+                }
+            }
+            row_opa = row_buf;
+        }
+
+        if(disp->driver.set_px_cb) {
+            for(col = 0; col < row_len; col++) {
+                if(row_opa[col] == LV_OPA_TRANSP) continue;
+                disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width,
+                                       (col_start + col + pos_x) - vdb->area.x1, (row + pos_y) - vdb->area.y1, color,
+                                       row_opa[col]);
+            }
+        } else if(scr_transp == false) {
+            lv_draw_blend_mask(vdb_buf_tmp, color, row_opa, row_len);
+        } else {
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+            for(col = 0; col < row_len; col++) {
+                if(row_opa[col] <= LV_OPA_MIN || vdb_buf_tmp[col].full == color.full) continue;
+
+                if(row_opa[col] > LV_OPA_MAX)
+                    vdb_buf_tmp[col] = color;
+                else
+                    vdb_buf_tmp[col] = color_mix_2_alpha(vdb_buf_tmp[col], vdb_buf_tmp[col].ch.alpha, color, row_opa[col]);
+            }
+#endif
+        }
+
+        vdb_buf_tmp += vdb_width; /*Next row in VDB*/
+    }
+}
+
+/**
+ * Expand a row of a glyph with `BPP` bits per pixel to opacity values.
+ * Generated for every bpp to work with constant shifts and to unroll the bytes.
+ * @param map_p pointer to the byte of the glyph bitmap with the first pixel
+ * @param bit_ofs bit offset of the first pixel in `map_p[0]`
+ * @param row_opa store the opacities here
+ * @param len number of pixels to expand
+ * @param opa_table map the pixel values to opacities
+ */
+#define LETTER_ROW_FUNC(BPP)                                                                                          \
+    static void letter_row_##BPP(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,          \
+                                 const lv_opa_t * opa_table)                                                          \
+    {                                                                                                                 \
+        const uint8_t px_mask = (1 << BPP) - 1;                                                                       \
+        lv_coord_t i          = 0;                                                                                    \
+        uint8_t k;                                                                                                    \
+                                                                                                                      \
+        /*Finish the first byte if the row starts in the middle of it*/                                               \
+        if(bit_ofs != 0) {                                                                                            \
+            uint8_t byte = *map_p++;                                                                                  \
+            for(; bit_ofs < 8 && i < len; bit_ofs += BPP, i++) {                                                      \
+                row_opa[i] = opa_table[(byte >> (8 - BPP - bit_ofs)) & px_mask];                                      \
+            }                                                                                                         \
+        }                                                                                                             \
+                                                                                                                      \
+        /*Whole bytes*/                                                                                               \
+        for(; i + 8 / BPP <= len; i += 8 / BPP) {                                                                     \
+            uint8_t byte = *map_p++;                                                                                  \
+            for(k = 0; k < 8 / BPP; k++) {                                                                            \
+                row_opa[i + k] = opa_table[(byte >> (8 - BPP - k * BPP)) & px_mask];                                  \
+            }                                                                                                         \
+        }                                                                                                             \
+                                                                                                                      \
+        /*The pixels in the last byte*/                                                                               \
+        if(i < len) {                                                                                                 \
+            uint8_t byte = *map_p;                                                                                    \
+            for(k = 0; i < len; k++, i++) {                                                                           \
+                row_opa[i] = opa_table[(byte >> (8 - BPP - k * BPP)) & px_mask];                                      \
+            }                                                                                                         \
+        }                                                                                                             \
+    }
+
+LETTER_ROW_FUNC(1)
+LETTER_ROW_FUNC(2)
+LETTER_ROW_FUNC(4)
+
+/**
+ * Copy a row of an 8 bpp glyph. The pixel values are the opacities.
+ * Same parameters as the `letter_row_<bpp>` functions; `bit_ofs` is always 0 and `opa_table` is not used.
+ */
+static void letter_row_8(const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                         const lv_opa_t * opa_table)
+{
+    (void)bit_ofs;   /*Unused*/
+    (void)opa_table; /*Unused*/
+    memcpy(row_opa, map_p, len);
+}
+
 #if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
 /**
  * Mix two colors. Both color can have alpha value. It requires ARGB888 colors.
@@ -678,11 +778,11 @@ static inline lv_color_t color_mix_2_alpha(lv_color_t bg_color, lv_opa_t bg_opa,
     /*Both colors have alpha. Expensive calculation need to be applied*/
     else {
         /*Save the parameters and the result. If they will be asked again don't compute again*/
-        static lv_opa_t fg_opa_save     = 0;
-        static lv_opa_t bg_opa_save     = 0;
-        static lv_color_t fg_color_save = {{0}};
-        static lv_color_t bg_color_save = {{0}};
-        static lv_color_t c             = {{0}};
+        static LV_REFR_THREAD_LOCAL lv_opa_t fg_opa_save     = 0;
+        static LV_REFR_THREAD_LOCAL lv_opa_t bg_opa_save     = 0;
+        static LV_REFR_THREAD_LOCAL lv_color_t fg_color_save = {{0}};
+        static LV_REFR_THREAD_LOCAL lv_color_t bg_color_save = {{0}};
+        static LV_REFR_THREAD_LOCAL lv_color_t c             = {{0}};
 
         if(fg_opa != fg_opa_save || bg_opa != bg_opa_save || fg_color.full != fg_color_save.full ||
            bg_color.full != bg_color_save.full) {
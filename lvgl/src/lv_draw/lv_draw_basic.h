@@ -57,6 +57,18 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
 void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv_font_t * font_p, uint32_t letter,
                     lv_color_t color, lv_opa_t opa);
 
+/**
+ * Expand a row of a glyph bitmap to opacity values, the way `lv_draw_letter` does it
+ * @param bpp bit per pixel of the glyph (1, 2, 4 or 8)
+ * @param map_p pointer to the byte of the glyph bitmap with the first pixel
+ * @param bit_ofs bit offset of the first pixel in `map_p[0]` (0 with 8 bpp)
+ * @param row_opa store the opacities here
+ * @param len number of pixels to expand
+ * @param opa_table map the pixel values to opacities (not used with 8 bpp)
+ */
+void lv_draw_letter_row(uint8_t bpp, const uint8_t * map_p, uint8_t bit_ofs, lv_opa_t * row_opa, lv_coord_t len,
+                        const lv_opa_t * opa_table);
+
 /**
  * Draw a color map to the display (image)
  * @param cords_p coordinates the color map
@@ -0,0 +1,571 @@
+/**
+ * @file lv_draw_blend.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_blend.h"
+#include <string.h>
+
+#if LV_USE_SIMD && (LV_COLOR_DEPTH == 32 || (LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0))
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BLEND_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define BLEND_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BLEND_NEON 1
+#endif
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if defined(BLEND_AVX2) || defined(BLEND_SSE2) || defined(BLEND_NEON)
+#define BLEND_SIMD 1
+#endif
+
+/*The x86 kernels are written once for both vector widths*/
+#if BLEND_AVX2
+#define VEC_T __m256i
+#define VEC_PX (32 / sizeof(lv_color_t))
+#define v_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#define v_store(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define v_zero() _mm256_setzero_si256()
+#define v_set16(x) _mm256_set1_epi16(x)
+#define v_set32(x) _mm256_set1_epi32(x)
+#define v_set8(x) _mm256_set1_epi8(x)
+#define v_unpacklo8 _mm256_unpacklo_epi8
+#define v_unpackhi8 _mm256_unpackhi_epi8
+#define v_packus16 _mm256_packus_epi16
+#define v_mullo16 _mm256_mullo_epi16
+#define v_add16 _mm256_add_epi16
+#define v_srli16 _mm256_srli_epi16
+#define v_slli16 _mm256_slli_epi16
+#define v_sub16 _mm256_sub_epi16
+#define v_cmpeq8 _mm256_cmpeq_epi8
+#define v_cmpeq16 _mm256_cmpeq_epi16
+#define v_cmpeq32 _mm256_cmpeq_epi32
+#define v_cmpgt16 _mm256_cmpgt_epi16
+#define v_max_u8 _mm256_max_epu8
+#define v_min_u8 _mm256_min_epu8
+#define v_and _mm256_and_si256
+#define v_andnot _mm256_andnot_si256
+#define v_or _mm256_or_si256
+#elif BLEND_SSE2
+#define VEC_T __m128i
+#define VEC_PX (16 / sizeof(lv_color_t))
+#define v_load(p) _mm_loadu_si128((const __m128i *)(p))
+#define v_store(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define v_zero() _mm_setzero_si128()
+#define v_set16(x) _mm_set1_epi16(x)
+#define v_set32(x) _mm_set1_epi32(x)
+#define v_set8(x) _mm_set1_epi8(x)
+#define v_unpacklo8 _mm_unpacklo_epi8
+#define v_unpackhi8 _mm_unpackhi_epi8
+#define v_packus16 _mm_packus_epi16
+#define v_mullo16 _mm_mullo_epi16
+#define v_add16 _mm_add_epi16
+#define v_srli16 _mm_srli_epi16
+#define v_slli16 _mm_slli_epi16
+#define v_sub16 _mm_sub_epi16
+#define v_cmpeq8 _mm_cmpeq_epi8
+#define v_cmpeq16 _mm_cmpeq_epi16
+#define v_cmpeq32 _mm_cmpeq_epi32
+#define v_cmpgt16 _mm_cmpgt_epi16
+#define v_max_u8 _mm_max_epu8
+#define v_min_u8 _mm_min_epu8
+#define v_and _mm_and_si128
+#define v_andnot _mm_andnot_si128
+#define v_or _mm_or_si128
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if BLEND_SIMD
+static uint32_t map_simd(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+static uint32_t fill_simd(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa);
+static uint32_t mask_simd(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Mix a pixel map into a buffer: `dest[i] = lv_color_mix(src[i], dest[i], opa)`.
+ * Uses SIMD instructions if enabled with `LV_USE_SIMD`.
+ * @param dest pointer to the destination buffer
+ * @param src pointer to the source pixels
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ */
+void lv_draw_blend_map(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    uint32_t done = 0;
+#if BLEND_SIMD
+    done = map_simd(dest, src, length, opa);
+#endif
+    /*Mix the remaining pixels one by one*/
+    lv_draw_blend_map_ref(dest + done, src + done, length - done, opa);
+}
+
+/**
+ * Mix a color into a buffer: `dest[i] = lv_color_mix(color, dest[i], opa)`.
+ * Uses SIMD instructions if enabled with `LV_USE_SIMD`.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param length number of pixels
+ * @param opa opacity of `color`
+ */
+void lv_draw_blend_fill(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa)
+{
+    uint32_t done = 0;
+#if BLEND_SIMD
+    done = fill_simd(dest, color, length, opa);
+#endif
+    /*Mix the remaining pixels one by one*/
+    lv_draw_blend_fill_ref(dest + done, color, length - done, opa);
+}
+
+/**
+ * Mix a color into a buffer with a different opacity for every pixel (e.g. a row of a letter).
+ * Pixels with `mask[i] <= LV_OPA_MIN` are not changed, pixels with `mask[i] > LV_OPA_MAX` are set to `color`.
+ * Uses SIMD instructions if enabled with `LV_USE_SIMD`.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param mask opacity of `color` for every pixel
+ * @param length number of pixels
+ */
+void lv_draw_blend_mask(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length)
+{
+    uint32_t done = 0;
+#if BLEND_SIMD
+    done = mask_simd(dest, color, mask, length);
+#endif
+    /*Mix the remaining pixels one by one*/
+    lv_draw_blend_mask_ref(dest + done, color, mask + done, length - done);
+}
+
+/**
+ * Plain C version of `lv_draw_blend_map`.
+ * The SIMD versions give exactly the same result.
+ * @param dest pointer to the destination buffer
+ * @param src pointer to the source pixels
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ */
+void lv_draw_blend_map_ref(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    uint32_t i;
+    for(i = 0; i < length; i++) {
+        dest[i] = lv_color_mix(src[i], dest[i], opa);
+    }
+}
+
+/**
+ * Plain C version of `lv_draw_blend_fill`.
+ * The SIMD versions give exactly the same result.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param length number of pixels
+ * @param opa opacity of `color`
+ */
+void lv_draw_blend_fill_ref(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa)
+{
+    /*Neighbour pixels have the same color very often. Don't mix them again*/
+    lv_color_t bg_tmp  = LV_COLOR_BLACK;
+    lv_color_t res_tmp = lv_color_mix(color, bg_tmp, opa);
+    uint32_t i;
+    for(i = 0; i < length; i++) {
+        if(dest[i].full != bg_tmp.full) {
+            bg_tmp  = dest[i];
+            res_tmp = lv_color_mix(color, bg_tmp, opa);
+        }
+        dest[i] = res_tmp;
+    }
+}
+
+/**
+ * Plain C version of `lv_draw_blend_mask`.
+ * The SIMD versions give exactly the same result.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param mask opacity of `color` for every pixel
+ * @param length number of pixels
+ */
+void lv_draw_blend_mask_ref(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length)
+{
+    uint32_t i;
+    for(i = 0; i < length; i++) {
+        if(mask[i] <= LV_OPA_MIN || dest[i].full == color.full) continue;
+
+        if(mask[i] > LV_OPA_MAX)
+            dest[i] = color;
+        else
+            dest[i] = lv_color_mix(color, dest[i], mask[i]);
+    }
+}
+
+/**
+ * Get the name of the instruction set used by the blend functions
+ * @return "NEON", "SSE2", "AVX2" or "C"
+ */
+const char * lv_draw_blend_get_isa(void)
+{
+#if BLEND_AVX2
+    return "AVX2";
+#elif BLEND_SSE2
+    return "SSE2";
+#elif BLEND_NEON
+    return "NEON";
+#else
+    return "C";
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* All kernels calculate `(c1 * mix + c2 * (255 - mix)) >> 8` on 16 bit lanes like `lv_color_mix`.
+ * The sum is at most 255 * 255 so it never overflows and the result is exact.
+ * They return the number of processed pixels. The rest is mixed by the caller.*/
+
+#if BLEND_AVX2 || BLEND_SSE2
+
+/*Bitwise `cond ? a : b`*/
+static inline VEC_T v_select(VEC_T cond, VEC_T a, VEC_T b)
+{
+    return v_or(v_and(cond, a), v_andnot(cond, b));
+}
+
+#if LV_COLOR_DEPTH == 32
+
+static uint32_t map_simd(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    const VEC_T zero    = v_zero();
+    const VEC_T mix     = v_set16(opa);
+    const VEC_T mix_inv = v_set16(255 - opa);
+    const VEC_T alpha   = v_set32((int32_t)0xFF000000);
+
+    uint32_t i;
+    for(i = 0; i + VEC_PX <= length; i += VEC_PX) {
+        VEC_T s  = v_load(&src[i]);
+        VEC_T d  = v_load(&dest[i]);
+        VEC_T lo = v_add16(v_mullo16(v_unpacklo8(s, zero), mix), v_mullo16(v_unpacklo8(d, zero), mix_inv));
+        VEC_T hi = v_add16(v_mullo16(v_unpackhi8(s, zero), mix), v_mullo16(v_unpackhi8(d, zero), mix_inv));
+        v_store(&dest[i], v_or(v_packus16(v_srli16(lo, 8), v_srli16(hi, 8)), alpha));
+    }
+
+    return i;
+}
+
+static uint32_t fill_simd(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa)
+{
+    const VEC_T zero    = v_zero();
+    const VEC_T mix_inv = v_set16(255 - opa);
+    const VEC_T alpha   = v_set32((int32_t)0xFF000000);
+
+    /*The color's part is the same for every pixel*/
+    const VEC_T c = v_mullo16(v_unpacklo8(v_set32((int32_t)color.full), zero), v_set16(opa));
+
+    uint32_t i;
+    for(i = 0; i + VEC_PX <= length; i += VEC_PX) {
+        VEC_T d  = v_load(&dest[i]);
+        VEC_T lo = v_add16(c, v_mullo16(v_unpacklo8(d, zero), mix_inv));
+        VEC_T hi = v_add16(c, v_mullo16(v_unpackhi8(d, zero), mix_inv));
+        v_store(&dest[i], v_or(v_packus16(v_srli16(lo, 8), v_srli16(hi, 8)), alpha));
+    }
+
+    return i;
+}
+
+/*Load the opacity of `VEC_PX` pixels into every byte of their color*/
+static inline VEC_T load_mask(const lv_opa_t * mask)
+{
+#if BLEND_AVX2
+    VEC_T m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)mask));
+    return _mm256_mullo_epi32(m, _mm256_set1_epi32(0x01010101));
+#else
+    uint32_t m4;
+    memcpy(&m4, mask, sizeof(m4));
+    VEC_T m = _mm_cvtsi32_si128((int32_t)m4);
+    m       = _mm_unpacklo_epi8(m, m);
+    return _mm_unpacklo_epi16(m, m);
+#endif
+}
+
+static uint32_t mask_simd(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length)
+{
+    const VEC_T zero     = v_zero();
+    const VEC_T opa_full = v_set16(255);
+    const VEC_T opa_min  = v_set8(LV_OPA_MIN);
+    const VEC_T opa_max  = v_set8((char)(LV_OPA_MAX + 1));
+    const VEC_T alpha    = v_set32((int32_t)0xFF000000);
+    const VEC_T c        = v_set32((int32_t)color.full);
+    const VEC_T c16      = v_unpacklo8(c, zero);
+
+    uint32_t i;
+    for(i = 0; i + VEC_PX <= length; i += VEC_PX) {
+        VEC_T m    = load_mask(&mask[i]);
+        VEC_T d    = v_load(&dest[i]);
+        VEC_T m_lo = v_unpacklo8(m, zero);
+        VEC_T m_hi = v_unpackhi8(m, zero);
+        VEC_T lo   = v_add16(v_mullo16(c16, m_lo), v_mullo16(v_unpacklo8(d, zero), v_sub16(opa_full, m_lo)));
+        VEC_T hi   = v_add16(v_mullo16(c16, m_hi), v_mullo16(v_unpackhi8(d, zero), v_sub16(opa_full, m_hi)));
+        VEC_T res  = v_or(v_packus16(v_srli16(lo, 8), v_srli16(hi, 8)), alpha);
+
+        /*Use `color` where the opacity is high and keep `dest` where it's low or `dest` is `color` already*/
+        VEC_T cover = v_cmpeq8(v_max_u8(m, opa_max), m);
+        VEC_T keep  = v_or(v_cmpeq8(v_min_u8(m, opa_min), m), v_cmpeq32(d, c));
+        res         = v_select(keep, d, v_select(cover, c, res));
+        v_store(&dest[i], res);
+    }
+
+    return i;
+}
+
+#else /*LV_COLOR_DEPTH == 16*/
+
+static inline VEC_T mix_565(VEC_T s, VEC_T d, VEC_T mix, VEC_T mix_inv)
+{
+    const VEC_T mask5 = v_set16(0x1F);
+    const VEC_T mask6 = v_set16(0x3F);
+
+    VEC_T r = v_add16(v_mullo16(v_srli16(s, 11), mix), v_mullo16(v_srli16(d, 11), mix_inv));
+    VEC_T g = v_add16(v_mullo16(v_and(v_srli16(s, 5), mask6), mix), v_mullo16(v_and(v_srli16(d, 5), mask6), mix_inv));
+    VEC_T b = v_add16(v_mullo16(v_and(s, mask5), mix), v_mullo16(v_and(d, mask5), mix_inv));
+
+    r = v_slli16(v_srli16(r, 8), 11);
+    g = v_slli16(v_srli16(g, 8), 5);
+    b = v_srli16(b, 8);
+    return v_or(v_or(r, g), b);
+}
+
+static uint32_t map_simd(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    const VEC_T mix     = v_set16(opa);
+    const VEC_T mix_inv = v_set16(255 - opa);
+
+    uint32_t i;
+    for(i = 0; i + VEC_PX <= length; i += VEC_PX) {
+        v_store(&dest[i], mix_565(v_load(&src[i]), v_load(&dest[i]), mix, mix_inv));
+    }
+
+    return i;
+}
+
+static uint32_t fill_simd(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa)
+{
+    const VEC_T mix     = v_set16(opa);
+    const VEC_T mix_inv = v_set16(255 - opa);
+    const VEC_T c       = v_set16(color.full);
+
+    uint32_t i;
+    for(i = 0; i + VEC_PX <= length; i += VEC_PX) {
+        v_store(&dest[i], mix_565(c, v_load(&dest[i]), mix, mix_inv));
+    }
+
+    return i;
+}
+
+/*Load the opacity of `VEC_PX` pixels to 16 bit lanes*/
+static inline VEC_T load_mask(const lv_opa_t * mask)
+{
+#if BLEND_AVX2
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)mask));
+#else
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)mask), _mm_setzero_si128());
+#endif
+}
+
+static uint32_t mask_simd(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length)
+{
+    const VEC_T opa_full = v_set16(255);
+    const VEC_T opa_min  = v_set16(LV_OPA_MIN + 1);
+    const VEC_T opa_max  = v_set16(LV_OPA_MAX);
+    const VEC_T c        = v_set16(color.full);
+
+    uint32_t i;
+    for(i = 0; i + VEC_PX <= length; i += VEC_PX) {
+        VEC_T m   = load_mask(&mask[i]);
+        VEC_T d   = v_load(&dest[i]);
+        VEC_T res = mix_565(c, d, m, v_sub16(opa_full, m));
+
+        /*Use `color` where the opacity is high and keep `dest` where it's low or `dest` is `color` already*/
+        VEC_T cover = v_cmpgt16(m, opa_max);
+        VEC_T keep  = v_or(v_cmpgt16(opa_min, m), v_cmpeq16(d, c));
+        res         = v_select(keep, d, v_select(cover, c, res));
+        v_store(&dest[i], res);
+    }
+
+    return i;
+}
+
+#endif /*LV_COLOR_DEPTH*/
+#endif /*BLEND_AVX2 || BLEND_SSE2*/
+
+#if BLEND_NEON
+#if LV_COLOR_DEPTH == 32
+
+static uint32_t map_simd(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    const uint8x8_t mix     = vdup_n_u8(opa);
+    const uint8x8_t mix_inv = vdup_n_u8(255 - opa);
+    const uint8x16_t alpha  = vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000));
+
+    uint32_t i;
+    for(i = 0; i + 4 <= length; i += 4) {
+        uint8x16_t s  = vld1q_u8((const uint8_t *)&src[i]);
+        uint8x16_t d  = vld1q_u8((const uint8_t *)&dest[i]);
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s), mix), vget_low_u8(d), mix_inv);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s), mix), vget_high_u8(d), mix_inv);
+        vst1q_u8((uint8_t *)&dest[i], vorrq_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)), alpha));
+    }
+
+    return i;
+}
+
+static uint32_t fill_simd(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa)
+{
+    const uint8x8_t mix_inv = vdup_n_u8(255 - opa);
+    const uint8x16_t alpha  = vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000));
+
+    /*The color's part is the same for every pixel*/
+    const uint16x8_t c = vmull_u8(vreinterpret_u8_u32(vdup_n_u32(color.full)), vdup_n_u8(opa));
+
+    uint32_t i;
+    for(i = 0; i + 4 <= length; i += 4) {
+        uint8x16_t d  = vld1q_u8((const uint8_t *)&dest[i]);
+        uint16x8_t lo = vmlal_u8(c, vget_low_u8(d), mix_inv);
+        uint16x8_t hi = vmlal_u8(c, vget_high_u8(d), mix_inv);
+        vst1q_u8((uint8_t *)&dest[i], vorrq_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)), alpha));
+    }
+
+    return i;
+}
+
+static uint32_t mask_simd(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length)
+{
+    const uint8x16_t opa_min = vdupq_n_u8(LV_OPA_MIN);
+    const uint8x16_t opa_max = vdupq_n_u8(LV_OPA_MAX);
+    const uint8x16_t alpha   = vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000));
+    const uint32x4_t c32     = vdupq_n_u32(color.full);
+    const uint8x16_t c       = vreinterpretq_u8_u32(c32);
+
+    uint32_t i;
+    for(i = 0; i + 4 <= length; i += 4) {
+        /*Load the opacity of 4 pixels into every byte of their color*/
+        uint32_t m4;
+        memcpy(&m4, &mask[i], sizeof(m4));
+        uint32x4_t m32   = vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(m4)))));
+        uint8x16_t m     = vreinterpretq_u8_u32(vmulq_n_u32(m32, 0x01010101));
+        uint8x16_t m_inv = vmvnq_u8(m); /*255 - m*/
+
+        uint8x16_t d   = vld1q_u8((const uint8_t *)&dest[i]);
+        uint16x8_t lo  = vmlal_u8(vmull_u8(vget_low_u8(c), vget_low_u8(m)), vget_low_u8(d), vget_low_u8(m_inv));
+        uint16x8_t hi  = vmlal_u8(vmull_u8(vget_high_u8(c), vget_high_u8(m)), vget_high_u8(d), vget_high_u8(m_inv));
+        uint8x16_t res = vorrq_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)), alpha);
+
+        /*Use `color` where the opacity is high and keep `dest` where it's low or `dest` is `color` already*/
+        uint8x16_t cover = vcgtq_u8(m, opa_max);
+        uint8x16_t keep  = vorrq_u8(vcleq_u8(m, opa_min),
+                                    vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(d), c32)));
+        res = vbslq_u8(keep, d, vbslq_u8(cover, c, res));
+        vst1q_u8((uint8_t *)&dest[i], res);
+    }
+
+    return i;
+}
+
+#else /*LV_COLOR_DEPTH == 16*/
+
+static inline uint16x8_t mix_565(uint16x8_t s, uint16x8_t d, uint16x8_t mix, uint16x8_t mix_inv)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+
+    uint16x8_t r = vmlaq_u16(vmulq_u16(vshrq_n_u16(s, 11), mix), vshrq_n_u16(d, 11), mix_inv);
+    uint16x8_t g = vmlaq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(s, 5), mask6), mix),
+                             vandq_u16(vshrq_n_u16(d, 5), mask6), mix_inv);
+    uint16x8_t b = vmlaq_u16(vmulq_u16(vandq_u16(s, mask5), mix), vandq_u16(d, mask5), mix_inv);
+
+    r = vshlq_n_u16(vshrq_n_u16(r, 8), 11);
+    g = vshlq_n_u16(vshrq_n_u16(g, 8), 5);
+    b = vshrq_n_u16(b, 8);
+    return vorrq_u16(vorrq_u16(r, g), b);
+}
+
+static uint32_t map_simd(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    const uint16x8_t mix     = vdupq_n_u16(opa);
+    const uint16x8_t mix_inv = vdupq_n_u16(255 - opa);
+
+    uint32_t i;
+    for(i = 0; i + 8 <= length; i += 8) {
+        uint16x8_t s = vld1q_u16((const uint16_t *)&src[i]);
+        uint16x8_t d = vld1q_u16((const uint16_t *)&dest[i]);
+        vst1q_u16((uint16_t *)&dest[i], mix_565(s, d, mix, mix_inv));
+    }
+
+    return i;
+}
+
+static uint32_t fill_simd(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa)
+{
+    const uint16x8_t mix     = vdupq_n_u16(opa);
+    const uint16x8_t mix_inv = vdupq_n_u16(255 - opa);
+    const uint16x8_t c       = vdupq_n_u16(color.full);
+
+    uint32_t i;
+    for(i = 0; i + 8 <= length; i += 8) {
+        uint16x8_t d = vld1q_u16((const uint16_t *)&dest[i]);
+        vst1q_u16((uint16_t *)&dest[i], mix_565(c, d, mix, mix_inv));
+    }
+
+    return i;
+}
+
+static uint32_t mask_simd(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length)
+{
+    const uint16x8_t opa_full = vdupq_n_u16(255);
+    const uint16x8_t opa_min  = vdupq_n_u16(LV_OPA_MIN);
+    const uint16x8_t opa_max  = vdupq_n_u16(LV_OPA_MAX);
+    const uint16x8_t c        = vdupq_n_u16(color.full);
+
+    uint32_t i;
+    for(i = 0; i + 8 <= length; i += 8) {
+        uint16x8_t m   = vmovl_u8(vld1_u8(&mask[i]));
+        uint16x8_t d   = vld1q_u16((const uint16_t *)&dest[i]);
+        uint16x8_t res = mix_565(c, d, m, vsubq_u16(opa_full, m));
+
+        /*Use `color` where the opacity is high and keep `dest` where it's low or `dest` is `color` already*/
+        uint16x8_t cover = vcgtq_u16(m, opa_max);
+        uint16x8_t keep  = vorrq_u16(vcleq_u16(m, opa_min), vceqq_u16(d, c));
+        res = vbslq_u16(keep, d, vbslq_u16(cover, c, res));
+        vst1q_u16((uint16_t *)&dest[i], res);
+    }
+
+    return i;
+}
+
+#endif /*LV_COLOR_DEPTH*/
+#endif /*BLEND_NEON*/
@@ -0,0 +1,111 @@
+/**
+ * @file lv_draw_blend.h
+ *
+ */
+
+#ifndef LV_DRAW_BLEND_H
+#define LV_DRAW_BLEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include "../lv_misc/lv_color.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Mix a pixel map into a buffer: `dest[i] = lv_color_mix(src[i], dest[i], opa)`.
+ * Uses SIMD instructions if enabled with `LV_USE_SIMD`.
+ * @param dest pointer to the destination buffer
+ * @param src pointer to the source pixels
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ */
+void lv_draw_blend_map(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+
+/**
+ * Mix a color into a buffer: `dest[i] = lv_color_mix(color, dest[i], opa)`.
+ * Uses SIMD instructions if enabled with `LV_USE_SIMD`.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param length number of pixels
+ * @param opa opacity of `color`
+ */
+void lv_draw_blend_fill(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa);
+
+/**
+ * Mix a color into a buffer with a different opacity for every pixel (e.g. a row of a letter).
+ * Pixels with `mask[i] <= LV_OPA_MIN` are not changed, pixels with `mask[i] > LV_OPA_MAX` are set to `color`.
+ * Uses SIMD instructions if enabled with `LV_USE_SIMD`.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param mask opacity of `color` for every pixel
+ * @param length number of pixels
+ */
+void lv_draw_blend_mask(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length);
+
+/**
+ * Plain C version of `lv_draw_blend_map`.
+ * The SIMD versions give exactly the same result.
+ * @param dest pointer to the destination buffer
+ * @param src pointer to the source pixels
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ */
+void lv_draw_blend_map_ref(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+
+/**
+ * Plain C version of `lv_draw_blend_fill`.
+ * The SIMD versions give exactly the same result.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param length number of pixels
+ * @param opa opacity of `color`
+ */
+void lv_draw_blend_fill_ref(lv_color_t * dest, lv_color_t color, uint32_t length, lv_opa_t opa);
+
+/**
+ * Plain C version of `lv_draw_blend_mask`.
+ * The SIMD versions give exactly the same result.
+ * @param dest pointer to the destination buffer
+ * @param color color to mix
+ * @param mask opacity of `color` for every pixel
+ * @param length number of pixels
+ */
+void lv_draw_blend_mask_ref(lv_color_t * dest, lv_color_t color, const lv_opa_t * mask, uint32_t length);
+
+/**
+ * Get the name of the instruction set used by the blend functions
+ * @return "NEON", "SSE2", "AVX2" or "C"
+ */
+const char * lv_draw_blend_get_isa(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_DRAW_BLEND_H*/
@@ -10,6 +10,10 @@
 #include "lv_img_cache.h"
 #include "../lv_misc/lv_log.h"
 
+#if LV_REFR_THREADS > 1
+#include <pthread.h>
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -27,6 +31,10 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_REFR_THREADS > 1
+/*The image cache and the decoders are shared by the refresh threads*/
+static pthread_mutex_t img_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /**********************
  *      MACROS
@@ -50,17 +58,23 @@ void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void *
     if(src == NULL) {
         LV_LOG_WARN("Image draw: src is NULL");
         lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
-        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, "No\ndata", LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, "No\ndata", LV_TXT_FLAG_NONE, NULL, -1, -1, NULL, NULL);
         return;
     }
 
     lv_res_t res;
+#if LV_REFR_THREADS > 1
+    pthread_mutex_lock(&img_mutex);
     res = lv_img_draw_core(coords, mask, src, style, opa_scale);
+    pthread_mutex_unlock(&img_mutex);
+#else
+    res = lv_img_draw_core(coords, mask, src, style, opa_scale);
+#endif
 
     if(res == LV_RES_INV) {
         LV_LOG_WARN("Image draw error");
         lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
-        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, "No\ndata", LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, "No\ndata", LV_TXT_FLAG_NONE, NULL, -1, -1, NULL, NULL);
         return;
     }
 }
@@ -494,7 +508,7 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
         LV_LOG_WARN("Image draw error");
         lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
         lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, cdsc->dec_dsc.error_msg, LV_TXT_FLAG_NONE, NULL, -1,
-                      -1, NULL);
+                      -1, NULL, NULL);
     }
     /* The decoder open could open the image and gave the entire uncompressed image.
      * Just draw it!*/
@@ -506,7 +520,7 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
     else {
         lv_coord_t width = lv_area_get_width(&mask_com);
 
-        uint8_t  * buf = lv_draw_get_buf(lv_area_get_width(&mask_com) * ((LV_COLOR_DEPTH >> 3) + 1));  /*+1 because of the possible alpha byte*/
+        uint8_t  * buf = lv_draw_arena_alloc(lv_area_get_width(&mask_com) * ((LV_COLOR_DEPTH >> 3) + 1));  /*+1 because of the possible alpha byte*/
 
         lv_area_t line;
         lv_area_copy(&line, &mask_com);
@@ -519,6 +533,7 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
             read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
             if(read_res != LV_RES_OK) {
                 lv_img_decoder_close(&cdsc->dec_dsc);
+                lv_draw_arena_release(buf);
                 LV_LOG_WARN("Image draw can't read the line");
                 return LV_RES_INV;
             }
@@ -527,6 +542,8 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
             line.y2++;
             y++;
         }
+
+        lv_draw_arena_release(buf);
     }
 
     return LV_RES_OK;
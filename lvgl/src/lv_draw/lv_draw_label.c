@@ -8,12 +8,14 @@
  *********************/
 #include "lv_draw_label.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_mem.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define LABEL_RECOLOR_PAR_LENGTH 6
 #define LV_LABEL_HINT_UPDATE_TH 1024 /*Update the "hint" if the label's y coordinates have changed more then this*/
+#define LAYOUT_FLAGS (LV_TXT_FLAG_RECOLOR | LV_TXT_FLAG_EXPAND) /*The flags which affect the measuring*/
 
 /**********************
  *      TYPEDEFS
@@ -29,6 +31,8 @@ typedef uint8_t cmd_state_t;
  *  STATIC PROTOTYPES
  **********************/
 static uint8_t hex_char_to_num(char hex);
+static bool layout_match(const lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                         lv_coord_t letter_space, lv_coord_t max_w, lv_txt_flag_t flag);
 
 /**********************
  *  STATIC VARIABLES
@@ -53,14 +57,29 @@ static uint8_t hex_char_to_num(char hex);
  * @param offset text offset in x and y direction (NULL if unused)
  * @param sel_start start index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
  * @param sel_end end index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
+ * @param hint pointer to a `lv_draw_label_hint_t` variable.
+ *             It's managed by the drawer to speed up the drawing of very long texts (thousands of lines).
+ * @param layout the measured layout of the text (NULL if unused). Ignored if it doesn't match the text.
  */
 void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
                    const char * txt, lv_txt_flag_t flag, lv_point_t * offset, uint16_t sel_start, uint16_t sel_end,
-                   lv_draw_label_hint_t * hint)
+                   lv_draw_label_hint_t * hint, const lv_draw_label_layout_t * layout)
 {
     const lv_font_t * font = style->text.font;
-    lv_coord_t w;
-    if((flag & LV_TXT_FLAG_EXPAND) == 0) {
+    lv_coord_t line_height = lv_font_get_line_height(font) + style->text.line_space;
+
+    /*Use the layout only if it was measured for this text*/
+    if(layout) {
+        if(line_height <= 0 ||
+           !layout_match(layout, txt, font, style->text.letter_space, lv_area_get_width(coords), flag)) {
+            layout = NULL;
+        }
+    }
+
+    lv_coord_t w = 0;
+    if(layout) {
+        /*The lines are already broken*/
+    } else if((flag & LV_TXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     } else {
@@ -71,8 +90,6 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         w = p.x;
     }
 
-    lv_coord_t line_height = lv_font_get_line_height(font) + style->text.line_space;
-
     /*Init variables for the first line*/
     lv_coord_t line_width = 0;
     lv_point_t pos;
@@ -88,10 +105,28 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     }
 
     uint32_t line_start     = 0;
+    uint32_t line_end;
+    uint32_t line_i         = 0; /*Index of the line in `layout`*/
     int32_t last_line_start = -1;
 
+    if(layout) {
+        if(layout->line_cnt == 0) return;
+
+        /*Jump to the first visible line*/
+        if(pos.y + line_height < mask->y1) {
+            line_i = (mask->y1 - line_height - pos.y + line_height - 1) / line_height;
+            if(line_i >= layout->line_cnt) return;
+            pos.y += line_i * line_height;
+        }
+
+        line_start = layout->line_start[line_i];
+        line_end   = layout->line_start[line_i + 1];
+
+        /*Don't use the hint*/
+        hint = NULL;
+    }
     /*Check the hint to use the cached info*/
-    if(hint && y_ofs == 0 && coords->y1 < 0) {
+    else if(hint && y_ofs == 0 && coords->y1 < 0) {
         /*If the label changed too much recalculate the hint.*/
         if(LV_MATH_ABS(hint->coord_y - coords->y1) > LV_LABEL_HINT_UPDATE_TH - 2 * line_height) {
             hint->line_start = -1;
@@ -105,10 +140,10 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         pos.y += hint->y;
     }
 
-    uint32_t line_end = line_start + lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+    if(layout == NULL) line_end = line_start + lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
 
     /*Go the first visible line*/
-    while(pos.y + line_height < mask->y1) {
+    while(layout == NULL && pos.y + line_height < mask->y1) {
         /*Go to next line*/
         line_start = line_end;
         line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
@@ -126,14 +161,16 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
 
     /*Align to middle*/
     if(flag & LV_TXT_FLAG_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        if(layout) line_width = layout->line_w[line_i];
+        else line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(flag & LV_TXT_FLAG_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        if(layout) line_width = layout->line_w[line_i];
+        else line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
         pos.x += lv_area_get_width(coords) - line_width;
     }
 
@@ -158,9 +195,10 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         i         = line_start;
         uint32_t letter;
         uint32_t letter_next;
+        uint32_t letter_i = layout ? layout->line_letter[line_i] : 0;
         while(i < line_end) {
-            letter      = lv_txt_encoded_next(txt, &i);
-            letter_next = lv_txt_encoded_next(&txt[i], NULL);
+            letter             = lv_txt_encoded_next(txt, &i);
+            uint32_t letter_id = letter_i++;
 
             /*Handle the re-color command*/
             if((flag & LV_TXT_FLAG_RECOLOR) != 0) {
@@ -203,10 +241,15 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
 
             if(cmd_state == CMD_STATE_IN) color = recolor;
 
-            letter_w = lv_font_get_glyph_width(font, letter, letter_next);
+            if(layout) {
+                letter_w = layout->letter_w[letter_id];
+            } else {
+                letter_next = lv_txt_encoded_next(&txt[i], NULL);
+                letter_w    = lv_font_get_glyph_width(font, letter, letter_next);
+            }
 
             if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
-                int char_ind = lv_encoded_get_char_id(txt, i);
+                int char_ind = layout ? letter_id + 1 : lv_encoded_get_char_id(txt, i);
                 /*Do not draw the rectangle on the character at `sel_start`.*/
                 if(char_ind > sel_start && char_ind <= sel_end) {
                     lv_area_t sel_coords;
@@ -225,12 +268,18 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         }
         /*Go to next line*/
         line_start = line_end;
-        line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+        if(layout) {
+            line_i++;
+            if(line_i < layout->line_cnt) line_end = layout->line_start[line_i + 1];
+        } else {
+            line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+        }
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(flag & LV_TXT_FLAG_CENTER) {
-            line_width =
+            if(layout) line_width = layout->line_w[line_i];
+            else line_width =
                 lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
@@ -238,7 +287,8 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         }
         /*Align to the right*/
         else if(flag & LV_TXT_FLAG_RIGHT) {
-            line_width =
+            if(layout) line_width = layout->line_w[line_i];
+            else line_width =
                 lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
             pos.x += lv_area_get_width(coords) - line_width;
         }
@@ -250,10 +300,176 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     }
 }
 
+/**
+ * Initialize a layout as empty
+ * @param layout pointer to a layout
+ */
+void lv_draw_label_layout_init(lv_draw_label_layout_t * layout)
+{
+    memset(layout, 0, sizeof(lv_draw_label_layout_t));
+}
+
+/**
+ * Measure a text into a layout if the layout doesn't describe it already
+ * @param layout pointer to a layout
+ * @param txt 0 terminated text
+ * @param font font of the text
+ * @param letter_space letter space of the text
+ * @param max_w break the lines at this width (not used with `LV_TXT_FLAG_EXPAND`)
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return true: the layout is valid; false: out of memory
+ */
+bool lv_draw_label_layout_update(lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                                 lv_coord_t letter_space, lv_coord_t max_w, lv_txt_flag_t flag)
+{
+    if(layout_match(layout, txt, font, letter_space, max_w, flag)) return true;
+
+    layout->valid = 0;
+    if(txt == NULL || font == NULL) return false;
+
+    flag &= LAYOUT_FLAGS;
+
+    /*Count the lines*/
+    uint32_t line_cnt = 0;
+    uint32_t line_start = 0;
+    while(txt[line_start] != '\0') {
+        line_start += lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, flag);
+        line_cnt++;
+    }
+
+    uint32_t letter_cnt = lv_txt_get_encoded_length(txt);
+
+    /*The line arrays have an extra item for the end of the text*/
+    uint32_t size = (line_cnt + 1) * (2 * sizeof(uint32_t) + sizeof(lv_coord_t)) + letter_cnt * sizeof(lv_coord_t);
+    if(size > layout->buf_size || size < layout->buf_size / 2) {
+        lv_mem_free(layout->buf);
+        layout->buf      = lv_mem_alloc(size);
+        layout->buf_size = layout->buf ? size : 0;
+        if(layout->buf == NULL) {
+            LV_LOG_WARN("lv_draw_label_layout_update: out of memory");
+            return false;
+        }
+    }
+
+    layout->line_start  = layout->buf;
+    layout->line_letter = layout->line_start + line_cnt + 1;
+    layout->line_w      = (lv_coord_t *)(layout->line_letter + line_cnt + 1);
+    layout->letter_w    = layout->line_w + line_cnt + 1;
+
+    /*Save the line breaks and the line widths*/
+    uint32_t l;
+    line_start = 0;
+    for(l = 0; l < line_cnt; l++) {
+        uint32_t line_end     = line_start + lv_txt_get_next_line(&txt[line_start], font, letter_space, max_w, flag);
+        layout->line_start[l] = line_start;
+        layout->line_w[l]     = lv_txt_get_width(&txt[line_start], line_end - line_start, font, letter_space, flag);
+        line_start            = line_end;
+    }
+    layout->line_start[line_cnt] = line_start;
+    layout->line_w[line_cnt]     = 0;
+
+    /*Save the letter widths and the first letter of the lines*/
+    uint32_t i        = 0;
+    uint32_t letter_i = 0;
+    l                 = 0;
+    while(txt[i] != '\0' && letter_i < letter_cnt) {
+        while(l <= line_cnt && layout->line_start[l] == i) {
+            layout->line_letter[l] = letter_i;
+            l++;
+        }
+
+        uint32_t letter      = lv_txt_encoded_next(txt, &i);
+        uint32_t letter_next = lv_txt_encoded_next(&txt[i], NULL);
+        layout->letter_w[letter_i] = lv_font_get_glyph_width(font, letter, letter_next);
+        letter_i++;
+    }
+
+    for(; l <= line_cnt; l++) layout->line_letter[l] = letter_i;
+
+    layout->txt          = txt;
+    layout->font         = font;
+    layout->max_w        = max_w;
+    layout->letter_space = letter_space;
+    layout->flag         = flag;
+    layout->line_cnt     = line_cnt;
+    layout->letter_cnt   = letter_cnt;
+    layout->valid        = 1;
+
+    return true;
+}
+
+/**
+ * Mark a layout as invalid. Should be called if the text changes in place.
+ * @param layout pointer to a layout
+ */
+void lv_draw_label_layout_invalidate(lv_draw_label_layout_t * layout)
+{
+    layout->valid = 0;
+}
+
+/**
+ * Free the memory of a layout
+ * @param layout pointer to a layout
+ */
+void lv_draw_label_layout_free(lv_draw_label_layout_t * layout)
+{
+    lv_mem_free(layout->buf);
+    lv_draw_label_layout_init(layout);
+}
+
+/**
+ * Get the size of the text described by a valid layout. Gives the same result as `lv_txt_get_size`.
+ * @param layout pointer to a valid layout
+ * @param size_res pointer to a 'point_t' variable to store the result
+ * @param line_space line space of the text
+ */
+void lv_draw_label_layout_get_size(const lv_draw_label_layout_t * layout, lv_point_t * size_res, lv_coord_t line_space)
+{
+    uint8_t letter_height = lv_font_get_line_height(layout->font);
+
+    /*Calc. the height and longest line*/
+    size_res->x = 0;
+    size_res->y = 0;
+    uint32_t l;
+    for(l = 0; l < layout->line_cnt; l++) {
+        size_res->x = LV_MATH_MAX(layout->line_w[l], size_res->x);
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    uint32_t txt_end = layout->line_start[layout->line_cnt];
+    if(txt_end != 0 && (layout->txt[txt_end - 1] == '\n' || layout->txt[txt_end - 1] == '\r')) {
+        size_res->y += letter_height + line_space;
+    }
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size_res->y == 0)
+        size_res->y = letter_height;
+    else
+        size_res->y -= line_space;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Check if a layout was measured with the given parameters
+ * @return true: the layout can be used to draw the text
+ */
+static bool layout_match(const lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                         lv_coord_t letter_space, lv_coord_t max_w, lv_txt_flag_t flag)
+{
+    if(layout->valid == 0) return false;
+    if(layout->txt != txt || layout->font != font || layout->letter_space != letter_space) return false;
+    if(layout->flag != (flag & LAYOUT_FLAGS)) return false;
+
+    /*The width doesn't matter if the lines are not broken*/
+    if((flag & LV_TXT_FLAG_EXPAND) == 0 && layout->max_w != max_w) return false;
+
+    return true;
+}
+
 /**
  * Convert a hexadecimal characters to a number (0..15)
  * @param hex Pointer to a hexadecimal character (0..9, A..F)
@@ -40,6 +40,27 @@ typedef struct {
     int32_t coord_y;
 }lv_draw_label_hint_t;
 
+/** Line breaks and letter widths of a text measured in advance.
+ * Drawing a text with a matching layout needs no measuring.
+ * It's built by `lv_draw_label_layout_update` and used if the text, font, letter space,
+ * width and the measuring flags are the same when the text is drawn*/
+typedef struct {
+    const char * txt;         /**< The measured text*/
+    const lv_font_t * font;   /**< Font of the text*/
+    lv_coord_t max_w;         /**< Lines were broken at this width*/
+    lv_coord_t letter_space;  /**< Letter space of the text*/
+    lv_txt_flag_t flag;       /**< `LV_TXT_FLAG_RECOLOR` and `LV_TXT_FLAG_EXPAND` used to measure*/
+    uint32_t line_cnt;        /**< Number of lines*/
+    uint32_t letter_cnt;      /**< Number of letters*/
+    uint32_t * line_start;    /**< Byte index of the first letter of the lines and the text's end (`line_cnt + 1` items)*/
+    uint32_t * line_letter;   /**< Letter index of the first letter of the lines and the letter count*/
+    lv_coord_t * line_w;      /**< Width of the lines and 0 (`line_cnt + 1` items)*/
+    lv_coord_t * letter_w;    /**< Width of the letters with kerning but without letter space*/
+    void * buf;               /**< Allocated memory for the arrays*/
+    uint32_t buf_size;        /**< Size of `buf` in bytes*/
+    uint8_t valid : 1;        /**< 1: the other fields describe `txt`*/
+}lv_draw_label_layout_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -55,10 +76,52 @@ typedef struct {
  * @param offset text offset in x and y direction (NULL if unused)
  * @param sel_start start index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
  * @param sel_end end index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
+ * @param hint pointer to a `lv_draw_label_hint_t` variable.
+ *             It's managed by the drawer to speed up the drawing of very long texts (thousands of lines).
+ * @param layout the measured layout of the text (NULL if unused). Ignored if it doesn't match the text.
  */
 void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
                    const char * txt, lv_txt_flag_t flag, lv_point_t * offset, uint16_t sel_start, uint16_t sel_end,
-                   lv_draw_label_hint_t * hint);
+                   lv_draw_label_hint_t * hint, const lv_draw_label_layout_t * layout);
+
+/**
+ * Initialize a layout as empty
+ * @param layout pointer to a layout
+ */
+void lv_draw_label_layout_init(lv_draw_label_layout_t * layout);
+
+/**
+ * Measure a text into a layout if the layout doesn't describe it already
+ * @param layout pointer to a layout
+ * @param txt 0 terminated text
+ * @param font font of the text
+ * @param letter_space letter space of the text
+ * @param max_w break the lines at this width (not used with `LV_TXT_FLAG_EXPAND`)
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return true: the layout is valid; false: out of memory
+ */
+bool lv_draw_label_layout_update(lv_draw_label_layout_t * layout, const char * txt, const lv_font_t * font,
+                                 lv_coord_t letter_space, lv_coord_t max_w, lv_txt_flag_t flag);
+
+/**
+ * Mark a layout as invalid. Should be called if the text changes in place.
+ * @param layout pointer to a layout
+ */
+void lv_draw_label_layout_invalidate(lv_draw_label_layout_t * layout);
+
+/**
+ * Free the memory of a layout
+ * @param layout pointer to a layout
+ */
+void lv_draw_label_layout_free(lv_draw_label_layout_t * layout);
+
+/**
+ * Get the size of the text described by a valid layout. Gives the same result as `lv_txt_get_size`.
+ * @param layout pointer to a valid layout
+ * @param size_res pointer to a 'point_t' variable to store the result
+ * @param line_space line space of the text
+ */
+void lv_draw_label_layout_get_size(const lv_draw_label_layout_t * layout, lv_point_t * size_res, lv_coord_t line_space);
 
 /**********************
  *      MACROS
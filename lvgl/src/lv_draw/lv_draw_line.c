@@ -264,7 +264,7 @@ static void line_draw_skew(line_draw_t * main_line, bool dir_ori, const lv_area_
      * The worth case is the 45° line where pattern can have 1.41 x `width` points*/
 
     lv_coord_t pattern_size = width * 2;
-    lv_point_t * pattern = lv_draw_get_buf(pattern_size * sizeof(lv_point_t));
+    lv_point_t * pattern = lv_draw_arena_alloc(pattern_size * sizeof(lv_point_t));
     lv_coord_t i = 0;
 
     /*Create a perpendicular pattern (a small line)*/
@@ -568,6 +568,8 @@ static void line_draw_skew(line_draw_t * main_line, bool dir_ori, const lv_area_
         }
 #endif
     }
+
+    lv_draw_arena_release(pattern);
 }
 
 static void line_init(line_draw_t * line, const lv_point_t * p1, const lv_point_t * p2)
@@ -1177,7 +1177,7 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
     uint32_t line_2d_blur_size = ((radius + swidth + 1) + 3) & ~0x3;     /*Round to 4*/
     line_2d_blur_size *= sizeof(lv_opa_t);
 
-    uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size + line_2d_blur_size);
+    uint8_t * draw_buf = lv_draw_arena_alloc(curve_x_size + line_1d_blur_size + line_2d_blur_size);
 
     /*Divide the draw buffer*/
     lv_coord_t  * curve_x = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
@@ -1305,6 +1305,8 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
          * but is is simple, fast and gives a good enough result*/
         if(line == 0) lv_draw_shadow_full_straight(coords, mask, style, line_2d_blur);
     }
+
+    lv_draw_arena_release(draw_buf);
 }
 
 static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
@@ -1325,7 +1327,7 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
     lv_opa_t line_1d_blur_size = (swidth + 3) & ~0x3;     /*Round to 4*/
     line_1d_blur_size *= sizeof(lv_opa_t);
 
-    uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size);
+    uint8_t * draw_buf = lv_draw_arena_alloc(curve_x_size + line_1d_blur_size);
 
     /*Divide the draw buffer*/
     lv_coord_t  * curve_x = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
@@ -1399,6 +1401,8 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
         area_mid.y1++;
         area_mid.y2++;
     }
+
+    lv_draw_arena_release(draw_buf);
 }
 
 static void lv_draw_shadow_full_straight(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
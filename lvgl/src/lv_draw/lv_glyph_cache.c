@@ -0,0 +1,349 @@
+/**
+ * @file lv_glyph_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_glyph_cache.h"
+#if LV_GLYPH_CACHE_SIZE != 0
+
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_types.h"
+#include <string.h>
+
+#if LV_REFR_THREADS > 1
+#include <pthread.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_GLYPH_CACHE_CNT < 1 || LV_GLYPH_CACHE_CNT >= 0xFFFF
+#error "LV_GLYPH_CACHE_CNT must be in 1..65534. See lv_conf.h"
+#endif
+
+/*Marks the end of the lists*/
+#define ENTRY_NONE 0xFFFF
+
+/*The refresh threads draw letters in parallel*/
+#if LV_REFR_THREADS > 1
+#define CACHE_LOCK() pthread_mutex_lock(&cache_mutex)
+#define CACHE_UNLOCK() pthread_mutex_unlock(&cache_mutex)
+#else
+#define CACHE_LOCK()
+#define CACHE_UNLOCK()
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t get_hash(const lv_font_t * font, uint32_t letter);
+static void lru_remove(uint16_t id);
+static void lru_add_head(uint16_t id);
+static void lru_add_tail(uint16_t id);
+static void entry_drop(uint16_t id);
+static void decode(uint8_t * dest, const uint8_t * src, const lv_font_glyph_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_glyph_cache_entry_t entries[LV_GLYPH_CACHE_CNT];
+static uint16_t hash_table[LV_GLYPH_CACHE_CNT]; /*First entry of the buckets*/
+static uint16_t lru_head;                       /*Most recently used entry*/
+static uint16_t lru_tail;                       /*Least recently used or free entry*/
+static lv_glyph_cache_monitor_t cache_stat;
+
+#if LV_REFR_THREADS > 1
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize the glyph cache
+ */
+void lv_glyph_cache_init(void)
+{
+    uint16_t i;
+    for(i = 0; i < LV_GLYPH_CACHE_CNT; i++) {
+        memset(&entries[i], 0, sizeof(lv_glyph_cache_entry_t));
+        entries[i].lru_prev  = i == 0 ? ENTRY_NONE : i - 1;
+        entries[i].lru_next  = i == LV_GLYPH_CACHE_CNT - 1 ? ENTRY_NONE : i + 1;
+        entries[i].hash_next = ENTRY_NONE;
+        hash_table[i]        = ENTRY_NONE;
+    }
+
+    lru_head = 0;
+    lru_tail = LV_GLYPH_CACHE_CNT - 1;
+
+    memset(&cache_stat, 0, sizeof(cache_stat));
+    cache_stat.total_size = LV_GLYPH_CACHE_SIZE;
+}
+
+/**
+ * Get a letter from the cache. If it's not cached decode it and add it to the cache.
+ * The entry must be given back with `lv_glyph_cache_release` when it's not used anymore.
+ * @param font pointer to a font
+ * @param letter a Unicode code point
+ * @return pointer to the cache entry or NULL if the letter can't be cached
+ *         (no such letter or not enough memory)
+ */
+lv_glyph_cache_entry_t * lv_glyph_cache_get(const lv_font_t * font, uint32_t letter)
+{
+    if(font == NULL) return NULL;
+
+    CACHE_LOCK();
+
+    /*Is the letter cached?*/
+    uint32_t hash = get_hash(font, letter);
+    uint16_t id;
+    for(id = hash_table[hash]; id != ENTRY_NONE; id = entries[id].hash_next) {
+        if(entries[id].font == font && entries[id].letter == letter) break;
+    }
+
+    if(id != ENTRY_NONE) {
+        cache_stat.hit_cnt++;
+        lru_remove(id);
+        lru_add_head(id);
+        entries[id].used_cnt++;
+        CACHE_UNLOCK();
+        return &entries[id];
+    }
+
+    cache_stat.miss_cnt++;
+
+    /*Get the glyph to see how much room it needs*/
+    lv_font_glyph_dsc_t dsc;
+    if(lv_font_get_glyph_dsc(font, &dsc, letter, '\0') == false ||
+       (dsc.bpp != 1 && dsc.bpp != 2 && dsc.bpp != 4 && dsc.bpp != 8)) {
+        CACHE_UNLOCK();
+        return NULL;
+    }
+
+    uint32_t size       = (uint32_t)dsc.box_w * dsc.box_h;
+    const uint8_t * bmp = NULL;
+    if(size != 0) {
+        bmp = lv_font_get_glyph_bitmap(font, letter);
+        if(bmp == NULL || size > LV_GLYPH_CACHE_SIZE) {
+            CACHE_UNLOCK();
+            return NULL;
+        }
+    }
+
+    /*Drop the least recently used letters until the new one fits*/
+    id = lru_tail;
+    while(cache_stat.used_size + size > LV_GLYPH_CACHE_SIZE && id != ENTRY_NONE) {
+        uint16_t prev = entries[id].lru_prev;
+        if(entries[id].font != NULL && entries[id].used_cnt == 0) {
+            entry_drop(id);
+            cache_stat.drop_cnt++;
+        }
+        id = prev;
+    }
+
+    /*Reuse the least recently used entry which is not drawn now*/
+    for(id = lru_tail; id != ENTRY_NONE; id = entries[id].lru_prev) {
+        if(entries[id].used_cnt == 0) break;
+    }
+
+    if(id == ENTRY_NONE || cache_stat.used_size + size > LV_GLYPH_CACHE_SIZE) {
+        CACHE_UNLOCK();
+        return NULL; /*All letters are being drawn*/
+    }
+
+    if(entries[id].font != NULL) {
+        entry_drop(id);
+        cache_stat.drop_cnt++;
+    }
+
+    lv_glyph_cache_entry_t * e = &entries[id];
+    e->map                     = NULL;
+    if(size != 0) {
+        e->map = lv_mem_alloc(size);
+        if(e->map == NULL) {
+            LV_LOG_WARN("lv_glyph_cache_get: out of memory");
+            CACHE_UNLOCK();
+            return NULL;
+        }
+        decode(e->map, bmp, &dsc);
+    }
+
+    e->font     = font;
+    e->letter   = letter;
+    e->dsc      = dsc;
+    e->dsc.bpp  = 8;
+    e->used_cnt = 1;
+
+    e->hash_next     = hash_table[hash];
+    hash_table[hash] = id;
+
+    lru_remove(id);
+    lru_add_head(id);
+
+    cache_stat.used_size += size;
+    cache_stat.entry_cnt++;
+
+    CACHE_UNLOCK();
+    return e;
+}
+
+/**
+ * Give back an entry got from `lv_glyph_cache_get`.
+ * @param entry pointer to a cache entry
+ */
+void lv_glyph_cache_release(lv_glyph_cache_entry_t * entry)
+{
+    CACHE_LOCK();
+    if(entry->used_cnt > 0) entry->used_cnt--;
+    CACHE_UNLOCK();
+}
+
+/**
+ * Drop the letters of a font from the cache.
+ * Should be called if a font is deleted or changed.
+ * @param font pointer to a font or NULL to drop all letters
+ */
+void lv_glyph_cache_invalidate(const lv_font_t * font)
+{
+    CACHE_LOCK();
+    uint16_t i;
+    for(i = 0; i < LV_GLYPH_CACHE_CNT; i++) {
+        if(entries[i].font == NULL || entries[i].used_cnt != 0) continue;
+        if(font == NULL || entries[i].font == font) entry_drop(i);
+    }
+    CACHE_UNLOCK();
+}
+
+/**
+ * Give information about the glyph cache
+ * @param mon_p pointer to a monitor variable to store the result
+ */
+void lv_glyph_cache_monitor(lv_glyph_cache_monitor_t * mon_p)
+{
+    CACHE_LOCK();
+    *mon_p = cache_stat;
+    CACHE_UNLOCK();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t get_hash(const lv_font_t * font, uint32_t letter)
+{
+    uint32_t h = (uint32_t)((lv_uintptr_t)font >> 4);
+    h          = (h * 31 + letter) * 2654435761U; /*Spread the close letters*/
+    return (h >> 8) % LV_GLYPH_CACHE_CNT;
+}
+
+static void lru_remove(uint16_t id)
+{
+    lv_glyph_cache_entry_t * e = &entries[id];
+    if(e->lru_prev != ENTRY_NONE)
+        entries[e->lru_prev].lru_next = e->lru_next;
+    else
+        lru_head = e->lru_next;
+
+    if(e->lru_next != ENTRY_NONE)
+        entries[e->lru_next].lru_prev = e->lru_prev;
+    else
+        lru_tail = e->lru_prev;
+}
+
+static void lru_add_head(uint16_t id)
+{
+    entries[id].lru_prev = ENTRY_NONE;
+    entries[id].lru_next = lru_head;
+    if(lru_head != ENTRY_NONE) entries[lru_head].lru_prev = id;
+    lru_head = id;
+    if(lru_tail == ENTRY_NONE) lru_tail = id;
+}
+
+static void lru_add_tail(uint16_t id)
+{
+    entries[id].lru_next = ENTRY_NONE;
+    entries[id].lru_prev = lru_tail;
+    if(lru_tail != ENTRY_NONE) entries[lru_tail].lru_next = id;
+    lru_tail = id;
+    if(lru_head == ENTRY_NONE) lru_head = id;
+}
+
+/**
+ * Remove a letter from the cache and move its entry to the end of the LRU list to reuse it first
+ * @param id index of an entry with a letter
+ */
+static void entry_drop(uint16_t id)
+{
+    lv_glyph_cache_entry_t * e = &entries[id];
+
+    /*Unlink from the hash bucket*/
+    uint16_t * link = &hash_table[get_hash(e->font, e->letter)];
+    while(*link != id) link = &entries[*link].hash_next;
+    *link = e->hash_next;
+
+    if(e->map) lv_mem_free(e->map);
+    cache_stat.used_size -= (uint32_t)e->dsc.box_w * e->dsc.box_h;
+    cache_stat.entry_cnt--;
+
+    e->font      = NULL;
+    e->map       = NULL;
+    e->hash_next = ENTRY_NONE;
+
+    lru_remove(id);
+    lru_add_tail(id);
+}
+
+/**
+ * Decode a glyph bitmap to 8 bit opacities
+ * @param dest store the `box_w * box_h` opacities here
+ * @param src the glyph's bitmap from the font
+ * @param dsc the glyph's descriptor
+ */
+static void decode(uint8_t * dest, const uint8_t * src, const lv_font_glyph_dsc_t * dsc)
+{
+    /*clang-format off*/
+    static const uint8_t bpp1_opa_table[2]  = {0, 255};          /*Opacity mapping with bpp = 1*/
+    static const uint8_t bpp2_opa_table[4]  = {0, 85, 170, 255}; /*Opacity mapping with bpp = 2*/
+    static const uint8_t bpp4_opa_table[16] = {0,  17, 34,  51,  /*Opacity mapping with bpp = 4*/
+                                               68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255};
+    /*clang-format on*/
+
+    uint32_t px_cnt = (uint32_t)dsc->box_w * dsc->box_h;
+    if(dsc->bpp == 8) {
+        memcpy(dest, src, px_cnt);
+        return;
+    }
+
+    const uint8_t * opa_table;
+    if(dsc->bpp == 1)
+        opa_table = bpp1_opa_table;
+    else if(dsc->bpp == 2)
+        opa_table = bpp2_opa_table;
+    else
+        opa_table = bpp4_opa_table;
+
+    /*The rows are not padded to whole bytes so simply process all pixels*/
+    uint8_t px_mask  = (1 << dsc->bpp) - 1;
+    uint32_t bit_ofs = 0;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) {
+        uint8_t px = (src[bit_ofs >> 3] >> (8 - dsc->bpp - (bit_ofs & 0x7))) & px_mask;
+        dest[i]    = opa_table[px];
+        bit_ofs += dsc->bpp;
+    }
+}
+
+#endif /*LV_GLYPH_CACHE_SIZE != 0*/
@@ -0,0 +1,112 @@
+/**
+ * @file lv_glyph_cache.h
+ *
+ */
+
+#ifndef LV_GLYPH_CACHE_H
+#define LV_GLYPH_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include "../lv_font/lv_font.h"
+
+#if LV_GLYPH_CACHE_SIZE != 0
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * A letter decoded to an 8 bit opacity map
+ */
+typedef struct
+{
+    const lv_font_t * font;  /**< Font of the letter. NULL if the entry is free*/
+    uint32_t letter;         /**< Unicode code point of the letter*/
+    lv_font_glyph_dsc_t dsc; /**< Glyph descriptor. `bpp` is always 8*/
+    uint8_t * map;           /**< `box_w * box_h` opacity values. NULL if the glyph is empty*/
+
+    /*Internal fields*/
+    uint16_t lru_prev;  /*Previous (more recently used) entry*/
+    uint16_t lru_next;  /*Next (less recently used) entry*/
+    uint16_t hash_next; /*Next entry in the same hash bucket*/
+    uint16_t used_cnt;  /*Number of drawings using the entry now. Not dropped until it's 0*/
+} lv_glyph_cache_entry_t;
+
+/**
+ * Statistics of the glyph cache
+ */
+typedef struct
+{
+    uint32_t hit_cnt;    /**< Number of letters found in the cache*/
+    uint32_t miss_cnt;   /**< Number of letters decoded and added to the cache*/
+    uint32_t drop_cnt;   /**< Number of letters dropped to make room for others*/
+    uint32_t used_size;  /**< Size of the opacity maps in bytes*/
+    uint32_t total_size; /**< LV_GLYPH_CACHE_SIZE*/
+    uint16_t entry_cnt;  /**< Number of cached letters*/
+} lv_glyph_cache_monitor_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the glyph cache
+ */
+void lv_glyph_cache_init(void);
+
+/**
+ * Get a letter from the cache. If it's not cached decode it and add it to the cache.
+ * The entry must be given back with `lv_glyph_cache_release` when it's not used anymore.
+ * @param font pointer to a font
+ * @param letter a Unicode code point
+ * @return pointer to the cache entry or NULL if the letter can't be cached
+ *         (no such letter or not enough memory)
+ */
+lv_glyph_cache_entry_t * lv_glyph_cache_get(const lv_font_t * font, uint32_t letter);
+
+/**
+ * Give back an entry got from `lv_glyph_cache_get`.
+ * @param entry pointer to a cache entry
+ */
+void lv_glyph_cache_release(lv_glyph_cache_entry_t * entry);
+
+/**
+ * Drop the letters of a font from the cache.
+ * Should be called if a font is deleted or changed.
+ * @param font pointer to a font or NULL to drop all letters
+ */
+void lv_glyph_cache_invalidate(const lv_font_t * font);
+
+/**
+ * Give information about the glyph cache
+ * @param mon_p pointer to a monitor variable to store the result
+ */
+void lv_glyph_cache_monitor(lv_glyph_cache_monitor_t * mon_p);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_GLYPH_CACHE_SIZE != 0*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_GLYPH_CACHE_H*/
@@ -11,10 +11,15 @@
 #include "../lv_misc/lv_types.h"
 #include "../lv_misc/lv_log.h"
 #include "../lv_misc/lv_utils.h"
+#include "../lv_misc/lv_mem.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
  *********************/
+/*Private use area of Unicode (symbols are usually here)*/
+#define LUT_PUA_FIRST 0xE000
+#define LUT_PUA_LAST  0xF8FF
 
 /**********************
  *      TYPEDEFS
@@ -103,6 +108,107 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     return true;
 }
 
+#if LV_FONT_FMT_TXT_LUT
+/**
+ * Build the direct lookup tables of a font to get the glyph IDs and kerning values without searching.
+ * Should be called once when the font is registered, before it's used to draw.
+ * The code points not covered by the tables are still searched in the character maps.
+ * @param font pointer to a font in LittlevGL's native format
+ * @return true: the tables are built; false: out of memory (the font still works without them)
+ */
+bool lv_font_fmt_txt_build_lut(lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->lut) return true;
+
+    /*Find the part of the private use area which is in the font.
+     * (`fdsc->lut` is still NULL so `get_glyph_dsc_id` searches)*/
+    uint32_t pua_first = 0;
+    uint32_t pua_last  = 0;
+    uint32_t c;
+    for(c = LUT_PUA_FIRST; c <= LUT_PUA_LAST; c++) {
+        if(get_glyph_dsc_id(font, c) == 0) continue;
+        if(pua_first == 0) pua_first = c;
+        pua_last = c;
+    }
+    uint32_t pua_cnt = pua_first ? pua_last - pua_first + 1 : 0;
+
+    /*Give a class to every glyph which is on the left or right side of a kerning pair.
+     * Only the pairs with 8 bit glyph IDs are collected. (Class based kerning is already a table)*/
+    uint8_t left_class[256];
+    uint8_t right_class[256];
+    uint32_t left_cnt  = 0;
+    uint32_t right_cnt = 0;
+    memset(left_class, 0, sizeof(left_class));
+    memset(right_class, 0, sizeof(right_class));
+
+    const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+    if(kdsc && fdsc->kern_classes == 0 && kdsc->glyph_ids_size == 0) {
+        const uint8_t * g_ids = kdsc->glyph_ids;
+        uint32_t i;
+        for(i = 0; i < kdsc->pair_cnt; i++) {
+            if(left_class[g_ids[i * 2]] == 0) left_class[g_ids[i * 2]] = ++left_cnt;
+            if(right_class[g_ids[i * 2 + 1]] == 0) right_class[g_ids[i * 2 + 1]] = ++right_cnt;
+            if(left_cnt == 255 || right_cnt == 255) break; /*Doesn't fit to the class IDs*/
+        }
+
+        if(i != kdsc->pair_cnt) left_cnt = right_cnt = 0;
+    }
+
+    /*Allocate the tables in one block*/
+    uint32_t size = sizeof(lv_font_fmt_txt_lut_t) + pua_cnt * sizeof(uint16_t) + left_cnt * right_cnt;
+    lv_font_fmt_txt_lut_t * lut = lv_mem_alloc(size);
+    if(lut == NULL) {
+        LV_LOG_WARN("lv_font_fmt_txt_build_lut: out of memory");
+        return false;
+    }
+
+    uint16_t * pua_gid = (uint16_t *)(lut + 1);
+    int8_t * kern_values = (int8_t *)(pua_gid + pua_cnt);
+
+    for(c = 0; c < 256; c++) lut->low_gid[c] = get_glyph_dsc_id(font, c);
+    for(c = 0; c < pua_cnt; c++) pua_gid[c] = get_glyph_dsc_id(font, pua_first + c);
+    lut->pua_gid   = pua_gid;
+    lut->pua_start = pua_first;
+    lut->pua_cnt   = pua_cnt;
+
+    lut->kern_values    = NULL;
+    lut->kern_left_cnt  = left_cnt;
+    lut->kern_right_cnt = right_cnt;
+    memcpy(lut->kern_left_class, left_class, sizeof(left_class));
+    memcpy(lut->kern_right_class, right_class, sizeof(right_class));
+    if(left_cnt != 0) {
+        uint32_t l;
+        uint32_t r;
+        for(l = 0; l < 256; l++) {
+            if(left_class[l] == 0) continue;
+            for(r = 0; r < 256; r++) {
+                if(right_class[r] == 0) continue;
+                kern_values[(left_class[l] - 1) * right_cnt + (right_class[r] - 1)] = get_kern_value(font, l, r);
+            }
+        }
+        lut->kern_values = kern_values;
+    }
+
+    fdsc->lut = lut;
+
+    return true;
+}
+
+/**
+ * Free the direct lookup tables of a font. Should be called before the font is deleted.
+ * @param font pointer to a font in LittlevGL's native format
+ */
+void lv_font_fmt_txt_free_lut(lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->lut == NULL) return;
+
+    lv_mem_free(fdsc->lut);
+    fdsc->lut = NULL;
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -113,8 +219,22 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
 
-    /*Check the cache first*/
+#if LV_FONT_FMT_TXT_LUT
+    /*Read the glyph ID from the tables if the letter is covered by them*/
+    const lv_font_fmt_txt_lut_t * lut = fdsc->lut;
+    if(lut) {
+        if(letter < 256) return lut->low_gid[letter];
+        if(letter >= LUT_PUA_FIRST && letter <= LUT_PUA_LAST) {
+            uint32_t rcp = letter - lut->pua_start;
+            return rcp < lut->pua_cnt ? lut->pua_gid[rcp] : 0;
+        }
+    }
+#endif
+
+#if LV_REFR_THREADS <= 1
+    /*Check the cache first. (Not with refresh threads because they would overwrite it in parallel)*/
     if(letter == fdsc->last_letter) return fdsc->last_glyph_id;
+#endif
 
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
@@ -150,14 +270,18 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
             }
         }
 
+#if LV_REFR_THREADS <= 1
         /*Update the cache*/
         fdsc->last_letter = letter;
         fdsc->last_glyph_id = glyph_id;
+#endif
         return glyph_id;
     }
 
+#if LV_REFR_THREADS <= 1
     fdsc->last_letter = letter;
     fdsc->last_glyph_id = 0;
+#endif
     return 0;
 
 }
@@ -168,6 +292,19 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
 
     int8_t value = 0;
 
+#if LV_FONT_FMT_TXT_LUT
+    /*Read the value from the class pair table if both glyphs are covered by it*/
+    const lv_font_fmt_txt_lut_t * lut = fdsc->lut;
+    if(lut && lut->kern_values && gid_left < 256 && gid_right < 256) {
+        uint8_t left_class  = lut->kern_left_class[gid_left];
+        uint8_t right_class = lut->kern_right_class[gid_right];
+        if(left_class > 0 && right_class > 0) {
+            value = lut->kern_values[(left_class - 1) * lut->kern_right_cnt + (right_class - 1)];
+        }
+        return value;
+    }
+#endif
+
     if(fdsc->kern_classes == 0) {
         /*Kern pairs*/
         const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
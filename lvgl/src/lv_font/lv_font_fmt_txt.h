@@ -156,6 +156,29 @@ typedef enum {
 }lv_font_fmt_txt_bitmap_format_t;
 
 
+#if LV_FONT_FMT_TXT_LUT
+/*Direct lookup tables of a font. Built by `lv_font_fmt_txt_build_lut()`*/
+typedef struct {
+    /*Glyph ID of the code points 0..255. 0: not in the font*/
+    uint16_t low_gid[256];
+
+    /*Glyph ID of the code points `pua_start .. pua_start + pua_cnt - 1`.
+     * It's the part of the private use area (e.g. symbols) which is in the font*/
+    const uint16_t * pua_gid;
+    uint16_t pua_start;
+    uint16_t pua_cnt;
+
+    /*Kerning of the glyphs with ID < 256 as class pairs:
+     * value = kern_values[(left_class - 1) * kern_right_cnt + (right_class - 1)]
+     * Class 0: the glyph has no kerning. NULL if the font has no such kerning table*/
+    const int8_t * kern_values;
+    uint8_t kern_left_class[256];
+    uint8_t kern_right_class[256];
+    uint8_t kern_left_cnt;
+    uint8_t kern_right_cnt;
+}lv_font_fmt_txt_lut_t;
+#endif
+
 /*Describe store additional data for fonts */
 typedef struct {
     /*The bitmaps os all glyphs*/
@@ -196,6 +219,11 @@ typedef struct {
     uint32_t last_letter;
     uint32_t last_glyph_id;
 
+#if LV_FONT_FMT_TXT_LUT
+    /*Direct lookup tables or NULL if not built*/
+    lv_font_fmt_txt_lut_t * lut;
+#endif
+
 }lv_font_fmt_txt_dsc_t;
 
 /**********************
@@ -220,6 +248,23 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t lett
  */
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter, uint32_t unicode_letter_next);
 
+#if LV_FONT_FMT_TXT_LUT
+/**
+ * Build the direct lookup tables of a font to get the glyph IDs and kerning values without searching.
+ * Should be called once when the font is registered, before it's used to draw.
+ * The code points not covered by the tables are still searched in the character maps.
+ * @param font pointer to a font in LittlevGL's native format
+ * @return true: the tables are built; false: out of memory (the font still works without them)
+ */
+bool lv_font_fmt_txt_build_lut(lv_font_t * font);
+
+/**
+ * Free the direct lookup tables of a font. Should be called before the font is deleted.
+ * @param font pointer to a font in LittlevGL's native format
+ */
+void lv_font_fmt_txt_free_lut(lv_font_t * font);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -81,6 +81,7 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
 #endif
 
     driver->set_px_cb = NULL;
+    driver->wait_cb   = NULL;
 }
 
 /**
@@ -127,13 +128,17 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
     memset(&disp->inv_areas, 0, sizeof(disp->inv_areas));
     lv_ll_init(&disp->scr_ll, sizeof(lv_obj_t));
 
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_ARENA_CNT; i++) lv_draw_arena_init(&disp->draw_arena[i]);
+
     if(disp_def == NULL) disp_def = disp;
 
     lv_disp_t * disp_def_tmp = disp_def;
     disp_def                 = disp; /*Temporarily change the default screen to create the default screens on the
                                         new display*/
 
-    disp->inv_p = 0;
+    disp->inv_p     = 0;
+    disp->refr_task = NULL; /*Created later, `lv_inv_area` shouldn't resume it until then*/
 
     disp->act_scr   = lv_obj_create(NULL, NULL); /*Create a default screen on the display*/
     disp->top_layer = lv_obj_create(NULL, NULL); /*Create top layer on the display*/
@@ -150,6 +155,8 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
     lv_mem_assert(disp->refr_task);
     if(disp->refr_task == NULL) return NULL;
 
+    lv_task_set_name(disp->refr_task, "refr");
+
     lv_task_ready(disp->refr_task); /*Be sure the screen will be refreshed immediately on start up*/
 
     return disp;
@@ -190,6 +197,9 @@ void lv_disp_remove(lv_disp_t * disp)
         indev = lv_indev_get_next(indev);
     }
 
+    uint32_t i;
+    for(i = 0; i < LV_DRAW_ARENA_CNT; i++) lv_draw_arena_deinit(&disp->draw_arena[i]);
+
     lv_ll_rem(&LV_GC_ROOT(_lv_disp_ll), disp);
     lv_mem_free(disp);
 
@@ -22,6 +22,7 @@ extern "C" {
 #include "../lv_misc/lv_area.h"
 #include "../lv_misc/lv_ll.h"
 #include "../lv_misc/lv_task.h"
+#include "../lv_draw/lv_draw_arena.h"
 
 /*********************
  *      DEFINES
@@ -98,6 +99,10 @@ typedef struct _disp_drv_t
      * number of flushed pixels */
     void (*monitor_cb)(struct _disp_drv_t * disp_drv, uint32_t time, uint32_t px);
 
+    /** OPTIONAL: Called repeatedly while LittlevGL waits for a flush to finish instead of busy
+     * waiting. It can block (e.g. on a condition variable) until `lv_disp_flush_ready()` is called*/
+    void (*wait_cb)(struct _disp_drv_t * disp_drv);
+
 #if LV_USE_GPU
     /** OPTIONAL: Blend two memories using opacity (GPU only)*/
     void (*gpu_blend_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length,
@@ -143,6 +148,9 @@ typedef struct _disp_t
     uint8_t inv_area_joined[LV_INV_BUF_SIZE];
     uint32_t inv_p : 10;
 
+    /** Scratch memory of the drawing functions (one for every refresh thread)*/
+    lv_draw_arena_t draw_arena[LV_DRAW_ARENA_CNT];
+
     /*Miscellaneous data*/
     uint32_t last_activity_time; /**< Last time there was activity on this display */
 } lv_disp_t;
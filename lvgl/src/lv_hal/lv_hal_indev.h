@@ -102,6 +102,10 @@ typedef struct _lv_indev_drv_t
 
     /**< Repeated trigger period in long press [ms] */
     uint16_t long_press_rep_time;
+
+    /**< 1: read the device when `lv_indev_trig_read` is called (e.g. its file became readable)
+     * and periodically only while it's pressed or dragged; 0: read it periodically*/
+    uint8_t read_on_event : 1;
 } lv_indev_drv_t;
 
 /** Run time data of input devices
@@ -17,6 +17,8 @@
 
 #if LV_TICK_CUSTOM == 1
 #include LV_TICK_CUSTOM_INCLUDE
+#elif LV_TICK_MONOTONIC
+#include <time.h>
 #endif
 
 /*********************
@@ -36,6 +38,9 @@
  **********************/
 static uint32_t sys_time = 0;
 static volatile uint8_t tick_irq_flag;
+#if LV_TICK_CUSTOM == 0 && LV_TICK_MONOTONIC
+static uint64_t start_us; /*Clock time of the first call (in `lv_init`)*/
+#endif
 
 /**********************
  *      MACROS
@@ -61,7 +66,10 @@ LV_ATTRIBUTE_TICK_INC void lv_tick_inc(uint32_t tick_period)
  */
 uint32_t lv_tick_get(void)
 {
-#if LV_TICK_CUSTOM == 0
+#if LV_TICK_CUSTOM == 0 && LV_TICK_MONOTONIC
+    /*Always calculated from the clock so there is no error to accumulate*/
+    return (uint32_t)(lv_tick_get_us() / 1000);
+#elif LV_TICK_CUSTOM == 0
     uint32_t result;
     do {
         tick_irq_flag = 1;
@@ -95,6 +103,42 @@ uint32_t lv_tick_elaps(uint32_t prev_tick)
     return prev_tick;
 }
 
+/**
+ * Get the elapsed microseconds since start up, e.g. for profiling.
+ * It has microsecond resolution only with `LV_TICK_MONOTONIC`, else it's `lv_tick_get() * 1000`.
+ * @return the elapsed microseconds
+ */
+uint64_t lv_tick_get_us(void)
+{
+#if LV_TICK_CUSTOM == 0 && LV_TICK_MONOTONIC
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+
+    if(start_us == 0) start_us = now_us;
+    return now_us - start_us;
+#else
+    return (uint64_t)lv_tick_get() * 1000;
+#endif
+}
+
+/**
+ * Get the elapsed microseconds since a previous time stamp
+ * @param prev_us a previous time stamp (return value of `lv_tick_get_us()`)
+ * @return the elapsed microseconds since 'prev_us'
+ */
+uint64_t lv_tick_elaps_us(uint64_t prev_us)
+{
+    uint64_t act_us = lv_tick_get_us();
+
+#if LV_TICK_CUSTOM == 1 || LV_TICK_MONOTONIC == 0
+    /*Derived from the millisecond tick which overflows after `UINT32_MAX` ms*/
+    if(act_us < prev_us) act_us += ((uint64_t)UINT32_MAX + 1) * 1000;
+#endif
+
+    return act_us - prev_us;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -59,6 +59,20 @@ uint32_t lv_tick_get(void);
  */
 uint32_t lv_tick_elaps(uint32_t prev_tick);
 
+/**
+ * Get the elapsed microseconds since start up, e.g. for profiling.
+ * It has microsecond resolution only with `LV_TICK_MONOTONIC`, else it's `lv_tick_get() * 1000`.
+ * @return the elapsed microseconds
+ */
+uint64_t lv_tick_get_us(void);
+
+/**
+ * Get the elapsed microseconds since a previous time stamp
+ * @param prev_us a previous time stamp (return value of `lv_tick_get_us()`)
+ * @return the elapsed microseconds since 'prev_us'
+ */
+uint64_t lv_tick_elaps_us(uint64_t prev_us);
+
 /**********************
  *      MACROS
  **********************/
@@ -41,6 +41,7 @@ static bool anim_ready_handler(lv_anim_t * a);
  **********************/
 static uint32_t last_task_run;
 static bool anim_list_changed;
+static lv_task_t * anim_task_p;
 
 /**********************
  *      MACROS
@@ -57,7 +58,11 @@ void lv_anim_core_init(void)
 {
     lv_ll_init(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
     last_task_run = lv_tick_get();
-    lv_task_create(anim_task, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, NULL);
+    anim_task_p   = lv_task_create(anim_task, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, NULL);
+    lv_task_set_name(anim_task_p, "anim");
+
+    /*Paused while there are no animations*/
+    lv_task_pause(anim_task_p);
 }
 
 /**
@@ -99,6 +104,13 @@ void lv_anim_create(lv_anim_t * a)
     /*Set the start value*/
     if(new_anim->exec_cb) new_anim->exec_cb(new_anim->var, new_anim->start);
 
+    /*Start the animation task again. The time while it was paused doesn't count.*/
+    if(anim_task_p->paused) {
+        last_task_run = lv_tick_get();
+        lv_task_reset(anim_task_p);
+        lv_task_resume(anim_task_p);
+    }
+
     /* Creating an animation changed the linked list.
      * It's important if it happens in a ready callback. (see `anim_task`)*/
     anim_list_changed = true;
@@ -384,7 +396,9 @@ static void anim_task(lv_task_t * param)
         a->has_run = 0;
     }
 
-    uint32_t elaps = lv_tick_elaps(last_task_run);
+    /*Measure from the start of the previous call so the time of the callbacks is not lost*/
+    uint32_t task_start = lv_tick_get();
+    uint32_t elaps      = task_start - last_task_run; /*Unsigned, so correct after an overflow too*/
 
     a = lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
 
@@ -422,7 +436,10 @@ static void anim_task(lv_task_t * param)
             a = lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
     }
 
-    last_task_run = lv_tick_get();
+    last_task_run = task_start;
+
+    /*Don't wake up the task handler while there is nothing to animate*/
+    if(lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL) lv_task_pause(param);
 }
 
 /**
@@ -326,8 +326,15 @@ static inline uint32_t lv_color_to32(lv_color_t color)
 static inline lv_color_t lv_color_mix(lv_color_t c1, lv_color_t c2, uint8_t mix)
 {
     lv_color_t ret;
-#if LV_COLOR_DEPTH != 1
-    /*LV_COLOR_DEPTH == 8, 16 or 32*/
+#if LV_COLOR_DEPTH == 32
+    /*Mix two channels with one multiplication. The channels are in every second byte
+     *so the 16 bit results of `c * mix` can't overflow into each other*/
+    uint32_t rb = (c1.full & 0x00FF00FF) * mix + (c2.full & 0x00FF00FF) * (255 - mix);
+    uint32_t ga = ((c1.full >> 8) & 0x00FF00FF) * mix + ((c2.full >> 8) & 0x00FF00FF) * (255 - mix);
+    ret.full     = ((rb >> 8) & 0x00FF00FF) | (ga & 0xFF00FF00);
+    ret.ch.alpha = 0xFF;
+#elif LV_COLOR_DEPTH != 1
+    /*LV_COLOR_DEPTH == 8 or 16*/
     ret.ch.red = (uint16_t)((uint16_t)c1.ch.red * mix + (c2.ch.red * (255 - mix))) >> 8;
 #if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP
     /*If swapped Green is in 2 parts*/
@@ -340,9 +347,6 @@ static inline lv_color_t lv_color_mix(lv_color_t c1, lv_color_t c2, uint8_t mix)
     ret.ch.green = (uint16_t)((uint16_t)c1.ch.green * mix + (c2.ch.green * (255 - mix))) >> 8;
 #endif
     ret.ch.blue = (uint16_t)((uint16_t)c1.ch.blue * mix + (c2.ch.blue * (255 - mix))) >> 8;
-#if LV_COLOR_DEPTH == 32
-    ret.ch.alpha = 0xFF;
-#endif
 #else
     /*LV_COLOR_DEPTH == 1*/
     ret.full = mix > LV_OPA_50 ? c1.full : c2.full;
@@ -24,6 +24,7 @@ extern "C" {
 #include <stdbool.h>
 #include "lv_mem.h"
 #include "lv_ll.h"
+#include "lv_task.h"
 #include "../lv_draw/lv_img_cache.h"
 
 /*********************
@@ -41,7 +42,7 @@ extern "C" {
     prefix lv_ll_t _lv_img_defoder_ll;                                                                                 \
     prefix lv_img_cache_entry_t * _lv_img_cache_array;                                                                 \
     prefix void * _lv_task_act;                                                                                        \
-    prefix void * _lv_draw_buf; 
+    prefix lv_task_t ** _lv_task_heap[_LV_TASK_PRIO_NUM]; /*The tasks of every priority ordered by their next run*/
 
 #define LV_NO_PREFIX
 #define LV_ROOTS LV_GC_ROOTS(LV_NO_PREFIX)
@@ -2,6 +2,13 @@
  * @file lv_mem.c
  * General and portable implementation of malloc and free.
  * The dynamic memory monitoring is also supported.
+ *
+ * The built-in allocator is a TLSF (Two-Level Segregated Fit) allocator:
+ * the free blocks are stored in lists by size classes and bitmaps tell which lists are not empty,
+ * so allocation and free take constant time independently of the number of blocks.
+ * The adjacent free blocks are joined immediately on free.
+ * If `LV_MEM_REGION_SIZE` is set new memory regions are mapped when the work memory is full.
+ * If `LV_MEM_SLAB_MAX` is set the small memories are allocated from slabs of same sized items.
  */
 
 /*********************
@@ -9,12 +16,30 @@
  *********************/
 #include "lv_mem.h"
 #include "lv_math.h"
+#include "lv_types.h"
+#include <stdbool.h>
 #include <string.h>
 
 #if LV_MEM_CUSTOM != 0
 #include LV_MEM_CUSTOM_INCLUDE
 #endif
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_REGION_SIZE != 0
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if LV_REFR_THREADS > 1
+#include <pthread.h>
+#endif
+
+/*Define the real allocator functions here, not the tracing ones*/
+#if LV_MEM_TRACE
+#undef lv_mem_alloc
+#undef lv_mem_free
+#undef lv_mem_realloc
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -27,11 +52,111 @@
 #define MEM_UNIT uint32_t
 #endif
 
+#if LV_MEM_CUSTOM == 0
+/*The size of the blocks is aligned to the size of a pointer*/
+#if UINTPTR_MAX > 0xFFFFFFFFU
+#define ALIGN_LOG2 3
+#else
+#define ALIGN_LOG2 2
+#endif
+#define ALIGN_SIZE (1U << ALIGN_LOG2)
+
+/*Number of second level size classes in a first level class*/
+#define SL_CNT_LOG2 4
+#define SL_CNT (1U << SL_CNT_LOG2)
+
+/*The blocks smaller than this are in the first first level class, in linear steps of `ALIGN_SIZE`*/
+#define FL_SHIFT (SL_CNT_LOG2 + ALIGN_LOG2)
+#define SMALL_BLOCK_SIZE (1U << FL_SHIFT)
+
+/*Number of first level size classes. The largest class contains the blocks up to 2^FL_MAX bytes*/
+#define FL_MAX 31
+#define FL_CNT (FL_MAX - FL_SHIFT + 1)
+
+/*Larger memories are not allocated (the search would round them above 2^FL_MAX)*/
+#define BLOCK_SIZE_MAX (1U << (FL_MAX - 1))
+
+/*Flags in the lower bits of `size`*/
+#define BLOCK_FREE ((lv_uintptr_t)1)
+#define BLOCK_PREV_FREE ((lv_uintptr_t)2)
+
+/*A used block costs only its `size` field. `prev_phys` is in the end of the previous block*/
+#define BLOCK_OVERHEAD (sizeof(lv_uintptr_t))
+#define BLOCK_DATA_OFS (offsetof(lv_mem_block_t, size) + sizeof(lv_uintptr_t))
+
+/*A free block has to store `next_free`, `prev_free` and the next block's `prev_phys`*/
+#define BLOCK_SIZE_MIN (sizeof(lv_mem_block_t) - sizeof(lv_mem_block_t *))
+
+/*Size of the region header with the unused `prev_phys` of the first block*/
+#define REGION_HEADER_SIZE                                                                                             \
+    ((sizeof(lv_mem_region_t) + sizeof(lv_mem_block_t *) + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1))
+
+#if LV_MEM_SLAB_MAX != 0
+/*Size step of the slab classes*/
+#define SLAB_STEP (2 * ALIGN_SIZE)
+#define SLAB_CLASS_CNT ((LV_MEM_SLAB_MAX + SLAB_STEP - 1) / SLAB_STEP)
+
+/*Size of the chunks of slab items. Much larger than `LV_MEM_SLAB_MAX` so it's allocated as a normal block*/
+#define SLAB_CHUNK_SIZE (4 * SLAB_CLASS_CNT * SLAB_STEP)
+#define SLAB_CHUNK_HEADER_SIZE ((sizeof(lv_mem_slab_chunk_t) + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1))
+
+/* The header of a used slab item (in the place of a block's `size`) points to its chunk and has both flags.
+ * A normal block can't have them as a free block never follows a free block.
+ * The header of a free slab item is `BLOCK_FREE`*/
+#define SLAB_ITEM_MARK (BLOCK_FREE | BLOCK_PREV_FREE)
+#endif
+#endif
+
+/*The refresh threads can allocate too (e.g. image decoders)*/
+#if LV_REFR_THREADS > 1
+#define MEM_LOCK() pthread_mutex_lock(&mem_mutex)
+#define MEM_UNLOCK() pthread_mutex_unlock(&mem_mutex)
+#else
+#define MEM_LOCK()
+#define MEM_UNLOCK()
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
 
-#if LV_ENABLE_GC == 0 /*gc custom allocations must not include header*/
+#if LV_MEM_CUSTOM == 0
+
+/**
+ * Header of a memory block. Only `size` is valid in used blocks, the other fields overlap with data.
+ */
+typedef struct _lv_mem_block_t
+{
+    struct _lv_mem_block_t * prev_phys; /*Previous block in the memory. Valid only if it's free*/
+    lv_uintptr_t size;                  /*Size of the data in bytes, `BLOCK_FREE` and `BLOCK_PREV_FREE`*/
+    struct _lv_mem_block_t * next_free; /*Next block in the free list. Valid only in free blocks*/
+    struct _lv_mem_block_t * prev_free; /*Previous block in the free list. Valid only in free blocks*/
+} lv_mem_block_t;
+
+/**
+ * Header of a memory region. The blocks of the region follow it and a used 0 sized block closes it.
+ */
+typedef struct _lv_mem_region_t
+{
+    struct _lv_mem_region_t * next; /*Next region*/
+    uint32_t size;                  /*Size of the region in bytes with the header*/
+    uint8_t mapped;                 /*1: added with `mmap` so it can be given back*/
+} lv_mem_region_t;
+
+/**
+ * A chunk of same sized slab items. The items follow the header: a pointer sized header and the data.
+ */
+typedef struct _lv_mem_slab_chunk_t
+{
+    struct _lv_mem_slab_chunk_t * next; /*Next chunk of the class with free items*/
+    struct _lv_mem_slab_chunk_t * prev; /*Previous chunk of the class with free items*/
+    void * free_item;                   /*Data of the first free item. The next one is stored in its data*/
+    uint32_t item_size;                 /*Data size of the items*/
+    uint16_t item_cnt;                  /*Number of items*/
+    uint16_t used_cnt;                  /*Number of used items*/
+} lv_mem_slab_chunk_t;
+
+#elif LV_ENABLE_GC == 0 /*gc custom allocations must not include header*/
 
 /*The size of this union must be 4 bytes (uint32_t)*/
 typedef union
@@ -50,29 +175,81 @@ typedef struct
     uint8_t first_data; /*First data byte in the allocated data (Just for easily create a pointer)*/
 } lv_mem_ent_t;
 
-#endif /* LV_ENABLE_GC */
+#endif /* LV_MEM_CUSTOM */
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_MEM_CUSTOM == 0
-static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e);
-static void * ent_alloc(lv_mem_ent_t * e, uint32_t size);
-static void ent_trunc(lv_mem_ent_t * e, uint32_t size);
+static lv_mem_region_t * region_add(void * mem, uint32_t size, bool mapped);
+static void region_monitor(const lv_mem_region_t * r, lv_mem_monitor_t * mon_p);
+static void monitor_calc_pct(lv_mem_monitor_t * mon_p);
+#if LV_MEM_REGION_SIZE != 0
+static bool region_grow(uint32_t size);
+static bool region_release(lv_mem_block_t * b);
+#endif
+#if LV_MEM_SLAB_MAX != 0
+static void * slab_alloc(uint32_t size);
+static void slab_free(lv_mem_block_t * b);
+static lv_mem_slab_chunk_t * slab_chunk_new(uint32_t item_size);
+#endif
+static void * block_alloc(uint32_t size);
+static void block_free(lv_mem_block_t * b);
+static bool block_realloc_in_place(lv_mem_block_t * b, uint32_t size);
+static uint32_t adjust_size(uint32_t size);
+static uint32_t bit_ffs(uint32_t w);
+static uint32_t bit_fls(uint32_t w);
+static void mapping_insert(uint32_t size, uint32_t * fl, uint32_t * sl);
+static void mapping_search(uint32_t size, uint32_t * fl, uint32_t * sl);
+static lv_mem_block_t * find_suitable(uint32_t * fl, uint32_t * sl);
+static void list_remove(lv_mem_block_t * b, uint32_t fl, uint32_t sl);
+static void list_insert(lv_mem_block_t * b, uint32_t fl, uint32_t sl);
+static void block_remove(lv_mem_block_t * b);
+static void block_insert(lv_mem_block_t * b);
+static lv_mem_block_t * block_split(lv_mem_block_t * b, uint32_t size);
+static lv_mem_block_t * block_absorb(lv_mem_block_t * prev, lv_mem_block_t * b);
+static lv_mem_block_t * merge_prev(lv_mem_block_t * b);
+static lv_mem_block_t * merge_next(lv_mem_block_t * b);
+static void trim_free(lv_mem_block_t * b, uint32_t size);
+static void trim_used(lv_mem_block_t * b, uint32_t size);
 #endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 #if LV_MEM_CUSTOM == 0
-static uint8_t * work_mem;
+static lv_mem_region_t * region_first;              /*The work memory. The added regions are linked to it*/
+static uint32_t fl_bitmap;                          /*Bit `fl` is set if a list in `free_lists[fl]` is not empty*/
+static uint32_t sl_bitmap[FL_CNT];                  /*Bit `sl` is set if `free_lists[fl][sl]` is not empty*/
+static lv_mem_block_t * free_lists[FL_CNT][SL_CNT]; /*Free blocks by size class*/
+#if LV_MEM_REGION_SIZE != 0
+static lv_mem_region_t * region_spare; /*An empty added region kept to not map and unmap regions too often*/
+static uint32_t region_total_size;     /*Size of all the regions*/
+#endif
+#if LV_MEM_SLAB_MAX != 0
+static lv_mem_slab_chunk_t * slab_partial[SLAB_CLASS_CNT]; /*Chunks with free items by size class*/
+#endif
 #endif
 
 static uint32_t zero_mem; /*Give the address of this variable if 0 byte should be allocated*/
 
+#if LV_REFR_THREADS > 1
+static pthread_mutex_t mem_mutex; /*Recursive because `lv_mem_realloc` calls alloc and free*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
+#if LV_MEM_CUSTOM == 0
+#define BLOCK_SIZE(b) ((uint32_t)((b)->size & ~(BLOCK_FREE | BLOCK_PREV_FREE)))
+#define BLOCK_DATA(b) ((void *)((uint8_t *)(b) + BLOCK_DATA_OFS))
+#define BLOCK_NEXT(b) ((lv_mem_block_t *)((uint8_t *)(b) + BLOCK_OVERHEAD + BLOCK_SIZE(b)))
+#define REGION_FIRST(r) ((lv_mem_block_t *)((uint8_t *)(r) + REGION_HEADER_SIZE - BLOCK_OVERHEAD))
+#if LV_MEM_SLAB_MAX != 0
+#define SLAB_IS_ITEM(b) (((b)->size & SLAB_ITEM_MARK) == SLAB_ITEM_MARK)
+#define SLAB_CHUNK(b) ((lv_mem_slab_chunk_t *)((b)->size & ~SLAB_ITEM_MARK))
+#endif
+#endif
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -83,20 +260,40 @@ static uint32_t zero_mem; /*Give the address of this variable if 0 byte should b
  */
 void lv_mem_init(void)
 {
+#if LV_REFR_THREADS > 1
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mem_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+#endif
+
 #if LV_MEM_CUSTOM == 0
 
 #if LV_MEM_ADR == 0
     /*Allocate a large array to store the dynamically allocated data*/
     static LV_MEM_ATTR MEM_UNIT work_mem_int[LV_MEM_SIZE / sizeof(MEM_UNIT)];
-    work_mem = (uint8_t *)work_mem_int;
+    uint8_t * work_mem = (uint8_t *)work_mem_int;
 #else
-    work_mem = (uint8_t *)LV_MEM_ADR;
+    uint8_t * work_mem = (uint8_t *)LV_MEM_ADR;
 #endif
 
-    lv_mem_ent_t * full = (lv_mem_ent_t *)work_mem;
-    full->header.s.used = 0;
-    /*The total mem size id reduced by the first header and the close patterns */
-    full->header.s.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+    memset(sl_bitmap, 0, sizeof(sl_bitmap));
+    memset(free_lists, 0, sizeof(free_lists));
+    fl_bitmap = 0;
+#if LV_MEM_SLAB_MAX != 0
+    memset(slab_partial, 0, sizeof(slab_partial));
+#endif
+#if LV_MEM_REGION_SIZE != 0
+    region_spare      = NULL;
+    region_total_size = 0;
+#endif
+    region_first = NULL;
+    region_first = region_add(work_mem, LV_MEM_SIZE, false);
+#endif
+
+#if LV_MEM_TRACE
+    lv_mem_trace_init();
 #endif
 }
 
@@ -126,22 +323,11 @@ void * lv_mem_alloc(uint32_t size)
 #endif
     void * alloc = NULL;
 
+    MEM_LOCK();
+
 #if LV_MEM_CUSTOM == 0
     /*Use the built-in allocators*/
-    lv_mem_ent_t * e = NULL;
-
-    /* Search for a appropriate entry*/
-    do {
-        /* Get the next entry*/
-        e = ent_get_next(e);
-
-        /*If there is next entry then try to allocate there*/
-        if(e != NULL) {
-            alloc = ent_alloc(e, size);
-        }
-        /* End if there is not next entry OR the alloc. is successful*/
-    } while(e != NULL && alloc == NULL);
-
+    alloc = block_alloc(size);
 #else
 /*Use custom, user defined malloc function*/
 #if LV_ENABLE_GC == 1 /*gc must not include header*/
@@ -158,6 +344,8 @@ void * lv_mem_alloc(uint32_t size)
 #endif                /* LV_ENABLE_GC */
 #endif                /* LV_MEM_CUSTOM */
 
+    MEM_UNLOCK();
+
 #if LV_MEM_ADD_JUNK
     if(alloc != NULL) memset(alloc, 0xaa, size);
 #endif
@@ -180,34 +368,25 @@ void lv_mem_free(const void * data)
     memset((void *)data, 0xbb, lv_mem_get_size(data));
 #endif
 
+    MEM_LOCK();
+
+#if LV_MEM_CUSTOM == 0
+    block_free((lv_mem_block_t *)((uint8_t *)data - BLOCK_DATA_OFS));
+#else /*Use custom, user defined free function*/
 #if LV_ENABLE_GC == 0
     /*e points to the header*/
     lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
     e->header.s.used = 0;
 #endif
 
-#if LV_MEM_CUSTOM == 0
-#if LV_MEM_AUTO_DEFRAG
-    /* Make a simple defrag.
-     * Join the following free entries after this*/
-    lv_mem_ent_t * e_next;
-    e_next = ent_get_next(e);
-    while(e_next != NULL) {
-        if(e_next->header.s.used == 0) {
-            e->header.s.d_size += e_next->header.s.d_size + sizeof(e->header);
-        } else {
-            break;
-        }
-        e_next = ent_get_next(e_next);
-    }
-#endif
-#else /*Use custom, user defined free function*/
 #if LV_ENABLE_GC == 0
     LV_MEM_CUSTOM_FREE(e);
 #else
     LV_MEM_CUSTOM_FREE((void *)data);
 #endif /*LV_ENABLE_GC*/
 #endif
+
+    MEM_UNLOCK();
 }
 
 /**
@@ -222,23 +401,37 @@ void lv_mem_free(const void * data)
 
 void * lv_mem_realloc(void * data_p, uint32_t new_size)
 {
+    MEM_LOCK();
+
     /*data_p could be previously freed pointer (in this case it is invalid)*/
-    if(data_p != NULL) {
+    if(data_p != NULL && data_p != &zero_mem) {
+#if LV_MEM_CUSTOM == 0
+        lv_mem_block_t * b = (lv_mem_block_t *)((uint8_t *)data_p - BLOCK_DATA_OFS);
+        if((b->size & (BLOCK_FREE | BLOCK_PREV_FREE)) == BLOCK_FREE) {
+            data_p = NULL;
+        }
+#else
         lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
         if(e->header.s.used == 0) {
             data_p = NULL;
         }
+#endif
     }
 
     uint32_t old_size = lv_mem_get_size(data_p);
-    if(old_size == new_size) return data_p; /*Also avoid reallocating the same memory*/
+    if(old_size == new_size) {
+        MEM_UNLOCK();
+        return data_p; /*Also avoid reallocating the same memory*/
+    }
 
 #if LV_MEM_CUSTOM == 0
-    /* Truncate the memory if the new size is smaller. */
-    if(new_size < old_size) {
-        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
-        ent_trunc(e, new_size);
-        return &e->first_data;
+    /* Truncate the memory if the new size is smaller or grow it if the next block is free*/
+    if(old_size != 0 && new_size != 0) {
+        lv_mem_block_t * b = (lv_mem_block_t *)((uint8_t *)data_p - BLOCK_DATA_OFS);
+        if(block_realloc_in_place(b, new_size)) {
+            MEM_UNLOCK();
+            return data_p;
+        }
     }
 #endif
 
@@ -253,6 +446,8 @@ void * lv_mem_realloc(void * data_p, uint32_t new_size)
         }
     }
 
+    MEM_UNLOCK();
+
     if(new_p == NULL) LV_LOG_WARN("Couldn't allocate memory");
 
     return new_p;
@@ -274,41 +469,7 @@ void * lv_mem_realloc(void * data_p, uint32_t new_size)
  */
 void lv_mem_defrag(void)
 {
-#if LV_MEM_CUSTOM == 0
-    lv_mem_ent_t * e_free;
-    lv_mem_ent_t * e_next;
-    e_free = ent_get_next(NULL);
-
-    while(1) {
-        /*Search the next free entry*/
-        while(e_free != NULL) {
-            if(e_free->header.s.used != 0) {
-                e_free = ent_get_next(e_free);
-            } else {
-                break;
-            }
-        }
-
-        if(e_free == NULL) return;
-
-        /*Joint the following free entries to the free*/
-        e_next = ent_get_next(e_free);
-        while(e_next != NULL) {
-            if(e_next->header.s.used == 0) {
-                e_free->header.s.d_size += e_next->header.s.d_size + sizeof(e_next->header);
-            } else {
-                break;
-            }
-
-            e_next = ent_get_next(e_next);
-        }
-
-        if(e_next == NULL) return;
-
-        /*Continue from the lastly checked entry*/
-        e_free = e_next;
-    }
-#endif
+    /*The built-in allocator joins the free blocks immediately on free so nothing to do here*/
 }
 
 /**
@@ -321,28 +482,42 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
     /*Init the data*/
     memset(mon_p, 0, sizeof(lv_mem_monitor_t));
 #if LV_MEM_CUSTOM == 0
-    lv_mem_ent_t * e;
-    e = NULL;
-
-    e = ent_get_next(e);
+    MEM_LOCK();
+    lv_mem_region_t * r;
+    for(r = region_first; r != NULL; r = r->next) {
+        region_monitor(r, mon_p);
+    }
+    MEM_UNLOCK();
 
-    while(e != NULL) {
-        if(e->header.s.used == 0) {
-            mon_p->free_cnt++;
-            mon_p->free_size += e->header.s.d_size;
-            if(e->header.s.d_size > mon_p->free_biggest_size) {
-                mon_p->free_biggest_size = e->header.s.d_size;
-            }
-        } else {
-            mon_p->used_cnt++;
-        }
+    monitor_calc_pct(mon_p);
+#endif
+}
 
-        e = ent_get_next(e);
+/**
+ * Give information about one region of the work memory.
+ * The first region is the work memory, the others are added when it's full (see `LV_MEM_REGION_SIZE`)
+ * @param region_id index of the region (< `region_cnt` from `lv_mem_monitor`)
+ * @param mon_p pointer to a dm_mon_p variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_monitor_region(uint16_t region_id, lv_mem_monitor_t * mon_p)
+{
+    /*Init the data*/
+    memset(mon_p, 0, sizeof(lv_mem_monitor_t));
+#if LV_MEM_CUSTOM == 0
+    MEM_LOCK();
+    lv_mem_region_t * r = region_first;
+    while(r != NULL && region_id != 0) {
+        r = r->next;
+        region_id--;
     }
-    mon_p->total_size = LV_MEM_SIZE;
-    mon_p->used_pct   = 100 - (100U * mon_p->free_size) / mon_p->total_size;
-    mon_p->frag_pct   = (uint32_t)mon_p->free_biggest_size * 100U / mon_p->free_size;
-    mon_p->frag_pct   = 100 - mon_p->frag_pct;
+
+    if(r != NULL) region_monitor(r, mon_p);
+    MEM_UNLOCK();
+
+    monitor_calc_pct(mon_p);
+#else
+    (void)region_id; /*Unused*/
 #endif
 }
 
@@ -359,9 +534,19 @@ uint32_t lv_mem_get_size(const void * data)
     if(data == NULL) return 0;
     if(data == &zero_mem) return 0;
 
+#if LV_MEM_CUSTOM == 0
+    lv_mem_block_t * b = (lv_mem_block_t *)((uint8_t *)data - BLOCK_DATA_OFS);
+
+#if LV_MEM_SLAB_MAX != 0
+    if(SLAB_IS_ITEM(b)) return SLAB_CHUNK(b)->item_size;
+#endif
+
+    return BLOCK_SIZE(b);
+#else
     lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
 
     return e->header.s.d_size;
+#endif
 }
 
 #else /* LV_ENABLE_GC */
@@ -379,86 +564,618 @@ uint32_t lv_mem_get_size(const void * data)
 
 #if LV_MEM_CUSTOM == 0
 /**
- * Give the next entry after 'act_e'
- * @param act_e pointer to an entry
- * @return pointer to an entry after 'act_e'
+ * Add a memory region to the heap
+ * @param mem pointer to the memory
+ * @param size size of the memory in bytes
+ * @param mapped true: the memory was allocated with `mmap`
+ * @return pointer to the header of the region
  */
-static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e)
+static lv_mem_region_t * region_add(void * mem, uint32_t size, bool mapped)
 {
-    lv_mem_ent_t * next_e = NULL;
+    /*Align the start and the size of the memory*/
+    lv_mem_region_t * r = (lv_mem_region_t *)(((lv_uintptr_t)mem + ALIGN_SIZE - 1) & ~((lv_uintptr_t)ALIGN_SIZE - 1));
+    size -= (uint8_t *)r - (uint8_t *)mem;
+    size &= ~(ALIGN_SIZE - 1);
+
+    r->next   = NULL;
+    r->size   = size;
+    r->mapped = mapped ? 1 : 0;
+
+    /*Keep room for the `size` of a closing 0 sized used block*/
+    lv_mem_block_t * b = REGION_FIRST(r);
+    b->size            = (size - REGION_HEADER_SIZE - 2 * BLOCK_OVERHEAD) | BLOCK_FREE;
+    block_insert(b);
+
+    lv_mem_block_t * end = BLOCK_NEXT(b);
+    end->prev_phys       = b;
+    end->size            = BLOCK_PREV_FREE;
+
+    /*Link to the end of the regions*/
+    if(region_first != NULL) {
+        lv_mem_region_t * last = region_first;
+        while(last->next != NULL) last = last->next;
+        last->next = r;
+    }
 
-    if(act_e == NULL) { /*NULL means: get the first entry*/
-        next_e = (lv_mem_ent_t *)work_mem;
-    } else { /*Get the next entry */
-        uint8_t * data = &act_e->first_data;
-        next_e         = (lv_mem_ent_t *)&data[act_e->header.s.d_size];
+#if LV_MEM_REGION_SIZE != 0
+    region_total_size += size;
+#endif
 
-        if(&next_e->first_data >= &work_mem[LV_MEM_SIZE]) next_e = NULL;
+    return r;
+}
+
+/**
+ * Add the statistics of a region to a monitor variable
+ * @param r pointer to a region
+ * @param mon_p pointer to a monitor variable
+ */
+static void region_monitor(const lv_mem_region_t * r, lv_mem_monitor_t * mon_p)
+{
+    mon_p->region_cnt++;
+    mon_p->total_size += r->size;
+
+    /*The last block of the region is a used 0 sized block*/
+    lv_mem_block_t * b = REGION_FIRST(r);
+    while(BLOCK_SIZE(b) != 0) {
+        if(b->size & BLOCK_FREE) {
+            mon_p->free_cnt++;
+            mon_p->free_size += BLOCK_SIZE(b);
+            if(BLOCK_SIZE(b) > mon_p->free_biggest_size) {
+                mon_p->free_biggest_size = BLOCK_SIZE(b);
+            }
+        } else {
+            mon_p->used_cnt++;
+        }
+
+        b = BLOCK_NEXT(b);
     }
+}
+
+/**
+ * Calculate the percentages of a monitor variable from the sizes
+ * @param mon_p pointer to a monitor variable
+ */
+static void monitor_calc_pct(lv_mem_monitor_t * mon_p)
+{
+    if(mon_p->total_size == 0) return;
 
-    return next_e;
+    mon_p->used_pct = 100 - ((uint64_t)100U * mon_p->free_size) / mon_p->total_size;
+    if(mon_p->free_size != 0) {
+        mon_p->frag_pct = ((uint64_t)mon_p->free_biggest_size * 100U) / mon_p->free_size;
+        mon_p->frag_pct = 100 - mon_p->frag_pct;
+    }
 }
 
+#if LV_MEM_REGION_SIZE != 0
 /**
- * Try to do the real allocation with a given size
- * @param e try to allocate to this entry
- * @param size size of the new memory in bytes
- * @return pointer to the allocated memory or NULL if not enough memory in the entry
+ * Map a new region which has a free block for an allocation
+ * @param size the size to allocate (already adjusted)
+ * @return true: a region is added; false: `LV_MEM_MAX_SIZE` is reached or mapping failed
  */
-static void * ent_alloc(lv_mem_ent_t * e, uint32_t size)
+static bool region_grow(uint32_t size)
 {
-    void * alloc = NULL;
+    /*Room for the header, the closing block and rounding up the size to the next size class*/
+    uint32_t need        = size + size / SL_CNT + REGION_HEADER_SIZE + 2 * BLOCK_OVERHEAD;
+    uint32_t region_size = LV_MATH_MAX(need, LV_MEM_REGION_SIZE);
+
+    uint32_t page = (uint32_t)sysconf(_SC_PAGESIZE);
+    region_size   = (region_size + page - 1) & ~(page - 1);
+    if(region_size > LV_MEM_MAX_SIZE - region_total_size) return false;
+
+    void * mem = mmap(NULL, region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mem == MAP_FAILED) return false;
 
-    /*If the memory is free and big enough then use it */
-    if(e->header.s.used == 0 && e->header.s.d_size >= size) {
-        /*Truncate the entry to the desired size */
-        ent_trunc(e, size),
+    region_add(mem, region_size, true);
+    LV_LOG_INFO("New memory region added");
 
-            e->header.s.used = 1;
+    return true;
+}
 
-        /*Save the allocated data*/
-        alloc = &e->first_data;
+/**
+ * Give back a region if a free block fills it. One empty region is kept as a spare.
+ * @param b pointer to a free block before the closing block of its region (not in a list)
+ * @return true: the region is unmapped; false: `b` should be kept
+ */
+static bool region_release(lv_mem_block_t * b)
+{
+    lv_mem_region_t * prev = NULL;
+    lv_mem_region_t * r    = region_first;
+    while(r != NULL && REGION_FIRST(r) != b) {
+        prev = r;
+        r    = r->next;
     }
 
-    return alloc;
+    /*Not the whole region is free or it's the work memory*/
+    if(r == NULL || r->mapped == 0) return false;
+
+    if(region_spare == NULL) {
+        region_spare = r;
+        return false;
+    }
+
+    /*The work memory is the first region so `prev` is never NULL*/
+    prev->next = r->next;
+    region_total_size -= r->size;
+    munmap(r, r->size);
+    LV_LOG_INFO("Empty memory region released");
+
+    return true;
 }
+#endif
 
 /**
- * Truncate the data of entry to the given size
- * @param e Pointer to an entry
- * @param size new size in bytes
+ * Allocate a block from the free lists
+ * @param size size of the memory in bytes
+ * @return pointer to the data of the block or NULL if there is no large enough free block
  */
-static void ent_trunc(lv_mem_ent_t * e, uint32_t size)
+static void * block_alloc(uint32_t size)
 {
-#ifdef LV_MEM_ENV64
-    /*Round the size up to 8*/
-    if(size & 0x7) {
-        size = size & (~0x7);
-        size += 8;
+#if LV_MEM_SLAB_MAX != 0
+    if(size <= LV_MEM_SLAB_MAX) {
+        void * alloc = slab_alloc(size);
+        if(alloc != NULL) return alloc;
+    }
+#endif
+
+    if(size > BLOCK_SIZE_MAX) return NULL;
+
+    size = adjust_size(size);
+
+    uint32_t fl;
+    uint32_t sl;
+    mapping_search(size, &fl, &sl);
+    lv_mem_block_t * b = find_suitable(&fl, &sl);
+
+#if LV_MEM_REGION_SIZE != 0
+    /*Add a new region if there is no large enough free block*/
+    if(b == NULL && region_grow(size)) {
+        mapping_search(size, &fl, &sl);
+        b = find_suitable(&fl, &sl);
+    }
+
+    if(b != NULL && region_spare != NULL && b == REGION_FIRST(region_spare)) region_spare = NULL;
+#endif
+
+    if(b == NULL) return NULL;
+
+    list_remove(b, fl, sl);
+    trim_free(b, size);
+
+    /*Mark as used*/
+    b->size &= ~BLOCK_FREE;
+    BLOCK_NEXT(b)->size &= ~BLOCK_PREV_FREE;
+
+    return BLOCK_DATA(b);
+}
+
+/**
+ * Give back a used block and join it with its free neighbours
+ * @param b pointer to a used block
+ */
+static void block_free(lv_mem_block_t * b)
+{
+#if LV_MEM_SLAB_MAX != 0
+    if(SLAB_IS_ITEM(b)) {
+        slab_free(b);
+        return;
+    }
+#endif
+
+    b->size |= BLOCK_FREE;
+    lv_mem_block_t * next = BLOCK_NEXT(b);
+    next->prev_phys       = b;
+    next->size |= BLOCK_PREV_FREE;
+
+    b = merge_prev(b);
+    b = merge_next(b);
+
+#if LV_MEM_REGION_SIZE != 0
+    /*Give back the region if it became empty*/
+    if(BLOCK_SIZE(BLOCK_NEXT(b)) == 0 && region_release(b)) return;
+#endif
+
+    block_insert(b);
+}
+
+/**
+ * Resize a used block without moving it: truncate it or grow it into the next free block
+ * @param b pointer to a used block
+ * @param size the new size in bytes
+ * @return true: the block is resized; false: there is no room after the block
+ */
+static bool block_realloc_in_place(lv_mem_block_t * b, uint32_t size)
+{
+#if LV_MEM_SLAB_MAX != 0
+    /*The slab items can't be resized, only kept if they are large enough*/
+    if(SLAB_IS_ITEM(b)) return size <= SLAB_CHUNK(b)->item_size;
+#endif
+
+    if(size > BLOCK_SIZE_MAX) return false;
+
+    size = adjust_size(size);
+
+    if(size > BLOCK_SIZE(b)) {
+        lv_mem_block_t * next = BLOCK_NEXT(b);
+        if((next->size & BLOCK_FREE) == 0) return false;
+        if(BLOCK_SIZE(b) + BLOCK_OVERHEAD + BLOCK_SIZE(next) < size) return false;
+
+        block_remove(next);
+        block_absorb(b, next);
+        BLOCK_NEXT(b)->size &= ~BLOCK_PREV_FREE;
+    }
+
+    trim_used(b, size);
+
+    return true;
+}
+
+#if LV_MEM_SLAB_MAX != 0
+/**
+ * Allocate an item from the slab of the size class
+ * @param size size of the memory in bytes (<= `LV_MEM_SLAB_MAX`)
+ * @return pointer to the data of the item or NULL if a new chunk couldn't be allocated
+ */
+static void * slab_alloc(uint32_t size)
+{
+    uint32_t cls              = (size - 1) / SLAB_STEP;
+    lv_mem_slab_chunk_t * ch = slab_partial[cls];
+    if(ch == NULL) {
+        ch = slab_chunk_new((cls + 1) * SLAB_STEP);
+        if(ch == NULL) return NULL;
+        slab_partial[cls] = ch;
+    }
+
+    uint8_t * data = ch->free_item;
+    ch->free_item  = *(void **)data;
+    ch->used_cnt++;
+    *(lv_uintptr_t *)(data - BLOCK_OVERHEAD) = (lv_uintptr_t)ch | SLAB_ITEM_MARK;
+
+    /*Keep only the chunks with free items in the list*/
+    if(ch->free_item == NULL) {
+        slab_partial[cls] = ch->next;
+        if(ch->next) ch->next->prev = NULL;
+        ch->next = NULL;
     }
+
+    return data;
+}
+
+/**
+ * Give back a slab item. Free the chunk if it became empty and the class has other chunks with free items.
+ * @param b pointer to the "block" of a used slab item
+ */
+static void slab_free(lv_mem_block_t * b)
+{
+    lv_mem_slab_chunk_t * ch = SLAB_CHUNK(b);
+    uint32_t cls             = ch->item_size / SLAB_STEP - 1;
+    uint8_t * data           = BLOCK_DATA(b);
+
+    b->size         = BLOCK_FREE;
+    *(void **)data  = ch->free_item;
+    ch->free_item   = data;
+    ch->used_cnt--;
+
+    /*The chunk was full so add it to the list again*/
+    if(*(void **)data == NULL) {
+        ch->prev = NULL;
+        ch->next = slab_partial[cls];
+        if(ch->next) ch->next->prev = ch;
+        slab_partial[cls] = ch;
+    }
+
+    /* Keep one empty chunk to not allocate and free a chunk for every item.
+     * Keep it only in the work memory to not hold an added region*/
+    bool in_work_mem = (uint8_t *)ch > (uint8_t *)region_first &&
+                       (uint8_t *)ch < (uint8_t *)region_first + region_first->size;
+    if(ch->used_cnt == 0 && (ch->next != NULL || ch->prev != NULL || !in_work_mem)) {
+        if(ch->prev)
+            ch->prev->next = ch->next;
+        else
+            slab_partial[cls] = ch->next;
+
+        if(ch->next) ch->next->prev = ch->prev;
+
+        block_free((lv_mem_block_t *)((uint8_t *)ch - BLOCK_DATA_OFS));
+    }
+}
+
+/**
+ * Allocate a new chunk of slab items
+ * @param item_size data size of the items
+ * @return pointer to the new chunk with free items or NULL if there is no enough memory
+ */
+static lv_mem_slab_chunk_t * slab_chunk_new(uint32_t item_size)
+{
+    uint32_t item_step = item_size + BLOCK_OVERHEAD;
+    uint32_t item_cnt  = (SLAB_CHUNK_SIZE - SLAB_CHUNK_HEADER_SIZE) / item_step;
+
+    lv_mem_slab_chunk_t * ch = block_alloc(SLAB_CHUNK_HEADER_SIZE + item_cnt * item_step);
+    if(ch == NULL) return NULL;
+
+    ch->next      = NULL;
+    ch->prev      = NULL;
+    ch->free_item = NULL;
+    ch->item_size = item_size;
+    ch->item_cnt  = item_cnt;
+    ch->used_cnt  = 0;
+
+    /*Link the free items backwards to use them in order*/
+    uint8_t * data = (uint8_t *)ch + SLAB_CHUNK_HEADER_SIZE + BLOCK_OVERHEAD + (item_cnt - 1) * item_step;
+    uint32_t i;
+    for(i = 0; i < item_cnt; i++) {
+        *(lv_uintptr_t *)(data - BLOCK_OVERHEAD) = BLOCK_FREE;
+        *(void **)data                          = ch->free_item;
+        ch->free_item                           = data;
+        data -= item_step;
+    }
+
+    return ch;
+}
+#endif
+
+/**
+ * Round up a size to the size of a valid block
+ * @param size size in bytes
+ * @return the aligned size, at least `BLOCK_SIZE_MIN`
+ */
+static uint32_t adjust_size(uint32_t size)
+{
+    size = (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    if(size < BLOCK_SIZE_MIN) size = BLOCK_SIZE_MIN;
+
+    return size;
+}
+
+/**
+ * Get the index of the lowest set bit
+ * @param w a non-zero value
+ * @return index of the lowest set bit
+ */
+static uint32_t bit_ffs(uint32_t w)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(w);
 #else
-    /*Round the size up to 4*/
-    if(size & 0x3) {
-        size = size & (~0x3);
-        size += 4;
+    uint32_t i = 0;
+    while((w & 1) == 0) {
+        w >>= 1;
+        i++;
     }
+    return i;
 #endif
+}
 
-    /*Don't let empty space only for a header without data*/
-    if(e->header.s.d_size == size + sizeof(lv_mem_header_t)) {
-        size = e->header.s.d_size;
+/**
+ * Get the index of the highest set bit
+ * @param w a non-zero value
+ * @return index of the highest set bit
+ */
+static uint32_t bit_fls(uint32_t w)
+{
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(w);
+#else
+    uint32_t i = 0;
+    while(w >>= 1) i++;
+    return i;
+#endif
+}
+
+/**
+ * Get the size class of a block
+ * @param size size of the block
+ * @param fl store the first level index here
+ * @param sl store the second level index here
+ */
+static void mapping_insert(uint32_t size, uint32_t * fl, uint32_t * sl)
+{
+    if(size < SMALL_BLOCK_SIZE) {
+        /*Linear steps in the small sizes*/
+        *fl = 0;
+        *sl = size >> ALIGN_LOG2;
+    } else {
+        uint32_t f = bit_fls(size);
+        *sl        = (size >> (f - SL_CNT_LOG2)) ^ SL_CNT;
+        *fl        = f - FL_SHIFT + 1;
     }
+}
 
-    /* Create the new entry after the current if there is space for it */
-    if(e->header.s.d_size != size) {
-        uint8_t * e_data             = &e->first_data;
-        lv_mem_ent_t * after_new_e   = (lv_mem_ent_t *)&e_data[size];
-        after_new_e->header.s.used   = 0;
-        after_new_e->header.s.d_size = e->header.s.d_size - size - sizeof(lv_mem_header_t);
+/**
+ * Get the size class from which every block is large enough for an allocation
+ * @param size size to allocate
+ * @param fl store the first level index here
+ * @param sl store the second level index here
+ */
+static void mapping_search(uint32_t size, uint32_t * fl, uint32_t * sl)
+{
+    /*Round up to the next size class*/
+    if(size >= SMALL_BLOCK_SIZE) {
+        size += (1U << (bit_fls(size) - SL_CNT_LOG2)) - 1;
     }
 
-    /* Set the new size for the original entry */
-    e->header.s.d_size = size;
+    mapping_insert(size, fl, sl);
+}
+
+/**
+ * Find a free block in a size class or in a larger one
+ * @param fl first level index to start from. The index of the found list is stored here.
+ * @param sl second level index to start from. The index of the found list is stored here.
+ * @return pointer to a free block or NULL if there is no free block from this size class
+ */
+static lv_mem_block_t * find_suitable(uint32_t * fl, uint32_t * sl)
+{
+    /*Search in the same first level class*/
+    uint32_t sl_map = sl_bitmap[*fl] & (~0U << *sl);
+    if(sl_map == 0) {
+        /*Search in the larger first level classes*/
+        uint32_t fl_map = fl_bitmap & (~0U << (*fl + 1));
+        if(fl_map == 0) return NULL;
+
+        *fl    = bit_ffs(fl_map);
+        sl_map = sl_bitmap[*fl];
+    }
+
+    *sl = bit_ffs(sl_map);
+
+    return free_lists[*fl][*sl];
+}
+
+/**
+ * Remove a block from a free list
+ * @param b pointer to a free block
+ * @param fl first level index of the list
+ * @param sl second level index of the list
+ */
+static void list_remove(lv_mem_block_t * b, uint32_t fl, uint32_t sl)
+{
+    if(b->next_free) b->next_free->prev_free = b->prev_free;
+
+    if(b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        free_lists[fl][sl] = b->next_free;
+
+        /*Clear the bits if the list became empty*/
+        if(b->next_free == NULL) {
+            sl_bitmap[fl] &= ~(1U << sl);
+            if(sl_bitmap[fl] == 0) fl_bitmap &= ~(1U << fl);
+        }
+    }
+}
+
+/**
+ * Add a block to the head of a free list
+ * @param b pointer to a free block
+ * @param fl first level index of the list
+ * @param sl second level index of the list
+ */
+static void list_insert(lv_mem_block_t * b, uint32_t fl, uint32_t sl)
+{
+    b->prev_free = NULL;
+    b->next_free = free_lists[fl][sl];
+    if(b->next_free) b->next_free->prev_free = b;
+
+    free_lists[fl][sl] = b;
+    fl_bitmap |= 1U << fl;
+    sl_bitmap[fl] |= 1U << sl;
+}
+
+/**
+ * Remove a free block from the list of its size class
+ * @param b pointer to a free block
+ */
+static void block_remove(lv_mem_block_t * b)
+{
+    uint32_t fl;
+    uint32_t sl;
+    mapping_insert(BLOCK_SIZE(b), &fl, &sl);
+    list_remove(b, fl, sl);
+}
+
+/**
+ * Add a free block to the list of its size class
+ * @param b pointer to a free block
+ */
+static void block_insert(lv_mem_block_t * b)
+{
+    uint32_t fl;
+    uint32_t sl;
+    mapping_insert(BLOCK_SIZE(b), &fl, &sl);
+    list_insert(b, fl, sl);
+}
+
+/**
+ * Cut the end of a block to a new free block. The caller should set `BLOCK_PREV_FREE` of the new block.
+ * @param b pointer to a block. It should be at least `size + sizeof(lv_mem_block_t)` large.
+ * @param size the new size of the block
+ * @return pointer to the new free block after `b`
+ */
+static lv_mem_block_t * block_split(lv_mem_block_t * b, uint32_t size)
+{
+    lv_mem_block_t * rest = (lv_mem_block_t *)((uint8_t *)BLOCK_DATA(b) + size - BLOCK_OVERHEAD);
+    rest->size            = (BLOCK_SIZE(b) - size - BLOCK_OVERHEAD) | BLOCK_FREE;
+
+    b->size = size | (b->size & (BLOCK_FREE | BLOCK_PREV_FREE));
+
+    lv_mem_block_t * next = BLOCK_NEXT(rest);
+    next->prev_phys       = rest;
+    next->size |= BLOCK_PREV_FREE;
+
+    return rest;
+}
+
+/**
+ * Join a free block to the previous block
+ * @param prev pointer to a block
+ * @param b pointer to the free block after `prev` (already removed from its list)
+ * @return `prev`
+ */
+static lv_mem_block_t * block_absorb(lv_mem_block_t * prev, lv_mem_block_t * b)
+{
+    prev->size += BLOCK_SIZE(b) + BLOCK_OVERHEAD;
+    BLOCK_NEXT(prev)->prev_phys = prev;
+
+    return prev;
+}
+
+/**
+ * Join a free block with the previous block if it's free
+ * @param b pointer to a free block (not in a list)
+ * @return pointer to the joined block
+ */
+static lv_mem_block_t * merge_prev(lv_mem_block_t * b)
+{
+    if(b->size & BLOCK_PREV_FREE) {
+        lv_mem_block_t * prev = b->prev_phys;
+        block_remove(prev);
+        b = block_absorb(prev, b);
+    }
+
+    return b;
+}
+
+/**
+ * Join a block with the next block if it's free
+ * @param b pointer to a block (not in a list)
+ * @return `b`
+ */
+static lv_mem_block_t * merge_next(lv_mem_block_t * b)
+{
+    lv_mem_block_t * next = BLOCK_NEXT(b);
+    if(next->size & BLOCK_FREE) {
+        block_remove(next);
+        b = block_absorb(b, next);
+    }
+
+    return b;
+}
+
+/**
+ * Give back the end of a free block which is being allocated
+ * @param b pointer to a free block (not in a list)
+ * @param size the needed size
+ */
+static void trim_free(lv_mem_block_t * b, uint32_t size)
+{
+    if(BLOCK_SIZE(b) >= size + sizeof(lv_mem_block_t)) {
+        lv_mem_block_t * rest = block_split(b, size);
+        rest->size |= BLOCK_PREV_FREE;
+        block_insert(rest);
+    }
+}
+
+/**
+ * Give back the end of a used block
+ * @param b pointer to a used block
+ * @param size the needed size
+ */
+static void trim_used(lv_mem_block_t * b, uint32_t size)
+{
+    if(BLOCK_SIZE(b) >= size + sizeof(lv_mem_block_t)) {
+        lv_mem_block_t * rest = block_split(b, size);
+        rest                  = merge_next(rest);
+        block_insert(rest);
+    }
 }
 
 #endif
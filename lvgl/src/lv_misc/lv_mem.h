@@ -54,6 +54,7 @@ typedef struct
     uint32_t used_cnt;
     uint8_t used_pct; /**< Percentage used */
     uint8_t frag_pct; /**< Amount of fragmentation */
+    uint16_t region_cnt; /**< Number of memory regions (see `lv_mem_monitor_region`) */
 } lv_mem_monitor_t;
 
 /**********************
@@ -99,6 +100,15 @@ void lv_mem_defrag(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+/**
+ * Give information about one region of the work memory.
+ * The first region is the work memory, the others are added when it's full (see `LV_MEM_REGION_SIZE`)
+ * @param region_id index of the region (< `region_cnt` from `lv_mem_monitor`)
+ * @param mon_p pointer to a dm_mon_p variable,
+ *              the result of the analysis will be stored here
+ */
+void lv_mem_monitor_region(uint16_t region_id, lv_mem_monitor_t * mon_p);
+
 /**
  * Give the size of an allocated memory
  * @param data pointer to an allocated memory
@@ -131,8 +141,14 @@ uint32_t lv_mem_get_size(const void * data);
         }                                                                                                              \
     }
 #endif
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
 
+/*Replace the allocator functions with the tracing ones*/
+#if LV_MEM_TRACE
+#include "lv_mem_trace.h"
+#endif
+
 #endif /*LV_MEM_H*/
@@ -0,0 +1,798 @@
+/**
+ * @file lv_mem_trace.c
+ * Trace the dynamic memory calls to find which module uses or fragments the memory.
+ * `lv_mem.h` replaces `lv_mem_alloc`, `lv_mem_free` and `lv_mem_realloc` with the functions here
+ * which pass the call site (file and line) too.
+ * The live memories are followed in a hash table with their owner call site
+ * and the call sites are grouped by module (the file's name, e.g. "lv_btn" or "lv_ll").
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_mem_trace.h"
+#if LV_MEM_TRACE
+
+#include "../lv_hal/lv_hal_tick.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#if LV_REFR_THREADS > 1
+#include <pthread.h>
+#endif
+
+/*The real allocator functions are called from here*/
+#undef lv_mem_alloc
+#undef lv_mem_free
+#undef lv_mem_realloc
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Id of an unknown call site (e.g. the site table is full)*/
+#define SITE_NONE 0xFFFF
+
+/*Number of samples in the fragmentation timeline*/
+#define TIMELINE_CNT 64
+
+/*Number of the size classes in the histogram. The last class has the larger sizes too*/
+#define HIST_CNT 16
+
+/*The refresh threads can allocate too*/
+#if LV_REFR_THREADS > 1
+#define TRACE_LOCK() pthread_mutex_lock(&trace_mutex)
+#define TRACE_UNLOCK() pthread_mutex_unlock(&trace_mutex)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+enum {
+    TRACE_OP_ALLOC,
+    TRACE_OP_FREE,
+    TRACE_OP_REALLOC,
+    TRACE_OP_FAIL,
+};
+typedef uint8_t trace_op_t;
+
+/**
+ * A traced call in the event ring buffer
+ */
+typedef struct
+{
+    const void * data; /*The allocated or freed memory*/
+    uint32_t time;     /*`lv_tick_get()` of the call*/
+    uint32_t size;     /*The requested size*/
+    uint16_t site_id;  /*The caller*/
+    trace_op_t op;
+} trace_event_t;
+
+/**
+ * A followed live memory in the hash table
+ */
+typedef struct
+{
+    const void * data; /*NULL: empty slot*/
+    uint32_t size;
+    uint16_t site_id; /*The owner*/
+} trace_live_t;
+
+/**
+ * Usage of a call site or a module
+ */
+typedef struct
+{
+    uint32_t live_size; /*Size of the owned memories*/
+    uint32_t live_cnt;  /*Number of the owned memories*/
+    uint32_t peak_size; /*Largest `live_size` so far*/
+    uint32_t alloc_cnt; /*Number of memories owned so far*/
+} trace_usage_t;
+
+/**
+ * A call site
+ */
+typedef struct
+{
+    const char * file; /*NULL: empty slot*/
+    uint32_t line;
+    uint16_t module_id;
+    trace_usage_t usage;
+} trace_site_t;
+
+/**
+ * A module: the call sites of a source file
+ */
+typedef struct
+{
+    const char * name; /*Start of the file's name without the directories*/
+    uint8_t name_len;  /*Length of the name without the extension*/
+    trace_usage_t usage;
+} trace_module_t;
+
+/**
+ * A sample of the fragmentation timeline
+ */
+typedef struct
+{
+    uint32_t time; /*Time since `lv_mem_trace_init` [s]*/
+    uint32_t total_size;
+    uint32_t used_size;
+    uint32_t free_biggest_size;
+    uint8_t frag_pct;
+} trace_sample_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void trace_event(trace_op_t op, const void * data, uint32_t size, uint16_t site_id);
+static void live_add(const void * data, uint32_t size, uint16_t site_id);
+static bool live_remove(const void * data, trace_live_t * removed);
+static uint32_t live_find(const void * data);
+static uint32_t live_hash(const void * data);
+static void usage_add(uint16_t site_id, uint32_t size);
+static void usage_remove(uint16_t site_id, uint32_t size);
+static uint16_t site_get(const char * file, uint32_t line);
+static uint16_t module_get(const char * file);
+static uint32_t hist_class(uint32_t size);
+static void time_update(void);
+static void timeline_sample(void);
+static void dump_usage_header(FILE * f);
+static void dump_usage(FILE * f, const trace_usage_t * usage);
+static void dump_sort(uint16_t * order, uint16_t cnt, const trace_usage_t * (*get_usage)(uint16_t id));
+static const trace_usage_t * site_usage(uint16_t id);
+static const trace_usage_t * module_usage(uint16_t id);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static trace_event_t events[LV_MEM_TRACE_EVENT_CNT];
+static uint32_t event_cnt; /*Number of all events. The last one is at `(event_cnt - 1) % LV_MEM_TRACE_EVENT_CNT`*/
+
+static trace_live_t lives[LV_MEM_TRACE_LIVE_CNT];
+static uint32_t live_cnt;
+
+static trace_site_t sites[LV_MEM_TRACE_SITE_CNT];
+static trace_module_t modules[LV_MEM_TRACE_SITE_CNT];
+static uint16_t module_cnt;
+
+static trace_usage_t total;
+static uint32_t peak_time;
+static uint32_t fail_cnt;
+static uint32_t lost_cnt;
+static uint32_t unknown_free_cnt;
+static const void * zero_mem; /*The result of the 0 sized allocations. It's not followed.*/
+
+static uint32_t hist_alloc_cnt[HIST_CNT];
+static uint32_t hist_live_cnt[HIST_CNT];
+
+static trace_sample_t timeline[TIMELINE_CNT];
+static uint16_t timeline_cnt;
+static uint32_t timeline_period; /*[s]*/
+
+static uint32_t time_last_tick;
+static uint32_t time_ms;  /*Milliseconds not counted in `time_sec` yet*/
+static uint32_t time_sec; /*Time since `lv_mem_trace_init` [s]*/
+
+#if LV_REFR_THREADS > 1
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize the memory tracer
+ */
+void lv_mem_trace_init(void)
+{
+    TRACE_LOCK();
+
+    memset(lives, 0, sizeof(lives));
+    memset(sites, 0, sizeof(sites));
+    memset(&total, 0, sizeof(total));
+    memset(hist_alloc_cnt, 0, sizeof(hist_alloc_cnt));
+    memset(hist_live_cnt, 0, sizeof(hist_live_cnt));
+    event_cnt        = 0;
+    live_cnt         = 0;
+    module_cnt       = 0;
+    peak_time        = 0;
+    fail_cnt         = 0;
+    lost_cnt         = 0;
+    unknown_free_cnt = 0;
+
+    time_last_tick = lv_tick_get();
+    time_ms        = 0;
+    time_sec       = 0;
+
+    timeline_cnt    = 0;
+    timeline_period = LV_MEM_TRACE_PERIOD / 1000;
+    if(timeline_period == 0) timeline_period = 1;
+    timeline_sample();
+
+    TRACE_UNLOCK();
+}
+
+/**
+ * Allocate a memory and trace it. Called instead of `lv_mem_alloc` if `LV_MEM_TRACE` is enabled.
+ * @param size size of the memory to allocate in bytes
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return pointer to the allocated memory
+ */
+void * lv_mem_trace_alloc(uint32_t size, const char * file, uint32_t line)
+{
+    void * data = lv_mem_alloc(size);
+
+    TRACE_LOCK();
+
+    uint16_t site_id = site_get(file, line);
+    if(data == NULL) {
+        trace_event(TRACE_OP_FAIL, NULL, size, site_id);
+    } else {
+        trace_event(TRACE_OP_ALLOC, data, size, site_id);
+        /*The 0 sized memories are the same static variable*/
+        if(size != 0) live_add(data, size, site_id);
+        else zero_mem = data;
+    }
+
+    TRACE_UNLOCK();
+
+    return data;
+}
+
+/**
+ * Free a memory and trace it. Called instead of `lv_mem_free` if `LV_MEM_TRACE` is enabled.
+ * @param data pointer to an allocated memory
+ * @param file the caller's source file
+ * @param line the caller's line
+ */
+void lv_mem_trace_free(const void * data, const char * file, uint32_t line)
+{
+    if(data == NULL || data == zero_mem) {
+        lv_mem_free(data);
+        return;
+    }
+
+    TRACE_LOCK();
+
+    trace_live_t live;
+    uint16_t site_id = site_get(file, line);
+    if(live_remove(data, &live)) {
+        trace_event(TRACE_OP_FREE, data, live.size, site_id);
+    } else {
+        trace_event(TRACE_OP_FREE, data, 0, site_id);
+    }
+
+    TRACE_UNLOCK();
+
+    lv_mem_free(data);
+}
+
+/**
+ * Reallocate a memory and trace it. Called instead of `lv_mem_realloc` if `LV_MEM_TRACE` is enabled.
+ * The memory will belong to the caller of the reallocation.
+ * @param data_p pointer to an allocated memory
+ * @param new_size the desired new size in byte
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return pointer to the new memory
+ */
+void * lv_mem_trace_realloc(void * data_p, uint32_t new_size, const char * file, uint32_t line)
+{
+    void * new_p = lv_mem_realloc(data_p, new_size);
+
+    TRACE_LOCK();
+
+    uint16_t site_id = site_get(file, line);
+    if(new_p == NULL) {
+        /*The old memory is kept*/
+        trace_event(TRACE_OP_FAIL, data_p, new_size, site_id);
+    } else {
+        trace_live_t live;
+        if(data_p != NULL && data_p != zero_mem) live_remove(data_p, &live);
+        trace_event(TRACE_OP_REALLOC, new_p, new_size, site_id);
+        if(new_size != 0) live_add(new_p, new_size, site_id);
+        else zero_mem = new_p;
+    }
+
+    TRACE_UNLOCK();
+
+    return new_p;
+}
+
+/**
+ * Give a live memory to an other call site.
+ * E.g. the ext. data of an object belongs to the type which allocated it last, not its ancestor.
+ * @param data pointer to an allocated memory
+ * @param file the new owner's source file
+ * @param line the new owner's line
+ */
+void lv_mem_trace_set_owner(const void * data, const char * file, uint32_t line)
+{
+    if(data == NULL) return;
+
+    TRACE_LOCK();
+
+    uint32_t i = live_find(data);
+    if(i != LV_MEM_TRACE_LIVE_CNT) {
+        uint16_t site_id = site_get(file, line);
+        if(site_id != lives[i].site_id) {
+            usage_remove(lives[i].site_id, lives[i].size);
+            lives[i].site_id = site_id;
+            usage_add(site_id, lives[i].size);
+            total.alloc_cnt--; /*It's not a new memory*/
+        }
+    }
+
+    TRACE_UNLOCK();
+}
+
+/**
+ * Give the summary of the traced memories
+ * @param mon_p the result will be stored here
+ */
+void lv_mem_trace_monitor(lv_mem_trace_monitor_t * mon_p)
+{
+    TRACE_LOCK();
+
+    mon_p->live_size = total.live_size;
+    mon_p->live_cnt  = total.live_cnt;
+    mon_p->peak_size = total.peak_size;
+    mon_p->peak_time = peak_time;
+    mon_p->event_cnt = event_cnt;
+    mon_p->fail_cnt  = fail_cnt;
+    mon_p->lost_cnt  = lost_cnt;
+
+    TRACE_UNLOCK();
+}
+
+/**
+ * Write a report into a text file: the live memories per module and call site,
+ * the size histogram, the fragmentation timeline, the peak and the last calls.
+ * @param path path of the file
+ * @return LV_RES_OK: the file is written; LV_RES_INV: the file couldn't be opened
+ */
+lv_res_t lv_mem_trace_dump(const char * path)
+{
+    FILE * f = fopen(path, "w");
+    if(f == NULL) {
+        LV_LOG_WARN("lv_mem_trace_dump: can't open the file");
+        return LV_RES_INV;
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    TRACE_LOCK();
+
+    time_update();
+
+    fprintf(f, "Memory trace after %u s\n\n", (unsigned)time_sec);
+    fprintf(f, "Heap:   %u bytes, used %u bytes (%u %%), biggest free %u bytes, fragmentation %u %%\n",
+            (unsigned)mon.total_size, (unsigned)(mon.total_size - mon.free_size), mon.used_pct,
+            (unsigned)mon.free_biggest_size, mon.frag_pct);
+    fprintf(f, "Traced: %u bytes in %u memories, peak %u bytes at %u s\n", (unsigned)total.live_size,
+            (unsigned)total.live_cnt, (unsigned)total.peak_size, (unsigned)peak_time);
+    fprintf(f, "Calls:  %u, failed allocations %u, not followed memories %u, frees of not followed memories %u\n",
+            (unsigned)event_cnt, (unsigned)fail_cnt, (unsigned)lost_cnt, (unsigned)unknown_free_cnt);
+
+    /*Sort the modules and the sites by the live size*/
+    static uint16_t order[LV_MEM_TRACE_SITE_CNT];
+    uint16_t i;
+
+    fprintf(f, "\nModules\n%-24s", "module");
+    dump_usage_header(f);
+    dump_sort(order, module_cnt, module_usage);
+    for(i = 0; i < module_cnt; i++) {
+        const trace_module_t * m = &modules[order[i]];
+        if(m->usage.alloc_cnt == 0) continue; /*Only frees here*/
+
+        fprintf(f, "%-24.*s", m->name_len, m->name);
+        dump_usage(f, &m->usage);
+    }
+
+    fprintf(f, "\nCall sites\n%-32s", "site");
+    dump_usage_header(f);
+    dump_sort(order, LV_MEM_TRACE_SITE_CNT, site_usage);
+    for(i = 0; i < LV_MEM_TRACE_SITE_CNT; i++) {
+        const trace_site_t * s = &sites[order[i]];
+        if(s->file == NULL) break;
+        if(s->usage.alloc_cnt == 0) continue; /*Only frees here*/
+
+        const trace_module_t * m = &modules[s->module_id];
+        char name[64];
+        snprintf(name, sizeof(name), "%.*s:%u", m->name_len, m->name, (unsigned)s->line);
+        fprintf(f, "%-32s", name);
+        dump_usage(f, &s->usage);
+    }
+
+    fprintf(f, "\nSizes\n%-16s%12s%12s\n", "size", "allocs", "live");
+    for(i = 0; i < HIST_CNT; i++) {
+        char name[32];
+        uint32_t min = i == 0 ? 1 : (1U << (i + 2));
+        if(i == HIST_CNT - 1) snprintf(name, sizeof(name), "%u..", (unsigned)min);
+        else snprintf(name, sizeof(name), "%u..%u", (unsigned)min, (unsigned)(1U << (i + 3)) - 1);
+        fprintf(f, "%-16s%12u%12u\n", name, (unsigned)hist_alloc_cnt[i], (unsigned)hist_live_cnt[i]);
+    }
+
+    fprintf(f, "\nTimeline (every %u s)\n%12s%12s%12s%12s%8s\n", (unsigned)timeline_period, "time [s]", "heap", "used",
+            "biggest", "frag %");
+    for(i = 0; i < timeline_cnt; i++) {
+        const trace_sample_t * s = &timeline[i];
+        fprintf(f, "%12u%12u%12u%12u%8u\n", (unsigned)s->time, (unsigned)s->total_size, (unsigned)s->used_size,
+                (unsigned)s->free_biggest_size, s->frag_pct);
+    }
+
+    static const char * op_txt[] = {"alloc", "free", "realloc", "FAIL"};
+    uint32_t first = event_cnt > LV_MEM_TRACE_EVENT_CNT ? event_cnt - LV_MEM_TRACE_EVENT_CNT : 0;
+    fprintf(f, "\nLast calls\n%12s  %-8s%20s%10s  %s\n", "tick [ms]", "call", "memory", "size", "site");
+    uint32_t e;
+    for(e = first; e < event_cnt; e++) {
+        const trace_event_t * ev = &events[e % LV_MEM_TRACE_EVENT_CNT];
+        char name[64] = "?";
+        if(ev->site_id != SITE_NONE) {
+            const trace_site_t * s  = &sites[ev->site_id];
+            const trace_module_t * m = &modules[s->module_id];
+            snprintf(name, sizeof(name), "%.*s:%u", m->name_len, m->name, (unsigned)s->line);
+        }
+        fprintf(f, "%12u  %-8s%20p%10u  %s\n", (unsigned)ev->time, op_txt[ev->op], ev->data, (unsigned)ev->size,
+                name);
+    }
+
+    TRACE_UNLOCK();
+
+    fclose(f);
+
+    return LV_RES_OK;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Save a call in the event ring buffer and sample the timeline if it's time
+ * @param op type of the call
+ * @param data the allocated or freed memory
+ * @param size the requested size
+ * @param site_id id of the caller
+ */
+static void trace_event(trace_op_t op, const void * data, uint32_t size, uint16_t site_id)
+{
+    trace_event_t * ev = &events[event_cnt % LV_MEM_TRACE_EVENT_CNT];
+    ev->data           = data;
+    ev->time           = lv_tick_get();
+    ev->size           = size;
+    ev->site_id        = site_id;
+    ev->op             = op;
+    event_cnt++;
+
+    if(op == TRACE_OP_FAIL) fail_cnt++;
+
+    time_update();
+    if(timeline_cnt == 0 || time_sec >= timeline[timeline_cnt - 1].time + timeline_period) timeline_sample();
+}
+
+/**
+ * Follow a new live memory
+ * @param data pointer to the memory
+ * @param size size of the memory
+ * @param site_id id of the owner
+ */
+static void live_add(const void * data, uint32_t size, uint16_t site_id)
+{
+    /*Keep an empty slot to stop the searches*/
+    if(live_cnt >= LV_MEM_TRACE_LIVE_CNT - 1) {
+        lost_cnt++;
+        return;
+    }
+
+    uint32_t i = live_hash(data);
+    while(lives[i].data != NULL) i = (i + 1) % LV_MEM_TRACE_LIVE_CNT;
+
+    lives[i].data    = data;
+    lives[i].size    = size;
+    lives[i].site_id = site_id;
+    live_cnt++;
+
+    usage_add(site_id, size);
+    hist_alloc_cnt[hist_class(size)]++;
+    hist_live_cnt[hist_class(size)]++;
+}
+
+/**
+ * Stop following a live memory
+ * @param data pointer to the memory
+ * @param removed the removed memory's data will be stored here
+ * @return true: the memory was followed
+ */
+static bool live_remove(const void * data, trace_live_t * removed)
+{
+    uint32_t i = live_find(data);
+    if(i == LV_MEM_TRACE_LIVE_CNT) {
+        unknown_free_cnt++;
+        return false;
+    }
+
+    *removed = lives[i];
+    live_cnt--;
+    usage_remove(removed->site_id, removed->size);
+    hist_live_cnt[hist_class(removed->size)]--;
+
+    /*Move back the next entries whose place is not after the new hole (linear probing without tombstones)*/
+    uint32_t j = i;
+    while(1) {
+        j = (j + 1) % LV_MEM_TRACE_LIVE_CNT;
+        if(lives[j].data == NULL) break;
+
+        uint32_t home = live_hash(lives[j].data);
+        bool in_place = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if(!in_place) {
+            lives[i] = lives[j];
+            i        = j;
+        }
+    }
+    lives[i].data = NULL;
+
+    return true;
+}
+
+/**
+ * Find a live memory in the hash table
+ * @param data pointer to the memory
+ * @return index in `lives` or `LV_MEM_TRACE_LIVE_CNT` if not found
+ */
+static uint32_t live_find(const void * data)
+{
+    uint32_t i = live_hash(data);
+    while(lives[i].data != NULL) {
+        if(lives[i].data == data) return i;
+        i = (i + 1) % LV_MEM_TRACE_LIVE_CNT;
+    }
+
+    return LV_MEM_TRACE_LIVE_CNT;
+}
+
+/**
+ * Get the place of a memory in the hash table
+ * @param data pointer to the memory
+ * @return index in `lives`
+ */
+static uint32_t live_hash(const void * data)
+{
+    /*The lower bits are the same because of the alignment*/
+    uint32_t h = (uint32_t)((lv_uintptr_t)data >> 3);
+    return (h * 2654435761U) % LV_MEM_TRACE_LIVE_CNT;
+}
+
+/**
+ * Count a new live memory at its owner, the owner's module and in the total
+ * @param site_id id of the owner
+ * @param size size of the memory
+ */
+static void usage_add(uint16_t site_id, uint32_t size)
+{
+    trace_usage_t * u[3] = {&total, NULL, NULL};
+    if(site_id != SITE_NONE) {
+        u[1] = &sites[site_id].usage;
+        u[2] = &modules[sites[site_id].module_id].usage;
+    }
+
+    uint8_t i;
+    for(i = 0; i < 3 && u[i] != NULL; i++) {
+        u[i]->live_size += size;
+        u[i]->live_cnt++;
+        u[i]->alloc_cnt++;
+        if(u[i]->live_size > u[i]->peak_size) {
+            u[i]->peak_size = u[i]->live_size;
+            if(i == 0) peak_time = time_sec;
+        }
+    }
+}
+
+/**
+ * Remove a live memory from the counters of its owner, the owner's module and the total
+ * @param site_id id of the owner
+ * @param size size of the memory
+ */
+static void usage_remove(uint16_t site_id, uint32_t size)
+{
+    trace_usage_t * u[3] = {&total, NULL, NULL};
+    if(site_id != SITE_NONE) {
+        u[1] = &sites[site_id].usage;
+        u[2] = &modules[sites[site_id].module_id].usage;
+    }
+
+    uint8_t i;
+    for(i = 0; i < 3 && u[i] != NULL; i++) {
+        u[i]->live_size -= size;
+        u[i]->live_cnt--;
+    }
+}
+
+/**
+ * Get the id of a call site. Add it if it's new.
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return id of the call site or `SITE_NONE` if the table is full
+ */
+static uint16_t site_get(const char * file, uint32_t line)
+{
+    /*`__FILE__` is the same string in a source file so compare the pointers*/
+    uint32_t h = (uint32_t)(((lv_uintptr_t)file >> 2) ^ (line * 2654435761U));
+    uint32_t i = h % LV_MEM_TRACE_SITE_CNT;
+    uint32_t n;
+    for(n = 0; n < LV_MEM_TRACE_SITE_CNT; n++) {
+        trace_site_t * s = &sites[i];
+        if(s->file == NULL) {
+            s->file      = file;
+            s->line      = line;
+            s->module_id = module_get(file);
+            return i;
+        }
+        if(s->file == file && s->line == line) return i;
+        i = (i + 1) % LV_MEM_TRACE_SITE_CNT;
+    }
+
+    return SITE_NONE;
+}
+
+/**
+ * Get the id of the module of a source file. Add it if it's new.
+ * @param file path of a source file
+ * @return id of the module
+ */
+static uint16_t module_get(const char * file)
+{
+    /*Cut the directories and the extension*/
+    const char * name = file;
+    const char * c;
+    for(c = file; *c != '\0'; c++) {
+        if(*c == '/' || *c == '\\') name = c + 1;
+    }
+    const char * ext = strrchr(name, '.');
+    uint32_t len     = ext ? (uint32_t)(ext - name) : (uint32_t)strlen(name);
+    if(len > UINT8_MAX) len = UINT8_MAX;
+
+    uint16_t i;
+    for(i = 0; i < module_cnt; i++) {
+        if(modules[i].name_len == len && memcmp(modules[i].name, name, len) == 0) return i;
+    }
+
+    /*There are not more modules than sites*/
+    memset(&modules[i], 0, sizeof(trace_module_t));
+    modules[i].name     = name;
+    modules[i].name_len = len;
+    module_cnt++;
+
+    return i;
+}
+
+/**
+ * Get the class of a size in the histogram
+ * @param size size of a memory
+ * @return index of the class: 1..7, 8..15, 16..31 etc.
+ */
+static uint32_t hist_class(uint32_t size)
+{
+    uint32_t c = 0;
+    while(size >= 8 && c < HIST_CNT - 1) {
+        size >>= 1;
+        c++;
+    }
+
+    return c;
+}
+
+/**
+ * Count the time since `lv_mem_trace_init` (`lv_tick_get()` overflows in 49 days)
+ */
+static void time_update(void)
+{
+    uint32_t elaps = lv_tick_elaps(time_last_tick);
+    time_last_tick += elaps;
+    time_ms += elaps;
+    time_sec += time_ms / 1000;
+    time_ms %= 1000;
+}
+
+/**
+ * Add the current state of the heap to the timeline.
+ * If the timeline is full drop every second sample and double the period.
+ */
+static void timeline_sample(void)
+{
+    if(timeline_cnt == TIMELINE_CNT) {
+        uint16_t i;
+        for(i = 0; i < TIMELINE_CNT / 2; i++) timeline[i] = timeline[i * 2];
+        timeline_cnt = TIMELINE_CNT / 2;
+        timeline_period *= 2;
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    trace_sample_t * s   = &timeline[timeline_cnt];
+    s->time              = time_sec;
+    s->total_size        = mon.total_size;
+    s->used_size         = mon.total_size - mon.free_size;
+    s->free_biggest_size = mon.free_biggest_size;
+    s->frag_pct          = mon.frag_pct;
+    timeline_cnt++;
+}
+
+/**
+ * Write the header of the usage columns
+ * @param f the report file
+ */
+static void dump_usage_header(FILE * f)
+{
+    fprintf(f, "%12s%10s%12s%10s\n", "live bytes", "live", "peak bytes", "allocs");
+}
+
+/**
+ * Write the usage columns of a module or a call site
+ * @param f the report file
+ * @param usage the usage to write
+ */
+static void dump_usage(FILE * f, const trace_usage_t * usage)
+{
+    fprintf(f, "%12u%10u%12u%10u\n", (unsigned)usage->live_size, (unsigned)usage->live_cnt,
+            (unsigned)usage->peak_size, (unsigned)usage->alloc_cnt);
+}
+
+/**
+ * Sort ids by the live size, the largest first. The empty call sites are in the end.
+ * @param order the sorted ids will be stored here
+ * @param cnt number of ids
+ * @param get_usage function to get the usage of an id
+ */
+static void dump_sort(uint16_t * order, uint16_t cnt, const trace_usage_t * (*get_usage)(uint16_t id))
+{
+    uint16_t i;
+    for(i = 0; i < cnt; i++) {
+        /*Insertion sort: it's called rarely and there are a few hundred items*/
+        const trace_usage_t * u = get_usage(i);
+        uint16_t j              = i;
+        while(j > 0) {
+            const trace_usage_t * prev = get_usage(order[j - 1]);
+            bool after = u == NULL || (prev != NULL && prev->live_size >= u->live_size);
+            if(after) break;
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+}
+
+/**
+ * Get the usage of a call site for `dump_sort`
+ * @param id id of a call site
+ * @return the usage or NULL if the slot is empty
+ */
+static const trace_usage_t * site_usage(uint16_t id)
+{
+    return sites[id].file ? &sites[id].usage : NULL;
+}
+
+/**
+ * Get the usage of a module for `dump_sort`
+ * @param id id of a module
+ * @return the usage
+ */
+static const trace_usage_t * module_usage(uint16_t id)
+{
+    return &modules[id].usage;
+}
+
+#endif /*LV_MEM_TRACE*/
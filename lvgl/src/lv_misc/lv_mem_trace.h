@@ -0,0 +1,125 @@
+/**
+ * @file lv_mem_trace.h
+ *
+ */
+
+#ifndef LV_MEM_TRACE_H
+#define LV_MEM_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#if LV_MEM_TRACE
+
+#include <stdint.h>
+#include "lv_mem.h"
+#include "lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Summary of the traced memories
+ */
+typedef struct
+{
+    uint32_t live_size;  /**< Size of the followed live memories in bytes*/
+    uint32_t live_cnt;   /**< Number of the followed live memories*/
+    uint32_t peak_size;  /**< Largest `live_size` so far*/
+    uint32_t peak_time;  /**< Time of `peak_size` since `lv_mem_trace_init` [s]*/
+    uint32_t event_cnt;  /**< Number of traced calls*/
+    uint32_t fail_cnt;   /**< Number of failed allocations*/
+    uint32_t lost_cnt;   /**< Number of memories which couldn't be followed (`LV_MEM_TRACE_LIVE_CNT` is too small)*/
+} lv_mem_trace_monitor_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the memory tracer
+ */
+void lv_mem_trace_init(void);
+
+/**
+ * Allocate a memory and trace it. Called instead of `lv_mem_alloc` if `LV_MEM_TRACE` is enabled.
+ * @param size size of the memory to allocate in bytes
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return pointer to the allocated memory
+ */
+void * lv_mem_trace_alloc(uint32_t size, const char * file, uint32_t line);
+
+/**
+ * Free a memory and trace it. Called instead of `lv_mem_free` if `LV_MEM_TRACE` is enabled.
+ * @param data pointer to an allocated memory
+ * @param file the caller's source file
+ * @param line the caller's line
+ */
+void lv_mem_trace_free(const void * data, const char * file, uint32_t line);
+
+/**
+ * Reallocate a memory and trace it. Called instead of `lv_mem_realloc` if `LV_MEM_TRACE` is enabled.
+ * The memory will belong to the caller of the reallocation.
+ * @param data_p pointer to an allocated memory
+ * @param new_size the desired new size in byte
+ * @param file the caller's source file
+ * @param line the caller's line
+ * @return pointer to the new memory
+ */
+void * lv_mem_trace_realloc(void * data_p, uint32_t new_size, const char * file, uint32_t line);
+
+/**
+ * Give a live memory to an other call site.
+ * E.g. the ext. data of an object belongs to the type which allocated it last, not its ancestor.
+ * @param data pointer to an allocated memory
+ * @param file the new owner's source file
+ * @param line the new owner's line
+ */
+void lv_mem_trace_set_owner(const void * data, const char * file, uint32_t line);
+
+/**
+ * Give the summary of the traced memories
+ * @param mon_p the result will be stored here
+ */
+void lv_mem_trace_monitor(lv_mem_trace_monitor_t * mon_p);
+
+/**
+ * Write a report into a text file: the live memories per module and call site,
+ * the size histogram, the fragmentation timeline, the peak and the last calls.
+ * @param path path of the file
+ * @return LV_RES_OK: the file is written; LV_RES_INV: the file couldn't be opened
+ */
+lv_res_t lv_mem_trace_dump(const char * path);
+
+/**********************
+ *      MACROS
+ **********************/
+
+/*Pass the call site to the tracer*/
+#define lv_mem_alloc(size) lv_mem_trace_alloc(size, __FILE__, __LINE__)
+#define lv_mem_free(data) lv_mem_trace_free(data, __FILE__, __LINE__)
+#define lv_mem_realloc(data_p, new_size) lv_mem_trace_realloc(data_p, new_size, __FILE__, __LINE__)
+
+#endif /*LV_MEM_TRACE*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_MEM_TRACE_H*/
@@ -4,6 +4,8 @@ CSRCS += lv_task.c
 CSRCS += lv_fs.c
 CSRCS += lv_anim.c
 CSRCS += lv_mem.c
+CSRCS += lv_mem_trace.c
+CSRCS += lv_prof.c
 CSRCS += lv_ll.c
 CSRCS += lv_color.c
 CSRCS += lv_txt.c
@@ -0,0 +1,203 @@
+/**
+ * @file lv_prof.c
+ * Profiler of the display refresh, the input devices and the lv_tasks.
+ * The events are written into a ring buffer without a lock (the refresh threads record in parallel)
+ * and the last `LV_PROF_EVENT_CNT` events can be written into a Chrome trace file.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_prof.h"
+#if LV_USE_PROF
+
+#include "../lv_hal/lv_hal_tick.h"
+#include "../lv_core/lv_refr.h"
+#include "lv_log.h"
+#include <stdio.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#if(LV_PROF_EVENT_CNT & (LV_PROF_EVENT_CNT - 1)) != 0
+#error "LV_PROF_EVENT_CNT should be a power of 2"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * name;
+    uint64_t start;    /*[us]*/
+    uint32_t dur;      /*[us]*/
+    uint32_t seq;      /*Index of the event + 1 when it's written, 0 while it's being written*/
+    lv_prof_cat_t cat;
+    uint8_t tid;       /*Number of the recording thread*/
+} prof_event_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint8_t thread_id(void);
+static void dump_str(FILE * f, const char * s);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static prof_event_t events[LV_PROF_EVENT_CNT];
+static uint32_t event_head; /*Index of the next event. Grows continuously, the ring index is `% LV_PROF_EVENT_CNT`*/
+static uint32_t event_tail; /*Events before this index were dropped by `lv_prof_clear`*/
+static bool prof_en = true;
+static uint8_t thread_cnt;
+static LV_REFR_THREAD_LOCAL uint8_t thread_id_act; /*0: not numbered yet*/
+
+static const char * const cat_names[_LV_PROF_CAT_NUM] = {"task", "refr", "draw", "draw_post", "flush", "indev"};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Enable or disable the recording of the events. Enabled by default.
+ * @param en true: record the events; false: don't record
+ */
+void lv_prof_enable(bool en)
+{
+    prof_en = en;
+}
+
+/**
+ * Get the start time of an event. Use the `LV_PROF_START` macro instead.
+ * @return the current time from `lv_tick_get_us()` or `LV_PROF_OFF` if the profiler is disabled
+ */
+uint64_t lv_prof_start(void)
+{
+    if(prof_en == false) return LV_PROF_OFF;
+
+    return lv_tick_get_us();
+}
+
+/**
+ * Record an event which started at `start_us` and ends now. Use the `LV_PROF_STOP` macro instead.
+ * Can be called from any thread, the events are written into the ring buffer without a lock.
+ * @param cat category of the event
+ * @param name name of the event (only the pointer is saved so it should be a string literal or a static string)
+ * @param start_us the return value of `lv_prof_start()`
+ */
+void lv_prof_add(lv_prof_cat_t cat, const char * name, uint64_t start_us)
+{
+    uint64_t dur = lv_tick_elaps_us(start_us);
+
+    /*Reserve a slot. An older event is overwritten if the buffer is full*/
+    uint32_t idx      = __atomic_fetch_add(&event_head, 1, __ATOMIC_RELAXED);
+    prof_event_t * ev = &events[idx % LV_PROF_EVENT_CNT];
+
+    /*Mark it as being written so `lv_prof_dump` doesn't read a half written event*/
+    __atomic_store_n(&ev->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    ev->name  = name ? name : "?";
+    ev->start = start_us;
+    ev->dur   = dur > UINT32_MAX ? UINT32_MAX : (uint32_t)dur;
+    ev->cat   = cat;
+    ev->tid   = thread_id();
+
+    __atomic_store_n(&ev->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Drop the recorded events
+ */
+void lv_prof_clear(void)
+{
+    event_tail = __atomic_load_n(&event_head, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Write the recorded events into a Chrome trace (JSON) file.
+ * Open it with `chrome://tracing` or https://ui.perfetto.dev.
+ * Call it from the thread of `lv_task_handler` (not while refreshing).
+ * @param path path of the file (it's overwritten)
+ * @return LV_RES_OK: written; LV_RES_INV: the file can't be opened
+ */
+lv_res_t lv_prof_dump(const char * path)
+{
+    FILE * f = fopen(path, "w");
+    if(f == NULL) {
+        LV_LOG_WARN("lv_prof_dump: can't open the file");
+        return LV_RES_INV;
+    }
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    /*Name the threads. The first is the one which recorded first, normally the `lv_task_handler`'s*/
+    uint8_t t;
+    for(t = 1; t <= thread_cnt; t++) {
+        fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}},\n", t,
+                t == 1 ? "lvgl" : "refr", t);
+    }
+
+    uint32_t head  = __atomic_load_n(&event_head, __ATOMIC_ACQUIRE);
+    uint32_t first = head - event_tail > LV_PROF_EVENT_CNT ? head - LV_PROF_EVENT_CNT : event_tail;
+    uint32_t i;
+    for(i = first; i != head; i++) {
+        const prof_event_t * ev = &events[i % LV_PROF_EVENT_CNT];
+        if(__atomic_load_n(&ev->seq, __ATOMIC_ACQUIRE) != i + 1) continue;
+
+        prof_event_t e = *ev;
+
+        /*Skip it if it was overwritten meanwhile*/
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&ev->seq, __ATOMIC_RELAXED) != i + 1) continue;
+
+        fprintf(f, "{\"name\":");
+        dump_str(f, e.name);
+        fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%u},\n",
+                e.cat < _LV_PROF_CAT_NUM ? cat_names[e.cat] : "?", (unsigned long long)e.start, (unsigned)e.dur,
+                e.tid);
+    }
+
+    /*JSON doesn't allow a comma after the last element so close with an empty metadata event*/
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"lvgl\"}}\n]}\n");
+
+    fclose(f);
+    return LV_RES_OK;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the number of the calling thread in the trace
+ * @return 1 for the first recording thread, 2 for the second...
+ */
+static uint8_t thread_id(void)
+{
+    if(thread_id_act == 0) thread_id_act = __atomic_add_fetch(&thread_cnt, 1, __ATOMIC_RELAXED);
+
+    return thread_id_act;
+}
+
+/**
+ * Write a string as a JSON string
+ * @param f the file
+ * @param s the string
+ */
+static void dump_str(FILE * f, const char * s)
+{
+    fputc('"', f);
+    for(; *s != '\0'; s++) {
+        if(*s == '"' || *s == '\\') fputc('\\', f);
+        if((uint8_t)*s < 0x20) fputc(' ', f);
+        else fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+#endif /*LV_USE_PROF*/
@@ -0,0 +1,115 @@
+/**
+ * @file lv_prof.h
+ *
+ */
+
+#ifndef LV_PROF_H
+#define LV_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Returned by `lv_prof_start` if the profiler is disabled*/
+#define LV_PROF_OFF UINT64_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Categories of the profiler events
+ */
+enum {
+    LV_PROF_CAT_TASK,      /**< An lv_task (its name is the task's name)*/
+    LV_PROF_CAT_REFR,      /**< A phase of the display refresh*/
+    LV_PROF_CAT_DRAW,      /**< Main drawing of an object (its name is the object's type)*/
+    LV_PROF_CAT_DRAW_POST, /**< Post drawing of an object after its children (its name is the object's type)*/
+    LV_PROF_CAT_FLUSH,     /**< Flushing or waiting for the flush of the display buffer*/
+    LV_PROF_CAT_INDEV,     /**< Reading an input device*/
+    _LV_PROF_CAT_NUM,
+};
+typedef uint8_t lv_prof_cat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if LV_USE_PROF
+
+/**
+ * Enable or disable the recording of the events. Enabled by default.
+ * @param en true: record the events; false: don't record
+ */
+void lv_prof_enable(bool en);
+
+/**
+ * Get the start time of an event. Use the `LV_PROF_START` macro instead.
+ * @return the current time from `lv_tick_get_us()` or `LV_PROF_OFF` if the profiler is disabled
+ */
+uint64_t lv_prof_start(void);
+
+/**
+ * Record an event which started at `start_us` and ends now. Use the `LV_PROF_STOP` macro instead.
+ * Can be called from any thread, the events are written into the ring buffer without a lock.
+ * @param cat category of the event
+ * @param name name of the event (only the pointer is saved so it should be a string literal or a static string)
+ * @param start_us the return value of `lv_prof_start()`
+ */
+void lv_prof_add(lv_prof_cat_t cat, const char * name, uint64_t start_us);
+
+/**
+ * Drop the recorded events
+ */
+void lv_prof_clear(void);
+
+/**
+ * Write the recorded events into a Chrome trace (JSON) file.
+ * Open it with `chrome://tracing` or https://ui.perfetto.dev.
+ * Call it from the thread of `lv_task_handler` (not while refreshing).
+ * @param path path of the file (it's overwritten)
+ * @return LV_RES_OK: written; LV_RES_INV: the file can't be opened
+ */
+lv_res_t lv_prof_dump(const char * path);
+
+#endif /*LV_USE_PROF*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#if LV_USE_PROF
+/*Declare `t` and save the start time of an event in it*/
+#define LV_PROF_START(t) uint64_t t = lv_prof_start()
+
+/*Record the event started with `LV_PROF_START(t)`. `name` is evaluated only if the profiler is enabled*/
+#define LV_PROF_STOP(t, cat, name)                                                                                     \
+    do {                                                                                                               \
+        if(t != LV_PROF_OFF) lv_prof_add(cat, name, t);                                                                \
+    } while(0)
+#else
+#define LV_PROF_START(t)
+#define LV_PROF_STOP(t, cat, name)
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PROF_H*/
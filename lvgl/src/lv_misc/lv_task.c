@@ -2,6 +2,8 @@
  * @file lv_task.c
  * An 'lv_task'  is a void (*fp) (void* param) type function which will be called periodically.
  * A priority (5 levels + disable) can be assigned to lv_tasks.
+ * The tasks of every priority are in a min-heap ordered by the time they should run next,
+ * so `lv_task_handler` checks only the first task of every priority.
  */
 
 /*********************
@@ -10,7 +12,14 @@
 #include <stddef.h>
 #include "lv_task.h"
 #include "../lv_hal/lv_hal_tick.h"
+#include "lv_math.h"
 #include "lv_gc.h"
+#include "lv_prof.h"
+
+#if LV_TASK_STATS
+#include <stdio.h>
+#include <string.h>
+#endif
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
@@ -23,6 +32,15 @@
 #define DEF_PRIO LV_TASK_PRIO_MID
 #define DEF_PERIOD 500
 
+/*The heap slot of the turned off priority holds the tasks which ran in the current `lv_task_handler` call*/
+#define RAN_SLOT LV_TASK_PRIO_OFF
+
+/*`heap_idx` of the tasks not in a heap*/
+#define HEAP_IDX_NONE UINT32_MAX
+
+/*Deadlines are compared as signed differences so longer periods are shortened to this*/
+#define PERIOD_MAX (UINT32_MAX / 4)
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -30,7 +48,20 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_task_exec(lv_task_t * task);
+static void lv_task_exec(lv_task_t * task);
+static void task_sched(lv_task_t * task);
+static void task_unsched(lv_task_t * task);
+static void task_resched(lv_task_t * task);
+static uint32_t task_get_deadline(const lv_task_t * task);
+static int32_t task_time_till_deadline(const lv_task_t * task, uint32_t now);
+static bool heap_push(lv_task_prio_t slot, lv_task_t * task);
+static void heap_remove(lv_task_prio_t slot, uint32_t idx);
+static void heap_sift_up(lv_task_prio_t slot, uint32_t idx);
+static void heap_sift_down(lv_task_prio_t slot, uint32_t idx);
+#if LV_TASK_STATS
+static void stat_start(lv_task_t * task, uint64_t start_us);
+static void stat_end(lv_task_t * task, uint64_t start_us);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -38,7 +69,8 @@ static bool lv_task_exec(lv_task_t * task);
 static bool lv_task_run  = false;
 static uint8_t idle_last = 0;
 static bool task_deleted;
-static bool task_created;
+static uint32_t heap_cnt[_LV_TASK_PRIO_NUM];
+static uint32_t heap_size[_LV_TASK_PRIO_NUM];
 
 /**********************
  *      MACROS
@@ -55,6 +87,13 @@ void lv_task_core_init(void)
 {
     lv_ll_init(&LV_GC_ROOT(_lv_task_ll), sizeof(lv_task_t));
 
+    uint32_t i;
+    for(i = 0; i < _LV_TASK_PRIO_NUM; i++) {
+        LV_GC_ROOT(_lv_task_heap)[i] = NULL;
+        heap_cnt[i]                  = 0;
+        heap_size[i]                 = 0;
+    }
+
     /*Initially enable the lv_task handling*/
     lv_task_enable(true);
 }
@@ -72,83 +111,51 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
     task_handler_mutex = true;
 
     static uint32_t idle_period_start = 0;
-    static uint32_t handler_start     = 0;
-    static uint32_t busy_time         = 0;
+    static uint64_t busy_time         = 0; /*[us], in milliseconds most of the calls would be 0*/
 
     if(lv_task_run == false) {
         task_handler_mutex = false; /*Release mutex*/
         return;
     }
 
-    handler_start = lv_tick_get();
-
-    /* Run all task from the highest to the lowest priority
-     * If a lower priority task is executed check task again from the highest priority
-     * but on the priority of executed tasks don't run tasks before the executed*/
-    lv_task_t * task_interrupter = NULL;
-    lv_task_t * next;
-    bool end_flag;
-    do {
-        end_flag                 = true;
-        task_deleted             = false;
-        task_created             = false;
-        LV_GC_ROOT(_lv_task_act) = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
-        while(LV_GC_ROOT(_lv_task_act)) {
-            /* The task might be deleted if it runs only once ('once = 1')
-             * So get next element until the current is surely valid*/
-            next = lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), LV_GC_ROOT(_lv_task_act));
-
-            /*We reach priority of the turned off task. There is nothing more to do.*/
-            if(((lv_task_t *)LV_GC_ROOT(_lv_task_act))->prio == LV_TASK_PRIO_OFF) {
-                break;
-            }
-
-            /*Here is the interrupter task. Don't execute it again.*/
-            if(LV_GC_ROOT(_lv_task_act) == task_interrupter) {
-                task_interrupter = NULL; /*From this point only task after the interrupter comes, so
-                                            the interrupter is not interesting anymore*/
-                LV_GC_ROOT(_lv_task_act) = next;
-                continue; /*Load the next task*/
-            }
-
-            /*Just try to run the tasks with highest priority.*/
-            if(((lv_task_t *)LV_GC_ROOT(_lv_task_act))->prio == LV_TASK_PRIO_HIGHEST) {
-                lv_task_exec(LV_GC_ROOT(_lv_task_act));
-            }
-            /*Tasks with higher priority then the interrupted shall be run in every case*/
-            else if(task_interrupter) {
-                if(((lv_task_t *)LV_GC_ROOT(_lv_task_act))->prio > task_interrupter->prio) {
-                    if(lv_task_exec(LV_GC_ROOT(_lv_task_act))) {
-                        task_interrupter =
-                            LV_GC_ROOT(_lv_task_act); /*Check all tasks again from the highest priority */
-                        end_flag = false;
-                        break;
-                    }
-                }
-            }
-            /* It is no interrupter task or we already reached it earlier.
-             * Just run the remaining tasks*/
-            else {
-                if(lv_task_exec(LV_GC_ROOT(_lv_task_act))) {
-                    task_interrupter = LV_GC_ROOT(_lv_task_act); /*Check all tasks again from the highest priority */
-                    end_flag         = false;
-                    break;
-                }
-            }
-
-            if(task_deleted) break; /*If a task was deleted then this or the next item might be corrupted*/
-            if(task_created) break; /*If a task was created then this or the next item might be corrupted*/
-
-            LV_GC_ROOT(_lv_task_act) = next; /*Load the next task*/
+    uint64_t handler_start = lv_tick_get_us();
+
+    /* Run the due tasks from the highest to the lowest priority.
+     * After a task ran check the higher priorities again because it might have made them due.
+     * A task runs only once in a call: it's moved to `RAN_SLOT` and back to its heap at the end.*/
+    lv_task_prio_t prio = LV_TASK_PRIO_HIGHEST;
+    while(prio > LV_TASK_PRIO_OFF) {
+        lv_task_t * task = heap_cnt[prio] ? LV_GC_ROOT(_lv_task_heap)[prio][0] : NULL;
+        if(task == NULL || task_time_till_deadline(task, lv_tick_get()) > 0) {
+            prio--;
+            continue;
         }
-    } while(!end_flag);
 
-    busy_time += lv_tick_elaps(handler_start);
+        heap_remove(prio, 0);
+        if(heap_push(RAN_SLOT, task)) task->ran = 1;
+
+        lv_task_exec(task);
+
+        prio = LV_TASK_PRIO_HIGHEST;
+    }
+
+    /*Schedule the tasks which ran again (not the deleted ones as they were removed)*/
+    while(heap_cnt[RAN_SLOT]) {
+        lv_task_t * task = LV_GC_ROOT(_lv_task_heap)[RAN_SLOT][heap_cnt[RAN_SLOT] - 1];
+        heap_cnt[RAN_SLOT]--;
+        task->heap_idx = HEAP_IDX_NONE;
+        task->ran      = 0;
+        task_sched(task);
+    }
+    LV_GC_ROOT(_lv_task_act) = NULL;
+
+    busy_time += lv_tick_elaps_us(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
     if(idle_period_time >= IDLE_MEAS_PERIOD) {
 
-        idle_last         = (uint32_t)((uint32_t)busy_time * 100) / IDLE_MEAS_PERIOD; /*Calculate the busy percentage*/
-        idle_last         = idle_last > 100 ? 0 : 100 - idle_last;                    /*But we need idle time*/
+        /*The handler might be called much later than `IDLE_MEAS_PERIOD` so use the real period*/
+        idle_last         = (uint32_t)(busy_time / 10 / idle_period_time); /*Calculate the busy percentage*/
+        idle_last         = idle_last > 100 ? 0 : 100 - idle_last;          /*But we need idle time*/
         busy_time         = 0;
         idle_period_start = lv_tick_get();
     }
@@ -164,48 +171,31 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
  */
 lv_task_t * lv_task_create_basic(void)
 {
-    lv_task_t * new_task = NULL;
-    lv_task_t * tmp;
-
-    /*Create task lists in order of priority from high to low*/
-    tmp = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
-
-    /*It's the first task*/
-    if(NULL == tmp) {
-        new_task = lv_ll_ins_head(&LV_GC_ROOT(_lv_task_ll));
-        lv_mem_assert(new_task);
-        if(new_task == NULL) return NULL;
-    }
-    /*Insert the new task to proper place according to its priority*/
-    else {
-        do {
-            if(tmp->prio <= DEF_PRIO) {
-                new_task = lv_ll_ins_prev(&LV_GC_ROOT(_lv_task_ll), tmp);
-                lv_mem_assert(new_task);
-                if(new_task == NULL) return NULL;
-                break;
-            }
-            tmp = lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), tmp);
-        } while(tmp != NULL);
-
-        /*Only too high priority tasks were found. Add the task to the end*/
-        if(tmp == NULL) {
-            new_task = lv_ll_ins_tail(&LV_GC_ROOT(_lv_task_ll));
-            lv_mem_assert(new_task);
-            if(new_task == NULL) return NULL;
-        }
-    }
+    /*The order of the list doesn't matter, the heaps decide which task runs*/
+    lv_task_t * new_task = lv_ll_ins_head(&LV_GC_ROOT(_lv_task_ll));
+    lv_mem_assert(new_task);
+    if(new_task == NULL) return NULL;
 
     new_task->period  = DEF_PERIOD;
     new_task->task_cb = NULL;
     new_task->prio    = DEF_PRIO;
 
     new_task->once     = 0;
+    new_task->paused   = 0;
+    new_task->ran      = 0;
+    new_task->heap_idx = HEAP_IDX_NONE;
     new_task->last_run = lv_tick_get();
 
     new_task->user_data = NULL;
 
-    task_created = true;
+#if LV_TASK_STATS || LV_USE_PROF
+    new_task->name = NULL;
+#endif
+#if LV_TASK_STATS
+    memset(&new_task->stat, 0, sizeof(lv_task_stat_t));
+#endif
+
+    task_sched(new_task);
 
     return new_task;
 }
@@ -250,6 +240,9 @@ void lv_task_set_cb(lv_task_t * task, lv_task_cb_t task_cb)
  */
 void lv_task_del(lv_task_t * task)
 {
+    if(task->ran) heap_remove(RAN_SLOT, task->heap_idx);
+    else task_unsched(task);
+
     lv_ll_rem(&LV_GC_ROOT(_lv_task_ll), task);
 
     lv_mem_free(task);
@@ -266,32 +259,21 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio)
 {
     if(task->prio == prio) return;
 
-    /*Find the tasks with new priority*/
-    lv_task_t * i;
-    LV_LL_READ(LV_GC_ROOT(_lv_task_ll), i)
-    {
-        if(i->prio <= prio) {
-            if(i != task) lv_ll_move_before(&LV_GC_ROOT(_lv_task_ll), task, i);
-            break;
-        }
-    }
-
-    /*There was no such a low priority so far then add the node to the tail*/
-    if(i == NULL) {
-        lv_ll_move_before(&LV_GC_ROOT(_lv_task_ll), task, NULL);
-    }
-
+    /*Move it to the heap of the new priority*/
+    task_unsched(task);
     task->prio = prio;
+    task_sched(task);
 }
 
 /**
  * Set new period for a lv_task
  * @param task pointer to a lv_task
- * @param period the new period
+ * @param period the new period (periods longer than `UINT32_MAX / 4` ms, about 12 days, are shortened to it)
  */
 void lv_task_set_period(lv_task_t * task, uint32_t period)
 {
     task->period = period;
+    task_resched(task);
 }
 
 /**
@@ -301,6 +283,7 @@ void lv_task_set_period(lv_task_t * task, uint32_t period)
 void lv_task_ready(lv_task_t * task)
 {
     task->last_run = lv_tick_get() - task->period - 1;
+    task_resched(task);
 }
 
 /**
@@ -320,6 +303,27 @@ void lv_task_once(lv_task_t * task)
 void lv_task_reset(lv_task_t * task)
 {
     task->last_run = lv_tick_get();
+    task_resched(task);
+}
+
+/**
+ * Pause a lv_task. It keeps its priority but it's not executed until `lv_task_resume`.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_pause(lv_task_t * task)
+{
+    task->paused = 1;
+    task_unsched(task);
+}
+
+/**
+ * Resume a paused lv_task. It runs when its period elapsed since it ran last time.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_resume(lv_task_t * task)
+{
+    task->paused = 0;
+    task_sched(task);
 }
 
 /**
@@ -340,35 +344,382 @@ uint8_t lv_task_get_idle(void)
     return idle_last;
 }
 
+/**
+ * Get the time until a task should run. Animations and display refreshes are tasks too
+ * which are paused while there is nothing to do, so the caller can sleep until then
+ * (or until an input arrives) instead of calling `lv_task_handler` periodically.
+ * @return time until the next task in milliseconds (0: a task is ready)
+ *         or `LV_NO_TASK_READY` if no task will run
+ */
+uint32_t lv_task_get_time_till_next(void)
+{
+    if(lv_task_run == false) return LV_NO_TASK_READY;
+
+    /*Only the first task of every priority can be the next*/
+    uint32_t now            = lv_tick_get();
+    uint32_t time_till_next = LV_NO_TASK_READY;
+    lv_task_prio_t prio;
+    for(prio = LV_TASK_PRIO_LOWEST; prio < _LV_TASK_PRIO_NUM; prio++) {
+        if(heap_cnt[prio] == 0) continue;
+
+        int32_t t = task_time_till_deadline(LV_GC_ROOT(_lv_task_heap)[prio][0], now);
+        if(t <= 0) return 0;
+
+        if((uint32_t)t < time_till_next) time_till_next = t;
+    }
+
+    return time_till_next;
+}
+
+/**
+ * Iterate through the tasks
+ * @param task NULL to get the first task else a pointer to the current task
+ * @return pointer to the next task or NULL if there are no more tasks
+ */
+lv_task_t * lv_task_get_next(lv_task_t * task)
+{
+    if(task == NULL)
+        return lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+    else
+        return lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task);
+}
+
+/**
+ * Give a name to a task to identify it in the statistics and the profiler.
+ * Does nothing if `LV_TASK_STATS` and `LV_USE_PROF` are 0.
+ * @param task pointer to a lv_task
+ * @param name the name (only the pointer is saved so it should be a string literal or a static string)
+ */
+void lv_task_set_name(lv_task_t * task, const char * name)
+{
+#if LV_TASK_STATS || LV_USE_PROF
+    task->name = name;
+#else
+    (void)task;
+    (void)name;
+#endif
+}
+
+#if LV_TASK_STATS
+/**
+ * Get the run statistics of a task
+ * @param task pointer to a lv_task
+ * @param stat pointer to a statistics variable, the result will be stored here
+ */
+void lv_task_get_stat(const lv_task_t * task, lv_task_stat_t * stat)
+{
+    *stat = task->stat;
+
+    if(stat->run_cnt) {
+        stat->time_avg   = (uint32_t)(stat->time_sum / stat->run_cnt);
+        stat->jitter_avg = (uint32_t)(stat->jitter_sum / stat->run_cnt);
+    } else {
+        stat->time_avg   = 0;
+        stat->jitter_avg = 0;
+    }
+}
+
+/**
+ * Clear the run statistics of a task
+ * @param task pointer to a lv_task or NULL to clear the statistics of all tasks
+ */
+void lv_task_stat_reset(lv_task_t * task)
+{
+    if(task) {
+        memset(&task->stat, 0, sizeof(lv_task_stat_t));
+        return;
+    }
+
+    LV_LL_READ(LV_GC_ROOT(_lv_task_ll), task)
+    {
+        memset(&task->stat, 0, sizeof(lv_task_stat_t));
+    }
+}
+
+/**
+ * Write the run statistics of all tasks into a text file
+ * @param path path of the file (it's overwritten)
+ * @return LV_RES_OK: written; LV_RES_INV: the file can't be opened
+ */
+lv_res_t lv_task_stat_dump(const char * path)
+{
+    FILE * f = fopen(path, "w");
+    if(f == NULL) {
+        LV_LOG_WARN("lv_task_stat_dump: can't open the file");
+        return LV_RES_INV;
+    }
+
+    fprintf(f, "Task statistics after %u s, idle %u %%\n\n", (unsigned)(lv_tick_get() / 1000), idle_last);
+    fprintf(f, "%-20s%6s%10s%10s%10s%12s%12s%12s%12s%12s\n", "task", "prio", "period", "runs", "missed", "total [ms]",
+            "avg [us]", "max [us]", "jit avg", "jit max");
+
+    lv_task_t * task;
+    LV_LL_READ(LV_GC_ROOT(_lv_task_ll), task)
+    {
+        lv_task_stat_t stat;
+        lv_task_get_stat(task, &stat);
+
+        char name[32];
+        if(task->name) snprintf(name, sizeof(name), "%s%s", task->name, task->paused ? " (p)" : "");
+        else snprintf(name, sizeof(name), "%p%s", (void *)task, task->paused ? " (p)" : "");
+
+        fprintf(f, "%-20s%6u%10u%10u%10u%12u%12u%12u%12u%12u\n", name, task->prio, (unsigned)task->period,
+                (unsigned)stat.run_cnt, (unsigned)stat.missed_cnt, (unsigned)(stat.time_sum / 1000),
+                (unsigned)stat.time_avg, (unsigned)stat.time_max, (unsigned)stat.jitter_avg,
+                (unsigned)stat.jitter_max);
+    }
+
+    fprintf(f, "\n(p): paused, jit: delay of the start from the scheduled time [us]\n");
+
+    fclose(f);
+    return LV_RES_OK;
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
 /**
- * Execute task if its the priority is appropriate
+ * Execute a task and delete it if it's a one shot task
+ * @param task pointer to lv_task
+ */
+static void lv_task_exec(lv_task_t * task)
+{
+    LV_GC_ROOT(_lv_task_act) = task;
+
+#if LV_TASK_STATS
+    uint64_t start_us = lv_tick_get_us();
+    stat_start(task, start_us);
+#endif
+
+    task->last_run = lv_tick_get();
+    task_deleted   = false;
+
+    LV_PROF_START(prof_start);
+#if LV_USE_PROF
+    const char * prof_name = task->name ? task->name : "task"; /*The task might be deleted in its callback*/
+#endif
+    if(task->task_cb) task->task_cb(task);
+    LV_PROF_STOP(prof_start, LV_PROF_CAT_TASK, prof_name);
+
+    /*Delete if it was a one shot lv_task*/
+    if(task_deleted == false) { /*The task might be deleted by itself as well*/
+#if LV_TASK_STATS
+        stat_end(task, start_us);
+#endif
+        if(task->once != 0) {
+            lv_task_del(task);
+        }
+    }
+}
+
+/**
+ * Add a task to the heap of its priority if it should run
+ * @param task pointer to lv_task
+ */
+static void task_sched(lv_task_t * task)
+{
+    if(task->heap_idx != HEAP_IDX_NONE) return; /*Already scheduled*/
+    if(task->ran) return;                        /*Scheduled at the end of `lv_task_handler`*/
+    if(task->prio == LV_TASK_PRIO_OFF || task->paused) return;
+
+    /* A task might be overdue for a long time (e.g. paused). Keep its deadline close to now
+     * to compare it correctly with the others.*/
+    uint32_t now = lv_tick_get();
+    if(task_time_till_deadline(task, now) < 0) {
+        task->last_run = now - LV_MATH_MIN(task->period, PERIOD_MAX);
+    }
+
+    heap_push(task->prio, task);
+}
+
+/**
+ * Remove a task from the heap of its priority.
+ * The tasks which ran in the current `lv_task_handler` call are not touched, `task_sched` checks them at the end.
+ * @param task pointer to lv_task
+ */
+static void task_unsched(lv_task_t * task)
+{
+    if(task->heap_idx == HEAP_IDX_NONE || task->ran) return;
+
+    heap_remove(task->prio, task->heap_idx);
+}
+
+/**
+ * Move a task to its new place in its heap after its deadline changed
+ * @param task pointer to lv_task
+ */
+static void task_resched(lv_task_t * task)
+{
+    task_unsched(task);
+    task_sched(task);
+}
+
+/**
+ * Get when a task should run
+ * @param task pointer to lv_task
+ * @return the tick of the next run
+ */
+static uint32_t task_get_deadline(const lv_task_t * task)
+{
+    return task->last_run + LV_MATH_MIN(task->period, PERIOD_MAX);
+}
+
+/**
+ * Get the time until a task should run
+ * @param task pointer to lv_task
+ * @param now the current tick
+ * @return the remaining time in milliseconds, <= 0 if the task is due
+ */
+static int32_t task_time_till_deadline(const lv_task_t * task, uint32_t now)
+{
+    return (int32_t)(task_get_deadline(task) - now);
+}
+
+/**
+ * Add a task to a heap
+ * @param slot the heap (a priority or `RAN_SLOT`)
  * @param task pointer to lv_task
- * @return true: execute, false: not executed
+ * @return true: added; false: out of memory
+ */
+static bool heap_push(lv_task_prio_t slot, lv_task_t * task)
+{
+    if(heap_cnt[slot] == heap_size[slot]) {
+        uint32_t new_size = heap_size[slot] ? heap_size[slot] * 2 : 8;
+        lv_task_t ** new_heap =
+            lv_mem_realloc(LV_GC_ROOT(_lv_task_heap)[slot], new_size * sizeof(lv_task_t *));
+        lv_mem_assert(new_heap);
+        if(new_heap == NULL) return false;
+
+        LV_GC_ROOT(_lv_task_heap)[slot] = new_heap;
+        heap_size[slot]                 = new_size;
+    }
+
+    uint32_t idx                         = heap_cnt[slot];
+    LV_GC_ROOT(_lv_task_heap)[slot][idx] = task;
+    task->heap_idx                       = idx;
+    heap_cnt[slot]++;
+
+    /*The ran tasks are not ordered*/
+    if(slot != RAN_SLOT) heap_sift_up(slot, idx);
+
+    return true;
+}
+
+/**
+ * Remove a task from a heap
+ * @param slot the heap (a priority or `RAN_SLOT`)
+ * @param idx index of the task in the heap
  */
-static bool lv_task_exec(lv_task_t * task)
+static void heap_remove(lv_task_prio_t slot, uint32_t idx)
 {
-    bool exec = false;
+    lv_task_t ** heap = LV_GC_ROOT(_lv_task_heap)[slot];
+
+    heap[idx]->heap_idx = HEAP_IDX_NONE;
+    heap_cnt[slot]--;
+
+    /*Fill the hole with the last task*/
+    if(idx == heap_cnt[slot]) return;
+    heap[idx]           = heap[heap_cnt[slot]];
+    heap[idx]->heap_idx = idx;
+
+    if(slot != RAN_SLOT) {
+        heap_sift_up(slot, idx);
+        heap_sift_down(slot, heap[idx]->heap_idx);
+    }
+}
+
+/**
+ * Move a task towards the root of its heap while it's earlier than its parent
+ * @param slot the heap
+ * @param idx index of the task in the heap
+ */
+static void heap_sift_up(lv_task_prio_t slot, uint32_t idx)
+{
+    lv_task_t ** heap = LV_GC_ROOT(_lv_task_heap)[slot];
+    lv_task_t * task  = heap[idx];
+    uint32_t deadline = task_get_deadline(task);
+
+    while(idx > 0) {
+        uint32_t parent = (idx - 1) / 2;
+        if((int32_t)(deadline - task_get_deadline(heap[parent])) >= 0) break;
 
-    /*Execute if at least 'period' time elapsed*/
-    uint32_t elp = lv_tick_elaps(task->last_run);
-    if(elp >= task->period) {
-        task->last_run = lv_tick_get();
-        task_deleted   = false;
-        task_created   = false;
-        if(task->task_cb) task->task_cb(task);
+        heap[idx]           = heap[parent];
+        heap[idx]->heap_idx = idx;
+        idx                 = parent;
+    }
+
+    heap[idx]      = task;
+    task->heap_idx = idx;
+}
 
-        /*Delete if it was a one shot lv_task*/
-        if(task_deleted == false) { /*The task might be deleted by itself as well*/
-            if(task->once != 0) {
-                lv_task_del(task);
-            }
+/**
+ * Move a task towards the leaves of its heap while it's later than its children
+ * @param slot the heap
+ * @param idx index of the task in the heap
+ */
+static void heap_sift_down(lv_task_prio_t slot, uint32_t idx)
+{
+    lv_task_t ** heap = LV_GC_ROOT(_lv_task_heap)[slot];
+    lv_task_t * task  = heap[idx];
+    uint32_t deadline = task_get_deadline(task);
+    uint32_t cnt      = heap_cnt[slot];
+
+    while(1) {
+        uint32_t child = idx * 2 + 1;
+        if(child >= cnt) break;
+
+        /*Choose the earlier child*/
+        if(child + 1 < cnt &&
+           (int32_t)(task_get_deadline(heap[child + 1]) - task_get_deadline(heap[child])) < 0) {
+            child++;
         }
-        exec = true;
+
+        if((int32_t)(task_get_deadline(heap[child]) - deadline) >= 0) break;
+
+        heap[idx]           = heap[child];
+        heap[idx]->heap_idx = idx;
+        idx                 = child;
     }
 
-    return exec;
+    heap[idx]      = task;
+    task->heap_idx = idx;
+}
+
+#if LV_TASK_STATS
+/**
+ * Count a run of a task and measure how late it started
+ * @param task pointer to lv_task which is starting (its `last_run` is not updated yet)
+ * @param start_us the start time from `lv_tick_get_us()`
+ */
+static void stat_start(lv_task_t * task, uint64_t start_us)
+{
+    /*`lv_tick_get()` is the millisecond part of `lv_tick_get_us()`*/
+    int32_t late = task_time_till_deadline(task, (uint32_t)(start_us / 1000));
+    late         = late < 0 ? -late : 0;
+
+    uint64_t jitter = (uint64_t)late * 1000 + start_us % 1000;
+
+    task->stat.run_cnt++;
+    task->stat.jitter_sum += jitter;
+    if(jitter > task->stat.jitter_max) task->stat.jitter_max = jitter > UINT32_MAX ? UINT32_MAX : (uint32_t)jitter;
+
+    /*The periods which elapsed while waiting were skipped*/
+    if(task->period != 0) task->stat.missed_cnt += (uint32_t)late / task->period;
+}
+
+/**
+ * Add the execution time of a task to its statistics
+ * @param task pointer to lv_task which ran (and wasn't deleted)
+ * @param start_us the start time from `lv_tick_get_us()`
+ */
+static void stat_end(lv_task_t * task, uint64_t start_us)
+{
+    uint64_t time     = lv_tick_elaps_us(start_us);
+    uint32_t time_u32 = time > UINT32_MAX ? UINT32_MAX : (uint32_t)time;
+
+    task->stat.time_sum += time_u32;
+    if(time_u32 > task->stat.time_max) task->stat.time_max = time_u32;
 }
+#endif
@@ -24,6 +24,7 @@ extern "C" {
 #include <stdbool.h>
 #include "lv_mem.h"
 #include "lv_ll.h"
+#include "lv_types.h"
 
 /*********************
  *      DEFINES
@@ -31,6 +32,9 @@ extern "C" {
 #ifndef LV_ATTRIBUTE_TASK_HANDLER
 #define LV_ATTRIBUTE_TASK_HANDLER
 #endif
+
+/*Returned by `lv_task_get_time_till_next` if no task will run*/
+#define LV_NO_TASK_READY 0xFFFFFFFF
 /**********************
  *      TYPEDEFS
  **********************/
@@ -56,6 +60,23 @@ enum {
 };
 typedef uint8_t lv_task_prio_t;
 
+#if LV_TASK_STATS
+/**
+ * Run statistics of a lv_task
+ */
+typedef struct
+{
+    uint32_t run_cnt;    /**< Number of runs */
+    uint32_t missed_cnt; /**< Number of periods which elapsed without a run because the task started late */
+    uint64_t time_sum;   /**< Execution time of all runs [us] */
+    uint32_t time_max;   /**< Longest execution time [us] */
+    uint32_t time_avg;   /**< Average execution time [us] (calculated by `lv_task_get_stat`) */
+    uint64_t jitter_sum; /**< Delay of all starts from the scheduled time [us] */
+    uint32_t jitter_max; /**< Longest delay of a start from the scheduled time [us] */
+    uint32_t jitter_avg; /**< Average delay of the starts [us] (calculated by `lv_task_get_stat`) */
+} lv_task_stat_t;
+#endif
+
 /**
  * Descriptor of a lv_task
  */
@@ -69,6 +90,17 @@ typedef struct _lv_task_t
 
     uint8_t prio : 3; /**< Task priority */
     uint8_t once : 1; /**< 1: one shot task */
+    uint8_t paused : 1; /**< 1: not executed until `lv_task_resume` */
+    uint8_t ran : 1; /**< 1: ran in the current `lv_task_handler` call (internal) */
+
+    uint32_t heap_idx; /**< Index in the heap of its priority (internal) */
+
+#if LV_TASK_STATS || LV_USE_PROF
+    const char * name; /**< Name in the statistics and the profiler (not copied) */
+#endif
+#if LV_TASK_STATS
+    lv_task_stat_t stat; /**< Run statistics */
+#endif
 } lv_task_t;
 
 /**********************
@@ -131,7 +163,7 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio);
 /**
  * Set new period for a lv_task
  * @param task pointer to a lv_task
- * @param period the new period
+ * @param period the new period (periods longer than `UINT32_MAX / 4` ms, about 12 days, are shortened to it)
  */
 void lv_task_set_period(lv_task_t * task, uint32_t period);
 
@@ -154,6 +186,18 @@ void lv_task_once(lv_task_t * task);
  */
 void lv_task_reset(lv_task_t * task);
 
+/**
+ * Pause a lv_task. It keeps its priority but it's not executed until `lv_task_resume`.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_pause(lv_task_t * task);
+
+/**
+ * Resume a paused lv_task. It runs when its period elapsed since it ran last time.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_resume(lv_task_t * task);
+
 /**
  * Enable or disable the whole  lv_task handling
  * @param en: true: lv_task handling is running, false: lv_task handling is suspended
@@ -166,6 +210,52 @@ void lv_task_enable(bool en);
  */
 uint8_t lv_task_get_idle(void);
 
+/**
+ * Get the time until a task should run. Animations and display refreshes are tasks too
+ * which are paused while there is nothing to do, so the caller can sleep until then
+ * (or until an input arrives) instead of calling `lv_task_handler` periodically.
+ * @return time until the next task in milliseconds (0: a task is ready)
+ *         or `LV_NO_TASK_READY` if no task will run
+ */
+uint32_t lv_task_get_time_till_next(void);
+
+/**
+ * Iterate through the tasks
+ * @param task NULL to get the first task else a pointer to the current task
+ * @return pointer to the next task or NULL if there are no more tasks
+ */
+lv_task_t * lv_task_get_next(lv_task_t * task);
+
+/**
+ * Give a name to a task to identify it in the statistics and the profiler.
+ * Does nothing if `LV_TASK_STATS` and `LV_USE_PROF` are 0.
+ * @param task pointer to a lv_task
+ * @param name the name (only the pointer is saved so it should be a string literal or a static string)
+ */
+void lv_task_set_name(lv_task_t * task, const char * name);
+
+#if LV_TASK_STATS
+/**
+ * Get the run statistics of a task
+ * @param task pointer to a lv_task
+ * @param stat pointer to a statistics variable, the result will be stored here
+ */
+void lv_task_get_stat(const lv_task_t * task, lv_task_stat_t * stat);
+
+/**
+ * Clear the run statistics of a task
+ * @param task pointer to a lv_task or NULL to clear the statistics of all tasks
+ */
+void lv_task_stat_reset(lv_task_t * task);
+
+/**
+ * Write the run statistics of all tasks into a text file
+ * @param path path of the file (it's overwritten)
+ * @return LV_RES_OK: written; LV_RES_INV: the file can't be opened
+ */
+lv_res_t lv_task_stat_dump(const char * path);
+#endif
+
 /**********************
  *      MACROS
  **********************/
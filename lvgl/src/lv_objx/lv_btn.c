@@ -75,6 +75,7 @@ lv_obj_t * lv_btn_create(lv_obj_t * par, const lv_obj_t * copy)
 
     lv_obj_t * new_btn;
 
+    lv_obj_reserve_ext_attr(sizeof(lv_btn_ext_t));
     new_btn = lv_cont_create(par, copy);
     lv_mem_assert(new_btn);
     if(new_btn == NULL) return NULL;
@@ -51,6 +51,7 @@ lv_obj_t * lv_canvas_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("canvas create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_canvas_ext_t));
     /*Create the ancestor of canvas*/
     lv_obj_t * new_canvas = lv_img_create(par, copy);
     lv_mem_assert(new_canvas);
@@ -555,7 +556,7 @@ void lv_canvas_draw_text(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord
     }
 
     lv_draw_label(&coords, &mask, style, LV_OPA_COVER, txt, flag, NULL, LV_LABEL_TEXT_SEL_OFF, LV_LABEL_TEXT_SEL_OFF,
-                  NULL);
+                  NULL, NULL);
 
     lv_refr_set_disp_refreshing(refr_ori);
 }
@@ -10,6 +10,7 @@
 #if LV_USE_CB != 0
 
 #include "../lv_core/lv_group.h"
+#include "../lv_core/lv_refr.h"
 #include "../lv_themes/lv_theme.h"
 
 /*********************
@@ -53,6 +54,7 @@ lv_obj_t * lv_cb_create(lv_obj_t * par, const lv_obj_t * copy)
 
     LV_LOG_TRACE("check box create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_cb_ext_t));
     /*Create the ancestor basic object*/
     lv_obj_t * new_cb = lv_btn_create(par, copy);
     lv_mem_assert(new_cb);
@@ -231,8 +233,13 @@ static bool lv_cb_design(lv_obj_t * cb, const lv_area_t * mask, lv_design_mode_t
         lv_cb_ext_t * cb_ext      = lv_obj_get_ext_attr(cb);
         lv_btn_ext_t * bullet_ext = lv_obj_get_ext_attr(cb_ext->bullet);
 
-        /*Be sure the state of the bullet is the same as the parent button*/
-        bullet_ext->state = cb_ext->bg_btn.state;
+        /*Be sure the state of the bullet is the same as the parent button.
+         * The signal function already follows the state so the refresh threads normally only read it*/
+        if(bullet_ext->state != cb_ext->bg_btn.state) {
+            lv_refr_design_lock();
+            bullet_ext->state = cb_ext->bg_btn.state;
+            lv_refr_design_unlock();
+        }
 
         result = ancestor_bg_design(cb, mask, mode);
 
@@ -270,14 +277,14 @@ static bool lv_bullet_design(lv_obj_t * bullet, const lv_area_t * mask, lv_desig
             if(lv_group_get_focused(g) == bg) {
                 lv_style_t * style_mod;
                 style_mod       = lv_group_mod_style(g, style_ori);
-                bullet->style_p = style_mod; /*Temporally change the style to the activated */
+                lv_obj_set_style_tmp(bullet, style_mod); /*Temporally change the style to the activated */
             }
         }
 #endif
         ancestor_bullet_design(bullet, mask, mode);
 
 #if LV_USE_GROUP
-        bullet->style_p = style_ori; /*Revert the style*/
+        lv_obj_set_style_tmp(bullet, NULL); /*Revert the style*/
 #endif
     } else if(mode == LV_DESIGN_DRAW_POST) {
         ancestor_bullet_design(bullet, mask, mode);
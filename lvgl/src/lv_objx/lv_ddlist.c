@@ -72,6 +72,7 @@ lv_obj_t * lv_ddlist_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("drop down list create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_ddlist_ext_t));
     /*Create the ancestor drop down list*/
     lv_obj_t * new_ddlist = lv_page_create(par, copy);
     lv_mem_assert(new_ddlist);
@@ -563,7 +564,7 @@ static bool lv_ddlist_design(lv_obj_t * ddlist, const lv_area_t * mask, lv_desig
                 new_style.text.opa   = sel_style->text.opa;
                 lv_txt_flag_t flag   = lv_ddlist_get_txt_flag(ddlist);
                 lv_draw_label(&ext->label->coords, &mask_sel, &new_style, opa_scale, lv_label_get_text(ext->label),
-                              flag, NULL, -1, -1, NULL);
+                              flag, NULL, -1, -1, NULL, NULL);
             }
         }
 
@@ -592,7 +593,7 @@ static bool lv_ddlist_design(lv_obj_t * ddlist, const lv_area_t * mask, lv_desig
                 area_ok = lv_area_intersect(&mask_arrow, mask, &area_arrow);
                 if(area_ok) {
                     lv_draw_label(&area_arrow, &mask_arrow, &new_style, opa_scale, LV_SYMBOL_DOWN, LV_TXT_FLAG_NONE,
-                                  NULL, -1, -1, NULL); /*Use a down arrow in ddlist, you can replace it with your
+                                  NULL, -1, -1, NULL, NULL); /*Use a down arrow in ddlist, you can replace it with your
                                                     custom symbol*/
                 }
             }
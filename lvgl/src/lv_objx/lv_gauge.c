@@ -10,6 +10,7 @@
 #if LV_USE_GAUGE != 0
 
 #include "../lv_draw/lv_draw.h"
+#include "../lv_core/lv_refr.h"
 #include "../lv_themes/lv_theme.h"
 #include "../lv_misc/lv_txt.h"
 #include "../lv_misc/lv_math.h"
@@ -63,6 +64,7 @@ lv_obj_t * lv_gauge_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("gauge create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_gauge_ext_t));
     /*Create the ancestor gauge*/
     lv_obj_t * new_gauge = lv_lmeter_create(par, copy);
     lv_mem_assert(new_gauge);
@@ -265,11 +267,7 @@ static bool lv_gauge_design(lv_obj_t * gauge, const lv_area_t * mask, lv_design_
     }
     /*Draw the object*/
     else if(mode == LV_DESIGN_DRAW_MAIN) {
-
-        /* Store the real pointer because of 'lv_group'
-         * If the object is in focus 'lv_obj_get_style()' will give a pointer to tmp style
-         * and to the real object style. It is important because of style change tricks below*/
-        const lv_style_t * style_ori_p = gauge->style_p;
+        lv_refr_design_lock(); /*Other refresh threads mustn't see the temporal line count*/
         const lv_style_t * style       = lv_obj_get_style(gauge);
         lv_gauge_ext_t * ext           = lv_obj_get_ext_attr(gauge);
 
@@ -285,14 +283,15 @@ static bool lv_gauge_design(lv_obj_t * gauge, const lv_area_t * mask, lv_design_
         ext->lmeter.line_cnt         = ext->label_count;                 /*Only to labels*/
         style_tmp.body.padding.left  = style_tmp.body.padding.left * 2;  /*Longer lines*/
         style_tmp.body.padding.right = style_tmp.body.padding.right * 2; /*Longer lines*/
-        gauge->style_p               = &style_tmp;
+        lv_obj_set_style_tmp(gauge, &style_tmp);
 
         ancestor_design(gauge, mask, mode); /*To draw lines*/
 
         ext->lmeter.line_cnt = line_cnt_tmp; /*Restore the parameters*/
-        gauge->style_p       = style_ori_p;  /*Restore the ORIGINAL style pointer*/
+        lv_obj_set_style_tmp(gauge, NULL);
 
         lv_gauge_draw_needle(gauge, mask);
+        lv_refr_design_unlock();
 
     }
     /*Post draw when the children are drawn*/
@@ -381,7 +380,7 @@ static void lv_gauge_draw_scale(lv_obj_t * gauge, const lv_area_t * mask)
         label_cord.x2 = label_cord.x1 + label_size.x;
         label_cord.y2 = label_cord.y1 + label_size.y;
 
-        lv_draw_label(&label_cord, mask, style, opa_scale, scale_txt, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+        lv_draw_label(&label_cord, mask, style, opa_scale, scale_txt, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL, NULL);
     }
 }
 /**
@@ -49,6 +49,7 @@ lv_obj_t * lv_imgbtn_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("image button create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_imgbtn_ext_t));
     /*Create the ancestor of image button*/
     lv_obj_t * new_imgbtn = lv_btn_create(par, copy);
     lv_mem_assert(new_imgbtn);
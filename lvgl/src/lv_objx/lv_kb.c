@@ -95,6 +95,7 @@ lv_obj_t * lv_kb_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("keyboard create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_kb_ext_t));
     /*Create the ancestor of keyboard*/
     lv_obj_t * new_kb = lv_btnm_create(par, copy);
     lv_mem_assert(new_kb);
@@ -11,6 +11,7 @@
 
 #include "../lv_core/lv_obj.h"
 #include "../lv_core/lv_group.h"
+#include "../lv_core/lv_refr.h"
 #include "../lv_misc/lv_color.h"
 #include "../lv_misc/lv_math.h"
 
@@ -103,6 +104,10 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->hint.y          = 0;
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_init(&ext->layout);
+#endif
+
 #if LV_LABEL_TEXT_SEL
     ext->txt_sel_start = LV_LABEL_TEXT_SEL_OFF;
     ext->txt_sel_end   = LV_LABEL_TEXT_SEL_OFF;
@@ -872,8 +877,21 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
         /*Just for compatibility*/
         lv_draw_label_hint_t * hint = NULL;
 #endif
+
+#if LV_LABEL_LAYOUT_CACHE
+        /*Measure the text only once and not in every refreshed area*/
+        lv_draw_label_layout_t * layout = &ext->layout;
+        lv_refr_design_lock(); /*Other refresh threads might draw the label too*/
+        if(lv_draw_label_layout_update(layout, ext->text, style->text.font, style->text.letter_space,
+                                       lv_area_get_width(&coords), flag) == false) {
+            layout = NULL;
+        }
+        lv_refr_design_unlock();
+#else
+        lv_draw_label_layout_t * layout = NULL;
+#endif
         lv_draw_label(&coords, mask, style, opa_scale, ext->text, flag, &ext->offset,
-                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), hint);
+                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), hint, layout);
 
 
         if(ext->long_mode == LV_LABEL_LONG_SROLL_CIRC) {
@@ -890,7 +908,7 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
                 ofs.y = ext->offset.y;
 
                 lv_draw_label(&coords, mask, style, opa_scale, ext->text, flag, &ofs,
-                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL);
+                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL, layout);
             }
 
             /*Draw the text again below the original to make an circular effect */
@@ -898,7 +916,7 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
                 ofs.x = ext->offset.x;
                 ofs.y = ext->offset.y + size.y + lv_font_get_line_height(style->text.font);
                 lv_draw_label(&coords, mask, style, opa_scale, ext->text, flag, &ofs,
-                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL);
+                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL, layout);
             }
         }
     }
@@ -927,6 +945,9 @@ static lv_res_t lv_label_signal(lv_obj_t * label, lv_signal_t sign, void * param
             ext->text = NULL;
         }
         lv_label_dot_tmp_free(label);
+#if LV_LABEL_LAYOUT_CACHE
+        lv_draw_label_layout_free(&ext->layout);
+#endif
     } else if(sign == LV_SIGNAL_STYLE_CHG) {
         /*Revert dots for proper refresh*/
         lv_label_revert_dots(label);
@@ -967,6 +988,10 @@ static void lv_label_refr_text(lv_obj_t * label)
 {
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_invalidate(&ext->layout); /*The text, the font or the width has changed*/
+#endif
+
     if(ext->text == NULL) return;
 #if LV_LABEL_LONG_TXT_HINT
     ext->hint.line_start = -1; /*The hint is invalid if the text changes*/
@@ -986,7 +1011,17 @@ static void lv_label_refr_text(lv_obj_t * label)
     lv_txt_flag_t flag = LV_TXT_FLAG_NONE;
     if(ext->recolor != 0) flag |= LV_TXT_FLAG_RECOLOR;
     if(ext->expand != 0) flag |= LV_TXT_FLAG_EXPAND;
+#if LV_LABEL_LAYOUT_CACHE
+    /*Measure the text for drawing too if the width is kept*/
+    if(ext->long_mode != LV_LABEL_LONG_EXPAND &&
+       lv_draw_label_layout_update(&ext->layout, ext->text, font, style->text.letter_space, max_w, flag)) {
+        lv_draw_label_layout_get_size(&ext->layout, &size, style->text.line_space);
+    } else {
+        lv_txt_get_size(&size, ext->text, font, style->text.letter_space, style->text.line_space, max_w, flag);
+    }
+#else
     lv_txt_get_size(&size, ext->text, font, style->text.letter_space, style->text.line_space, max_w, flag);
+#endif
 
     /*Set the full size in expand mode*/
     if(ext->long_mode == LV_LABEL_LONG_EXPAND) {
@@ -1107,6 +1142,9 @@ static void lv_label_refr_text(lv_obj_t * label)
                 }
                 ext->text[byte_id_ori + LV_LABEL_DOT_NUM] = '\0';
                 ext->dot_end                              = letter_id + LV_LABEL_DOT_NUM;
+#if LV_LABEL_LAYOUT_CACHE
+                lv_draw_label_layout_invalidate(&ext->layout); /*The text has changed*/
+#endif
             }
         }
     }
@@ -76,6 +76,10 @@ typedef struct
     lv_draw_label_hint_t hint; /*Used to buffer info about large text*/
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_draw_label_layout_t layout; /*Line breaks and letter widths of the text*/
+#endif
+
 #if LV_USE_ANIMATION
     uint16_t anim_speed; /*Speed of scroll and roll animation in px/sec unit*/
 #endif
@@ -67,6 +67,7 @@ lv_obj_t * lv_list_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("list create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_list_ext_t));
     /*Create the ancestor basic object*/
     lv_obj_t * new_list = lv_page_create(par, copy);
     lv_mem_assert(new_list);
@@ -66,6 +66,7 @@ lv_obj_t * lv_mbox_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("mesasge box create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_mbox_ext_t));
     /*Create the ancestor message box*/
     lv_obj_t * new_mbox = lv_cont_create(par, copy);
     lv_mem_assert(new_mbox);
@@ -75,6 +75,7 @@ lv_obj_t * lv_page_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("page create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_page_ext_t));
     /*Create the ancestor object*/
     lv_obj_t * new_page = lv_cont_create(par, copy);
     lv_mem_assert(new_page);
@@ -762,14 +763,14 @@ static bool lv_scrl_design(lv_obj_t * scrl, const lv_area_t * mask, lv_design_mo
                     style_mod                    = lv_group_mod_style(g, style_mod);
                 }
 
-                scrl->style_p = style_mod; /*Temporally change the style to the activated */
+                lv_obj_set_style_tmp(scrl, style_mod); /*Temporally change the style to the activated */
             }
         }
 #endif
         ancestor_design(scrl, mask, mode);
 
 #if LV_USE_GROUP
-        scrl->style_p = style_scrl_ori; /*Revert the style*/
+        lv_obj_set_style_tmp(scrl, NULL); /*Revert the style*/
 #endif
     } else if(mode == LV_DESIGN_DRAW_POST) {
         ancestor_design(scrl, mask, mode);
@@ -64,6 +64,7 @@ lv_obj_t * lv_preload_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("preload create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_preload_ext_t));
     /*Create the ancestor of pre loader*/
     lv_obj_t * new_preload = lv_arc_create(par, copy);
     lv_mem_assert(new_preload);
@@ -63,6 +63,7 @@ lv_obj_t * lv_roller_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("roller create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_roller_ext_t));
     /*Create the ancestor of roller*/
     lv_obj_t * new_roller = lv_ddlist_create(par, copy);
     lv_mem_assert(new_roller);
@@ -375,7 +376,7 @@ static bool lv_roller_design(lv_obj_t * roller, const lv_area_t * mask, lv_desig
             new_style.text.color = sel_style->text.color;
             new_style.text.opa   = sel_style->text.opa;
             lv_draw_label(&ext->ddlist.label->coords, &mask_sel, &new_style, opa_scale,
-                          lv_label_get_text(ext->ddlist.label), txt_align, NULL, -1, -1, NULL);
+                          lv_label_get_text(ext->ddlist.label), txt_align, NULL, -1, -1, NULL, NULL);
         }
     }
 
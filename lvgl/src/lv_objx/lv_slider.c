@@ -56,6 +56,7 @@ lv_obj_t * lv_slider_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("slider create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_slider_ext_t));
     /*Create the ancestor slider*/
     lv_obj_t * new_slider = lv_bar_create(par, copy);
     lv_mem_assert(new_slider);
@@ -51,6 +51,7 @@ lv_obj_t * lv_spinbox_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("spinbox create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_spinbox_ext_t));
     /*Create the ancestor of spinbox*/
     lv_obj_t * new_spinbox = lv_ta_create(par, copy);
     lv_mem_assert(new_spinbox);
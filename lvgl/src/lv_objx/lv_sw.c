@@ -55,6 +55,7 @@ lv_obj_t * lv_sw_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("switch create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_sw_ext_t));
     /*Create the ancestor of switch*/
     lv_obj_t * new_sw = lv_slider_create(par, copy);
     lv_mem_assert(new_sw);
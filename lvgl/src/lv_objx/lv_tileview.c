@@ -63,6 +63,7 @@ lv_obj_t * lv_tileview_create(lv_obj_t * par, const lv_obj_t * copy)
 {
     LV_LOG_TRACE("tileview create started");
 
+    lv_obj_reserve_ext_attr(sizeof(lv_tileview_ext_t));
     /*Create the ancestor of tileview*/
     lv_obj_t * new_tileview = lv_page_create(par, copy);
     lv_mem_assert(new_tileview);
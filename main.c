@@ -3,42 +3,79 @@
 #include "lv_drivers/indev/touch.h"
 #include "lv_examples/lv_apps/demo/demo.h"
 #include <unistd.h>
-#include <pthread.h>
 #include <time.h>
-#include <sys/time.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include <stdbool.h>
 #include <lv_application/lv_application.h>
 #include "lv_examples/lv_apps/tpcal/tpcal.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <signal.h>
 #include "buzzer.h"
+#if LV_USE_TESTS
+#include "lv_application/test/serial_test.h"
+#endif
 
 #define DISP_BUF_SIZE (80*LV_HOR_RES_MAX)
 
-void lv_ticker(void);
-void feedback_cb(struct _lv_indev_drv_t *, uint8_t);
+/* `kill -USR1 <pid>` writes the memory trace, the task statistics and the profiler's trace here */
+#define MEM_TRACE_DUMP_PATH "/tmp/lv_mem_trace.txt"
+#define TASK_STATS_DUMP_PATH "/tmp/lv_task_stats.txt"
+#define PROF_DUMP_PATH "/tmp/lv_prof.json"
 
-extern void app_tick(void);
+/* What woke up the main loop (stored in the epoll event data) */
+enum {LOOP_EV_TIMER, LOOP_EV_TOUCH, LOOP_EV_SERIAL};
+#define LOOP_MAX_EVENTS 4
+
+void feedback_cb(struct _lv_indev_drv_t *, uint8_t);
+static bool loop_add_fd(int epoll_fd, int fd, uint32_t ev);
+static void loop_set_timer(int timer_fd, uint32_t ms);
 
 
 static enum {APP_DEMO, APP_TP_CAL} eAppState;
 lv_indev_drv_t  indev_drv;              // input device driver
 lv_indev_t *  indev;
-pthread_t lv_tick_thread;
 
-volatile bool bTick = false;
+#if LV_MEM_TRACE || LV_TASK_STATS || LV_USE_PROF
+static volatile sig_atomic_t bStatsDump = 0;
+
+static void stats_dump_signal(int sig)
+{
+   (void)sig;
+   bStatsDump = 1;
+}
+#endif
 
 
 int main(void)
 {
-   int tick_count = 0;
-   int seconds = 0;
+#if LV_USE_TESTS
+   /* `LV_SERIAL_TEST=1` only tests the serial link through a pty and exits */
+   if(getenv("LV_SERIAL_TEST") != NULL)
+      return serial_test_pty() == 0 ? 0 : 1;
+#endif
+
    printf("LVGL demo\r\n");
     /*LittlevGL init*/
     lv_init();
 
-    /*Linux frame buffer device init*/
+#if LV_MEM_TRACE || LV_TASK_STATS || LV_USE_PROF
+    signal(SIGUSR1, stats_dump_signal);
+#endif
+
+    /*Linux frame buffer device init.
+     *`LV_FBDEV_STUB=1` runs on a frame buffer in memory instead, e.g. to test page flipping without a panel*/
+    bool fb_stub = false;
+#if FBDEV_PAGE_FLIP && USE_BSD_FBDEV == 0
+    fb_stub = getenv("LV_FBDEV_STUB") != NULL;
+    if(fb_stub) fbdev_init_stub(LV_HOR_RES_MAX, LV_VER_RES_MAX);
+    else fbdev_init();
+#else
     fbdev_init();
+#endif
 
 //    buzzerInit();
 
@@ -46,47 +83,60 @@ int main(void)
 
     /* Touchscreen driver device init */
     int32_t drvStatus = touchInit();
-    if(drvStatus == TOUCH_DRV_FAIL)
+    if(drvStatus == TOUCH_DRV_FAIL && !fb_stub)
     {
        perror("Cannot initialise touch screen driver\r\n");
        exit(1);
     }
 #endif
 
-    /*A small buffer for LittlevGL to draw the screen's content*/
-    static lv_color_t buf[DISP_BUF_SIZE];
-
     /*Initialize a descriptor for the buffer*/
     static lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, buf, NULL, DISP_BUF_SIZE);
 
     /*Initialize and register a display driver*/
     lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
     disp_drv.buffer = &disp_buf;
     disp_drv.flush_cb = fbdev_flush;
-    lv_disp_drv_register(&disp_drv);
+    disp_drv.wait_cb = fbdev_wait;
 
-#if 1
-    lv_indev_drv_init(&indev_drv);
-    indev_drv.type = LV_INDEV_TYPE_POINTER;
-    indev_drv.read_cb = touchRead;
-//    indev_drv.feedback_cb = feedback_cb;
-    //indev_drv.user_data = (void*)&touchCalFunc;
-    indev = lv_indev_drv_register(&indev_drv);
+    bool page_flip = false;
+#if FBDEV_PAGE_FLIP
+    /*Render directly into the frame buffer if it can hold two screens*/
+    uint32_t fb_w, fb_h;
+    fbdev_get_sizes(&fb_w, &fb_h);
+    if(fb_w == LV_HOR_RES_MAX && fb_h == LV_VER_RES_MAX && fbdev_page_flip_init(&disp_buf)) {
+        disp_drv.flush_cb = fbdev_flip;
+        page_flip = true;
+    }
 #endif
-    int s;
-
-    // Start up thread for lv tick
-    if((s = pthread_create(&lv_tick_thread, NULL, (void*)&lv_ticker, NULL)) != 0)
-    {
-       printf("Cannot create tick thread:%d\r\n", s);
+    if(page_flip == false) {
+        /*Two small buffers for LittlevGL to draw the screen's content.
+         *One is rendered while the other is copied to the frame buffer by the flush thread*/
+        lv_color_t * buf1 = malloc(DISP_BUF_SIZE * sizeof(lv_color_t));
+        lv_color_t * buf2 = malloc(DISP_BUF_SIZE * sizeof(lv_color_t));
+        if(buf1 == NULL || buf2 == NULL)
+        {
+           perror("Cannot allocate the draw buffers\r\n");
+           exit(1);
+        }
+        lv_disp_buf_init(&disp_buf, buf1, buf2, DISP_BUF_SIZE);
     }
-    else
+    lv_disp_drv_register(&disp_drv);
+
+#if 1
+    /* Without a touch screen (stub frame buffer only) there is no pointer */
+    if(drvStatus != TOUCH_DRV_FAIL)
     {
-       printf("tick thread created\r\n");
+       lv_indev_drv_init(&indev_drv);
+       indev_drv.type = LV_INDEV_TYPE_POINTER;
+       indev_drv.read_cb = touchRead;
+       indev_drv.read_on_event = 1;   /* read when the evdev file is readable, see the main loop */
+//       indev_drv.feedback_cb = feedback_cb;
+       //indev_drv.user_data = (void*)&touchCalFunc;
+       indev = lv_indev_drv_register(&indev_drv);
     }
-
+#endif
 
     lv_application();
 
@@ -97,37 +147,104 @@ int main(void)
 #endif
 
 
-    /*Handle LitlevGL tasks (tickless mode)*/
+    /* Sleep in epoll until a task is due (timerfd), the touch screen has events or the
+     * serial port can be read or written. The tick is read from the monotonic clock (LV_TICK_MONOTONIC). */
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(epoll_fd < 0 || timer_fd < 0 || !loop_add_fd(epoll_fd, timer_fd, LOOP_EV_TIMER))
+    {
+       perror("Cannot create the main loop\r\n");
+       exit(1);
+    }
+    loop_add_fd(epoll_fd, evdev_get_fd(), LOOP_EV_TOUCH);
+#if LV_USE_APPLICATION
+    loop_add_fd(epoll_fd, app_get_serial_fd(), LOOP_EV_SERIAL);
+#endif
+
     while(1) {
         lv_task_handler();
-        if(bTick)
+#if LV_MEM_TRACE || LV_TASK_STATS || LV_USE_PROF
+        /* Not in the signal handler: the trace can't be read while it's being written */
+        if(bStatsDump)
+        {
+           bStatsDump = 0;
+#if LV_MEM_TRACE
+           if(lv_mem_trace_dump(MEM_TRACE_DUMP_PATH) == LV_RES_OK)
+              printf("memory trace written to %s\r\n", MEM_TRACE_DUMP_PATH);
+#endif
+#if LV_TASK_STATS
+           if(lv_task_stat_dump(TASK_STATS_DUMP_PATH) == LV_RES_OK)
+              printf("task statistics written to %s\r\n", TASK_STATS_DUMP_PATH);
+#endif
+#if LV_USE_PROF
+           if(lv_prof_dump(PROF_DUMP_PATH) == LV_RES_OK)
+              printf("profiler trace written to %s\r\n", PROF_DUMP_PATH);
+#endif
+        }
+#endif
+        uint32_t time_till_next = lv_task_get_time_till_next();
+        if(time_till_next == 0) continue;
+        loop_set_timer(timer_fd, time_till_next);
+
+        struct epoll_event events[LOOP_MAX_EVENTS];
+        int n = epoll_wait(epoll_fd, events, LOOP_MAX_EVENTS, -1);
+        if(n < 0)
+        {
+           if(errno == EINTR) continue;    /* e.g. SIGUSR1 */
+           perror("epoll_wait");
+           exit(1);
+        }
+
+        int i;
+        for(i = 0; i < n; i++)
         {
-           tick_count += 5;
-           if(tick_count >= 1000)
+           switch(events[i].data.u32)
            {
-              tick_count = 0;
-//              printf("%d, lv_tick:%d\r\n", ++seconds, lv_tick_get());
+           case LOOP_EV_TIMER:
+           {
+              uint64_t expirations;
+              read(timer_fd, &expirations, sizeof(expirations));
+              break;
            }
-           bTick = false;
-        }
+           case LOOP_EV_TOUCH:
+              lv_indev_trig_read(indev);
+              break;
 #if LV_USE_APPLICATION
-        app_tick();
+           case LOOP_EV_SERIAL:
+              app_serial_event();
+              break;
 #endif
-        usleep(2000);
+           }
+        }
     }
 
     return 0;
 }
 
-/* measurents have shown that usleep(5000) actually delays for more like 10000 */
-void lv_ticker(void)
+/* Wait for `ev` on `fd` in the main loop */
+static bool loop_add_fd(int epoll_fd, int fd, uint32_t ev)
+{
+   if(fd < 0)
+      return false;
+
+   struct epoll_event event;
+   event.events = EPOLLIN;
+   event.data.u64 = 0;
+   event.data.u32 = ev;
+   return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+/* Wake up the main loop after `ms` milliseconds, or never if it's LV_NO_TASK_READY */
+static void loop_set_timer(int timer_fd, uint32_t ms)
 {
-   while(1)
+   struct itimerspec its;
+   memset(&its, 0, sizeof(its));   /* it_value 0 disarms the timer */
+   if(ms != LV_NO_TASK_READY)
    {
-      lv_tick_inc(5);
-      bTick = true;
-      usleep(5000);
+      its.it_value.tv_sec = ms / 1000;
+      its.it_value.tv_nsec = (long)(ms % 1000) * 1000000;
    }
+   timerfd_settime(timer_fd, 0, &its, NULL);
 }
 
 void feedback_cb(struct _lv_indev_drv_t * p_drv, uint8_t event)
@@ -137,22 +254,3 @@ void feedback_cb(struct _lv_indev_drv_t * p_drv, uint8_t event)
       doBuzz(1000);
    }
 }
-
-/*Set in lv_conf.h as `LV_TICK_CUSTOM_SYS_TIME_EXPR`*/
-uint32_t custom_tick_get(void)
-{
-    static uint64_t start_ms = 0;
-    if(start_ms == 0) {
-        struct timeval tv_start;
-        gettimeofday(&tv_start, NULL);
-        start_ms = (tv_start.tv_sec * 1000000 + tv_start.tv_usec) / 1000;
-    }
-
-    struct timeval tv_now;
-    gettimeofday(&tv_now, NULL);
-    uint64_t now_ms;
-    now_ms = (tv_now.tv_sec * 1000000 + tv_now.tv_usec) / 1000;
-
-    uint32_t time_ms = now_ms - start_ms;
-    return time_ms;
-}